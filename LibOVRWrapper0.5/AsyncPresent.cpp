@@ -0,0 +1,385 @@
+#include "stdafx.h"
+
+#include "AsyncPresent.h"
+#include "shimhelper.h"
+
+#include <atomic>
+
+#define asyncPresentSlotMask 3
+#define asyncPresentFresh 4 // set in the mailbox while it holds a frame the submit thread has not taken
+#define asyncPresentWaitMs 100 // waits wake up this often to notice a stopped thread
+
+bool globalAsyncPresentEnabled = false;
+AsyncPresentPolicy globalAsyncPresentPolicy = asyncPresentPolicy_Block;
+
+typedef struct AsyncPresentSlot_
+{
+	AsyncPresentFrame frame;
+
+	// the eyes staged for the frame, created on the app's device and opened on the submit thread's device
+	ID3D11Device* appDevice; // only compared, to notice a new device
+	ID3D11Texture2D* appTexture[2];
+	IDXGIKeyedMutex* appMutex[2];
+	ID3D11Texture2D* submitTexture[2];
+	IDXGIKeyedMutex* submitMutex[2];
+	int width[2];
+	int height[2];
+	DXGI_FORMAT format[2];
+	bool staged[2]; // for the frame in the slot
+} AsyncPresentSlot;
+
+struct AsyncPresent_
+{
+	// Triple buffered mailbox: the app fills its write slot and swaps it with the mailbox,
+	// the submit thread swaps its read slot with the mailbox when it is fresh.
+	// Nothing is ever queued behind the mailbox, so at most one frame waits for submission.
+	AsyncPresentSlot slots[3];
+	std::atomic<uint32_t> mailbox;
+	uint32_t writeSlot; // owned by the app's thread
+	uint32_t readSlot; // owned by the submit thread
+	std::atomic<bool> submitting;
+
+	AsyncPresentPolicy policy;
+	HANDLE thread;
+	HANDLE frameEvent; // a frame was published
+	HANDLE takenEvent; // the submit thread took a frame or finished submitting one
+	volatile bool stopping;
+
+	// Only the submit thread uses the context, the device is free threaded
+	ID3D11Device* submitDevice;
+	ID3D11DeviceContext* submitContext;
+
+	std::atomic<uint32_t> submitted;
+	std::atomic<uint32_t> dropped;
+	std::atomic<int64_t> submitMicros;
+	std::atomic<int64_t> blockedMicros;
+};
+
+DWORD WINAPI asyncPresentMain(LPVOID param) {
+	AsyncPresent* present = (AsyncPresent*)param;
+
+	while (!present->stopping) {
+		if ((present->mailbox.load(std::memory_order_acquire) & asyncPresentFresh) == 0) {
+			WaitForSingleObject(present->frameEvent, asyncPresentWaitMs);
+			continue;
+		}
+
+		//marked busy before the mailbox is emptied so a drain never sees neither
+		present->submitting.store(true);
+		uint32_t taken = present->mailbox.exchange(present->readSlot, std::memory_order_acq_rel);
+		present->readSlot = taken & asyncPresentSlotMask;
+		SetEvent(present->takenEvent);
+
+		AsyncPresentSlot* slot = &present->slots[present->readSlot];
+		AsyncPresentFrame* frame = &slot->frame;
+
+		TRACE_EVENT1(AsyncPresentSubmit, frame->frameIndex);
+
+		double start = rev_GetTimeInSeconds();
+
+		if (frame->hasLayer) {
+			for (int eye = 0;eye < 2;eye++) {
+				if (!slot->staged[eye]) {
+					continue;
+				}
+
+				slot->submitMutex[eye]->AcquireSync(0, INFINITE);
+				CopyEyeRenderTexture(frame->eyeChain[eye], present->submitContext, slot->submitTexture[eye], slot->width[eye], slot->height[eye]);
+				slot->submitMutex[eye]->ReleaseSync(0);
+			}
+		}
+
+		revLayerHeader* layers[1] = { frame->hasLayer ? &frame->layer.Header : NULL };
+		rev_SubmitFrame(frame->session, frame->frameIndex, NULL, layers, 1);
+		present->submitMicros.fetch_add((int64_t)((rev_GetTimeInSeconds() - start) * 1000000.0));
+		present->submitted.fetch_add(1);
+
+		present->submitting.store(false);
+		SetEvent(present->takenEvent);
+	}
+
+	return 0;
+}
+
+// The submit thread's device sits on the application's adapter, so textures can be shared between them
+bool createSubmitDevice(AsyncPresent* present, ID3D11Device* appDevice) {
+	IDXGIDevice* dxgiDevice = NULL;
+	IDXGIAdapter* adapter = NULL;
+
+	if (FAILED(appDevice->QueryInterface(__uuidof(IDXGIDevice), (void**)&dxgiDevice))) {
+		return false;
+	}
+
+	HRESULT hr = dxgiDevice->GetAdapter(&adapter);
+	dxgiDevice->Release();
+
+	if (FAILED(hr)) {
+		return false;
+	}
+
+	D3D_FEATURE_LEVEL level = appDevice->GetFeatureLevel();
+	hr = D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, NULL, 0, &level, 1, D3D11_SDK_VERSION,
+		&present->submitDevice, NULL, &present->submitContext);
+	adapter->Release();
+
+	return SUCCEEDED(hr);
+}
+
+template<class T> void releaseAndClear(T** p) {
+	if (*p != NULL) {
+		(*p)->Release();
+		*p = NULL;
+	}
+}
+
+void releaseStagedEye(AsyncPresentSlot* slot, int eye) {
+	releaseAndClear(&slot->appMutex[eye]);
+	releaseAndClear(&slot->appTexture[eye]);
+	releaseAndClear(&slot->submitMutex[eye]);
+	releaseAndClear(&slot->submitTexture[eye]);
+}
+
+void destroyAsyncPresent(AsyncPresent* present) {
+	for (int i = 0;i < 3;i++) {
+		for (int eye = 0;eye < 2;eye++) {
+			releaseStagedEye(&present->slots[i], eye);
+		}
+	}
+
+	releaseAndClear(&present->submitContext);
+	releaseAndClear(&present->submitDevice);
+
+	delete present;
+}
+
+// (Re)creates the slot's shared texture for the eye when the application's texture changed
+bool prepareStagedEye(AsyncPresent* present, AsyncPresentSlot* slot, ID3D11Device* appDevice, int eye, DXGI_FORMAT format, int width, int height) {
+	if (slot->appTexture[eye] != NULL && slot->appDevice == appDevice &&
+		slot->format[eye] == format && slot->width[eye] == width && slot->height[eye] == height) {
+		return true;
+	}
+
+	releaseStagedEye(slot, eye);
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = format;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+	IDXGIResource* resource = NULL;
+	HANDLE handle = NULL;
+
+	HRESULT hr = appDevice->CreateTexture2D(&desc, NULL, &slot->appTexture[eye]);
+	if (SUCCEEDED(hr)) {
+		hr = slot->appTexture[eye]->QueryInterface(__uuidof(IDXGIResource), (void**)&resource);
+	}
+	if (SUCCEEDED(hr)) {
+		hr = resource->GetSharedHandle(&handle);
+		resource->Release();
+	}
+	if (SUCCEEDED(hr)) {
+		hr = slot->appTexture[eye]->QueryInterface(__uuidof(IDXGIKeyedMutex), (void**)&slot->appMutex[eye]);
+	}
+	if (SUCCEEDED(hr)) {
+		hr = present->submitDevice->OpenSharedResource(handle, __uuidof(ID3D11Texture2D), (void**)&slot->submitTexture[eye]);
+	}
+	if (SUCCEEDED(hr)) {
+		hr = slot->submitTexture[eye]->QueryInterface(__uuidof(IDXGIKeyedMutex), (void**)&slot->submitMutex[eye]);
+	}
+
+	if (FAILED(hr)) {
+		BOOST_LOG_TRIVIAL(error) << "asyncPresentStageEye could not share an eye texture with the submit thread " << hr;
+		releaseStagedEye(slot, eye);
+		return false;
+	}
+
+	slot->appDevice = appDevice;
+	slot->format[eye] = format;
+	slot->width[eye] = width;
+	slot->height[eye] = height;
+
+	return true;
+}
+
+AsyncPresent* asyncPresentStart(AsyncPresentPolicy policy, ID3D11Device* appDevice) {
+	AsyncPresent* present = new AsyncPresent();
+
+	if (!createSubmitDevice(present, appDevice)) {
+		BOOST_LOG_TRIVIAL(error) << "asyncPresentStart could not create the submit thread's device, presenting synchronously";
+		destroyAsyncPresent(present);
+		return NULL;
+	}
+
+	present->policy = policy;
+	present->mailbox.store(0);
+	present->writeSlot = 1;
+	present->readSlot = 2;
+	present->submitting.store(false);
+	present->stopping = false;
+
+	present->frameEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	present->takenEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	present->thread = CreateThread(NULL, 0, asyncPresentMain, present, 0, NULL);
+
+	if (present->thread == NULL) {
+		BOOST_LOG_TRIVIAL(error) << "asyncPresentStart could not create the submit thread, presenting synchronously";
+		CloseHandle(present->frameEvent);
+		CloseHandle(present->takenEvent);
+		destroyAsyncPresent(present);
+		return NULL;
+	}
+
+	return present;
+}
+
+ID3D11Device* asyncPresentDevice(AsyncPresent* present) {
+	return present->submitDevice;
+}
+
+AsyncPresentFrame* asyncPresentBeginFrame(AsyncPresent* present) {
+	if (present->policy == asyncPresentPolicy_Block &&
+		(present->mailbox.load(std::memory_order_acquire) & asyncPresentFresh) != 0) {
+		double start = rev_GetTimeInSeconds();
+
+		while ((present->mailbox.load(std::memory_order_acquire) & asyncPresentFresh) != 0) {
+			WaitForSingleObject(present->takenEvent, asyncPresentWaitMs);
+		}
+
+		present->blockedMicros.fetch_add((int64_t)((rev_GetTimeInSeconds() - start) * 1000000.0));
+	}
+
+	AsyncPresentSlot* slot = &present->slots[present->writeSlot];
+	slot->staged[0] = slot->staged[1] = false;
+
+	return &slot->frame;
+}
+
+// Copies the top left width x height of the application's eye texture into the write slot
+bool asyncPresentStageEye(AsyncPresent* present, ID3D11DeviceContext* context, int eye, ID3D11Texture2D* source, int width, int height) {
+	AsyncPresentSlot* slot = &present->slots[present->writeSlot];
+
+	D3D11_TEXTURE2D_DESC desc;
+	source->GetDesc(&desc);
+
+	ID3D11Device* appDevice = NULL;
+	context->GetDevice(&appDevice);
+	bool prepared = prepareStagedEye(present, slot, appDevice, eye, desc.Format, width, height);
+	appDevice->Release();
+
+	if (!prepared) {
+		return false;
+	}
+
+	D3D11_BOX box = { 0, 0, 0, (UINT)width, (UINT)height, 1 };
+
+	slot->appMutex[eye]->AcquireSync(0, INFINITE);
+	context->CopySubresourceRegion(slot->appTexture[eye], 0, 0, 0, 0, source, 0, &box);
+	slot->appMutex[eye]->ReleaseSync(0);
+
+	slot->staged[eye] = true;
+
+	return true;
+}
+
+void asyncPresentQueue(AsyncPresent* present) {
+	uint32_t previous = present->mailbox.exchange(present->writeSlot | asyncPresentFresh, std::memory_order_acq_rel);
+	present->writeSlot = previous & asyncPresentSlotMask;
+
+	//the replaced frame was staged but never reaches the runtime
+	if (previous & asyncPresentFresh) {
+		present->dropped.fetch_add(1);
+		TRACE_EVENT1(AsyncPresentDropped, present->slots[present->writeSlot].frame.frameIndex);
+	}
+
+	SetEvent(present->frameEvent);
+}
+
+// Waits until every queued frame is submitted, before the chains they reference are destroyed
+void asyncPresentDrain(AsyncPresent* present) {
+	if (present == NULL) {
+		return;
+	}
+
+	double start = rev_GetTimeInSeconds();
+
+	while ((present->mailbox.load(std::memory_order_acquire) & asyncPresentFresh) != 0 || present->submitting.load()) {
+		WaitForSingleObject(present->takenEvent, asyncPresentWaitMs);
+	}
+
+	present->blockedMicros.fetch_add((int64_t)((rev_GetTimeInSeconds() - start) * 1000000.0));
+}
+
+void asyncPresentStop(AsyncPresent* present) {
+	if (present == NULL) {
+		return;
+	}
+
+	asyncPresentDrain(present);
+
+	present->stopping = true;
+	SetEvent(present->frameEvent);
+	WaitForSingleObject(present->thread, INFINITE);
+
+	CloseHandle(present->thread);
+	CloseHandle(present->frameEvent);
+	CloseHandle(present->takenEvent);
+
+	destroyAsyncPresent(present);
+}
+
+// Without a submit thread every counter is 0
+void asyncPresentGetStats(AsyncPresent* present, AsyncPresentStats* stats) {
+	if (present == NULL) {
+		memset(stats, 0, sizeof(AsyncPresentStats));
+		return;
+	}
+
+	stats->framesSubmitted = present->submitted.load();
+	stats->framesDropped = present->dropped.load();
+	stats->submitSeconds = present->submitMicros.load() / 1000000.0;
+	stats->blockedSeconds = present->blockedMicros.load() / 1000000.0;
+}
+
+bool getAsyncPresentInt(AsyncPresent* present, const char* propertyName, int* value) {
+	AsyncPresentStats stats;
+	asyncPresentGetStats(present, &stats);
+
+	if (strcmp(propertyName, WRAPPER_KEY_PRESENT_SUBMITTED) == 0) {
+		*value = (int)stats.framesSubmitted;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_PRESENT_DROPPED) == 0) {
+		*value = (int)stats.framesDropped;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+bool getAsyncPresentFloat(AsyncPresent* present, const char* propertyName, float* value) {
+	AsyncPresentStats stats;
+	asyncPresentGetStats(present, &stats);
+
+	if (strcmp(propertyName, WRAPPER_KEY_PRESENT_SUBMIT_SECONDS) == 0) {
+		*value = (float)stats.submitSeconds;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_PRESENT_BLOCKED_SECONDS) == 0) {
+		*value = (float)stats.blockedSeconds;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_PRESENT_OVERLAP_SECONDS) == 0) {
+		double overlap = stats.submitSeconds - stats.blockedSeconds;
+		*value = (float)(overlap > 0.0 ? overlap : 0.0);
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
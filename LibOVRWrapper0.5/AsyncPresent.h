@@ -0,0 +1,67 @@
+#pragma once
+
+#include "d3d11.h"
+
+#include "../LibREV/Include/REV_CAPI.h"
+
+// Optional submit thread for ovrHmd_EndFrame.
+// rev_SubmitFrame blocks on the runtime's frame pacing, with the submit thread EndFrame returns
+// once the eye textures are copied and the app can start on its next frame.
+// The runtime renders with the immediate context of the device the eye chains belong to, which is not thread safe,
+// so while the thread runs the chains belong to a device of its own on the application's adapter.
+// EndFrame copies the eyes into textures shared between both devices, the submit thread copies them into the chains,
+// commits and submits. Keyed mutexes order the copies across the two devices.
+// Finished frames are handed over through a one-deep lock-free mailbox.
+
+struct OculusTexture;
+typedef struct AsyncPresent_ AsyncPresent;
+
+typedef enum AsyncPresentPolicy_
+{
+	asyncPresentPolicy_Block, // EndFrame waits until the submit thread took the previous frame
+	asyncPresentPolicy_DropOldest // a frame still waiting is replaced by the new one
+} AsyncPresentPolicy;
+
+typedef struct AsyncPresentFrame_
+{
+	revSession session;
+	unsigned int frameIndex;
+	bool hasLayer; // without a layer a frame with only a null layer is submitted, see ovrHmd_EndFrameTiming
+	revLayerEyeFov layer; // render poses, viewports, fov and the chains the eyes are copied into
+	OculusTexture* eyeChain[2];
+} AsyncPresentFrame;
+
+typedef struct AsyncPresentStats_
+{
+	unsigned int framesSubmitted;
+	unsigned int framesDropped;
+	double submitSeconds; // spent inside rev_SubmitFrame on the submit thread
+	double blockedSeconds; // EndFrame spent waiting on the submit thread
+} AsyncPresentStats;
+
+// Read only counters served by ovrHmd_GetInt and ovrHmd_GetFloat.
+// The overlap gained is the submit time the app did not have to wait for.
+#define WRAPPER_KEY_PRESENT_SUBMITTED "LibOVRWrapper.AsyncPresentSubmitted"
+#define WRAPPER_KEY_PRESENT_DROPPED "LibOVRWrapper.AsyncPresentDropped"
+#define WRAPPER_KEY_PRESENT_SUBMIT_SECONDS "LibOVRWrapper.AsyncPresentSubmitSeconds"
+#define WRAPPER_KEY_PRESENT_BLOCKED_SECONDS "LibOVRWrapper.AsyncPresentBlockedSeconds"
+#define WRAPPER_KEY_PRESENT_OVERLAP_SECONDS "LibOVRWrapper.AsyncPresentOverlapSeconds"
+
+extern bool globalAsyncPresentEnabled;
+extern AsyncPresentPolicy globalAsyncPresentPolicy;
+
+// One submit thread per hmd, started from ovrHmd_ConfigureRendering and stopped when the hmd is destroyed
+AsyncPresent* asyncPresentStart(AsyncPresentPolicy policy, ID3D11Device* appDevice); // NULL when it could not start
+ID3D11Device* asyncPresentDevice(AsyncPresent* present); // eye chains are created on it while the thread runs
+
+// The app's thread fills a frame between asyncPresentBeginFrame and asyncPresentQueue. In block mode
+// asyncPresentBeginFrame waits until the submit thread took the previous frame, before any eye is staged.
+AsyncPresentFrame* asyncPresentBeginFrame(AsyncPresent* present);
+bool asyncPresentStageEye(AsyncPresent* present, ID3D11DeviceContext* context, int eye, ID3D11Texture2D* source, int width, int height);
+void asyncPresentQueue(AsyncPresent* present);
+void asyncPresentDrain(AsyncPresent* present);
+void asyncPresentStop(AsyncPresent* present);
+void asyncPresentGetStats(AsyncPresent* present, AsyncPresentStats* stats);
+
+bool getAsyncPresentInt(AsyncPresent* present, const char* propertyName, int* value);
+bool getAsyncPresentFloat(AsyncPresent* present, const char* propertyName, float* value);
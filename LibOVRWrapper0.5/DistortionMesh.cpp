@@ -0,0 +1,271 @@
+#include "stdafx.h"
+
+#if !defined(OVR_DLL_BUILD)
+	#define OVR_DLL_BUILD
+#endif
+
+#include "DistortionMesh.h"
+
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define DISTORTION_MESH_SSE
+#endif
+
+#define distortionMeshVignetteBorder 0.075f // share of the eye faded out at each edge when vignetting
+
+// Only these caps change the generated vertices
+#define distortionMeshCapsMask (ovrDistortionCap_TimeWarp | ovrDistortionCap_Vignette)
+
+typedef struct DistortionMeshCacheEntry_
+{
+	ovrEyeType eyeType;
+	ovrFovPort fov;
+	unsigned int caps;
+	ovrDistortionMesh mesh;
+	int refCount; // meshes handed out and not yet destroyed
+	unsigned int lastUse;
+} DistortionMeshCacheEntry;
+
+SRWLOCK distortionMeshCacheLock = SRWLOCK_INIT; // guards the entries and the use counter
+DistortionMeshCacheEntry distortionMeshCache[distortionMeshCacheSize];
+unsigned int distortionMeshUseCounter = 0;
+
+// One row of vertices, u runs over the eye from its left to its right edge.
+// The timewarp factor is u as well, ovrHmd_GetEyeTimewarpMatrices interpolates over the eye's own scanout.
+void generateRow(ovrDistortionVertex* row, int count, float eyeOffsetNDC, float ndcY, float tanY,
+	float rowEdge, ovrFovPort fov, bool timewarp, bool vignette) {
+	const float step = 1.0f / (float)(count - 1);
+	const float tanLeft = -fov.LeftTan;
+	const float tanWidth = fov.LeftTan + fov.RightTan;
+	const float invBorder = 1.0f / distortionMeshVignetteBorder;
+
+	int x = 0;
+
+#ifdef DISTORTION_MESH_SSE
+	const __m128 vStep = _mm_set1_ps(step * 4.0f);
+	const __m128 vTanLeft = _mm_set1_ps(tanLeft);
+	const __m128 vTanWidth = _mm_set1_ps(tanWidth);
+	const __m128 vEyeOffset = _mm_set1_ps(eyeOffsetNDC);
+	const __m128 vOne = _mm_set1_ps(1.0f);
+	const __m128 vZero = _mm_setzero_ps();
+	const __m128 vRowEdge = _mm_set1_ps(rowEdge);
+	const __m128 vInvBorder = _mm_set1_ps(invBorder);
+
+	__m128 u = _mm_mul_ps(_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f), _mm_set1_ps(step));
+
+	for (;x + 4 <= count;x += 4) {
+		__m128 tanX = _mm_add_ps(vTanLeft, _mm_mul_ps(u, vTanWidth));
+		__m128 ndcX = _mm_add_ps(vEyeOffset, u);
+		__m128 tw = timewarp ? u : vZero;
+		__m128 vig = vOne;
+
+		if (vignette) {
+			__m128 edge = _mm_min_ps(_mm_min_ps(u, _mm_sub_ps(vOne, u)), vRowEdge);
+			vig = _mm_max_ps(vZero, _mm_min_ps(vOne, _mm_mul_ps(edge, vInvBorder)));
+		}
+
+		float tanXs[4], ndcXs[4], tws[4], vigs[4];
+		_mm_storeu_ps(tanXs, tanX);
+		_mm_storeu_ps(ndcXs, ndcX);
+		_mm_storeu_ps(tws, tw);
+		_mm_storeu_ps(vigs, vig);
+
+		for (int i = 0;i < 4;i++) {
+			ovrDistortionVertex* v = &row[x + i];
+			v->ScreenPosNDC.x = ndcXs[i];
+			v->ScreenPosNDC.y = ndcY;
+			v->TimeWarpFactor = tws[i];
+			v->VignetteFactor = vigs[i];
+			v->TanEyeAnglesR.x = tanXs[i];
+			v->TanEyeAnglesR.y = tanY;
+			v->TanEyeAnglesG = v->TanEyeAnglesR;
+			v->TanEyeAnglesB = v->TanEyeAnglesR;
+		}
+
+		u = _mm_add_ps(u, vStep);
+	}
+#endif
+
+	for (;x < count;x++) {
+		float u = (float)x * step;
+		ovrDistortionVertex* v = &row[x];
+
+		v->ScreenPosNDC.x = eyeOffsetNDC + u;
+		v->ScreenPosNDC.y = ndcY;
+		v->TimeWarpFactor = timewarp ? u : 0.0f;
+		v->VignetteFactor = 1.0f;
+
+		if (vignette) {
+			float edge = fminf(fminf(u, 1.0f - u), rowEdge) * invBorder;
+			v->VignetteFactor = edge < 0.0f ? 0.0f : (edge > 1.0f ? 1.0f : edge);
+		}
+
+		v->TanEyeAnglesR.x = tanLeft + u * tanWidth;
+		v->TanEyeAnglesR.y = tanY;
+		v->TanEyeAnglesG = v->TanEyeAnglesR;
+		v->TanEyeAnglesB = v->TanEyeAnglesR;
+	}
+}
+
+bool generateMesh(ovrEyeType eyeType, ovrFovPort fov, unsigned int caps, ovrDistortionMesh* mesh) {
+	const int n = distortionMeshGridSize;
+	const unsigned int vertexCount = n * n;
+	const unsigned int indexCount = (n - 1) * (n - 1) * 6;
+
+	mesh->pVertexData = (ovrDistortionVertex*)malloc(sizeof(ovrDistortionVertex) * vertexCount);
+	mesh->pIndexData = (unsigned short*)malloc(sizeof(unsigned short) * indexCount);
+
+	if (mesh->pVertexData == NULL || mesh->pIndexData == NULL) {
+		free(mesh->pVertexData);
+		free(mesh->pIndexData);
+		memset(mesh, 0, sizeof(ovrDistortionMesh));
+		return false;
+	}
+
+	//each eye covers its half of the framebuffer, the left eye the left half
+	float eyeOffsetNDC = eyeType == ovrEye_Left ? -1.0f : 0.0f;
+
+	for (int y = 0;y < n;y++) {
+		float t = (float)y / (float)(n - 1);
+
+		//rows run top to bottom, NDC and tan angle y point up
+		generateRow(&mesh->pVertexData[y * n], n, eyeOffsetNDC, 1.0f - 2.0f * t, fov.UpTan - t * (fov.UpTan + fov.DownTan),
+			fminf(t, 1.0f - t), fov, (caps & ovrDistortionCap_TimeWarp) != 0, (caps & ovrDistortionCap_Vignette) != 0);
+	}
+
+	unsigned short* index = mesh->pIndexData;
+
+	for (int y = 0;y < n - 1;y++) {
+		for (int x = 0;x < n - 1;x++) {
+			unsigned short topLeft = (unsigned short)(y * n + x);
+			unsigned short bottomLeft = (unsigned short)(topLeft + n);
+
+			*index++ = topLeft;
+			*index++ = topLeft + 1;
+			*index++ = bottomLeft + 1;
+
+			*index++ = topLeft;
+			*index++ = bottomLeft + 1;
+			*index++ = bottomLeft;
+		}
+	}
+
+	mesh->VertexCount = vertexCount;
+	mesh->IndexCount = indexCount;
+
+	return true;
+}
+
+void freeCacheEntry(DistortionMeshCacheEntry* entry) {
+	free(entry->mesh.pVertexData);
+	free(entry->mesh.pIndexData);
+	memset(entry, 0, sizeof(DistortionMeshCacheEntry));
+}
+
+ovrBool createDistortionMesh(ovrEyeType eyeType, ovrFovPort fov, unsigned int distortionCaps, ovrDistortionMesh* meshData) {
+	unsigned int caps = distortionCaps & distortionMeshCapsMask;
+	DistortionMeshCacheEntry* entry = NULL;
+	DistortionMeshCacheEntry* victim = NULL;
+
+	//generating a mesh takes well under a millisecond, it is done under the lock so two threads never build the same one
+	AcquireSRWLockExclusive(&distortionMeshCacheLock);
+
+	for (int i = 0;i < distortionMeshCacheSize;i++) {
+		DistortionMeshCacheEntry* e = &distortionMeshCache[i];
+
+		if (e->mesh.pVertexData != NULL && e->eyeType == eyeType && e->caps == caps &&
+			memcmp(&e->fov, &fov, sizeof(ovrFovPort)) == 0) {
+			entry = e;
+			break;
+		}
+
+		//prefer empty slots, then the least recently used mesh nobody holds
+		if (e->refCount == 0 && (victim == NULL || (victim->mesh.pVertexData != NULL &&
+			(e->mesh.pVertexData == NULL || e->lastUse < victim->lastUse)))) {
+			victim = e;
+		}
+	}
+
+	if (entry == NULL) {
+		ovrDistortionMesh mesh;
+
+		if (!generateMesh(eyeType, fov, caps, &mesh)) {
+			ReleaseSRWLockExclusive(&distortionMeshCacheLock);
+			memset(meshData, 0, sizeof(ovrDistortionMesh));
+			return ovrFalse;
+		}
+
+		//every slot is held by the application, hand out an uncached mesh
+		if (victim == NULL) {
+			ReleaseSRWLockExclusive(&distortionMeshCacheLock);
+			*meshData = mesh;
+			return ovrTrue;
+		}
+
+		if (victim->mesh.pVertexData != NULL) {
+			freeCacheEntry(victim);
+		}
+
+		entry = victim;
+		entry->eyeType = eyeType;
+		entry->fov = fov;
+		entry->caps = caps;
+		entry->mesh = mesh;
+	}
+
+	entry->refCount++;
+	entry->lastUse = ++distortionMeshUseCounter;
+
+	*meshData = entry->mesh;
+
+	ReleaseSRWLockExclusive(&distortionMeshCacheLock);
+
+	return ovrTrue;
+}
+
+void destroyDistortionMesh(ovrDistortionMesh* meshData) {
+	if (meshData == NULL || meshData->pVertexData == NULL) {
+		return;
+	}
+
+	bool cached = false;
+
+	AcquireSRWLockExclusive(&distortionMeshCacheLock);
+
+	for (int i = 0;i < distortionMeshCacheSize;i++) {
+		DistortionMeshCacheEntry* e = &distortionMeshCache[i];
+
+		if (e->mesh.pVertexData == meshData->pVertexData) {
+			//the buffers stay cached for the next create
+			if (e->refCount > 0) {
+				e->refCount--;
+			}
+			cached = true;
+			break;
+		}
+	}
+
+	ReleaseSRWLockExclusive(&distortionMeshCacheLock);
+
+	if (!cached) {
+		free(meshData->pVertexData);
+		free(meshData->pIndexData);
+	}
+
+	memset(meshData, 0, sizeof(ovrDistortionMesh));
+}
+
+// Meshes the application still holds are left alone, it releases them with ovrHmd_DestroyDistortionMesh
+void clearDistortionMeshCache() {
+	AcquireSRWLockExclusive(&distortionMeshCacheLock);
+
+	for (int i = 0;i < distortionMeshCacheSize;i++) {
+		if (distortionMeshCache[i].mesh.pVertexData != NULL && distortionMeshCache[i].refCount == 0) {
+			freeCacheEntry(&distortionMeshCache[i]);
+		}
+	}
+
+	ReleaseSRWLockExclusive(&distortionMeshCacheLock);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
+
+// Distortion meshes for client distortion rendering in ovrHmd_CreateDistortionMesh.
+// The mesh maps the eye's half of the framebuffer linearly onto the requested fov, there is deliberately
+// no lens model: ovrHmd_EndFrameTiming submits the application's back buffer as the eye layers and
+// the compositor behind rev_SubmitFrame applies the headset's own lens distortion to them.
+// A barrel distorted mesh would have the image distorted twice.
+// Meshes are cached by (eye, fov, caps) and handed out reference counted,
+// so creating the same mesh again only returns the cached buffers. The cache is shared by all hmds and locked.
+
+#define distortionMeshGridSize 64 // vertices per side, as the 0.5 SDK
+#define distortionMeshCacheSize 8
+
+ovrBool createDistortionMesh(ovrEyeType eyeType, ovrFovPort fov, unsigned int distortionCaps, ovrDistortionMesh* meshData);
+void destroyDistortionMesh(ovrDistortionMesh* meshData);
+void clearDistortionMeshCache();
@@ -0,0 +1,129 @@
+#include "FrameTiming.h"
+
+#include <math.h>
+#include <string.h>
+
+#define frameTimingPhaseGain 0.2 // share of the phase error corrected per observation
+#define frameTimingIntervalGain 0.05
+#define frameTimingRenderGain 0.1
+#define frameTimingMaxIntervalDrift 0.1 // learned interval stays within 10% of the nominal one
+#define frameTimingMaxLockedFrames 8 // longer gaps can not be attributed to a vsync count reliably
+#define frameTimingMaxDelta 0.1 // as documented for ovrFrameTiming::DeltaSeconds
+#define frameTimingMaxRenderFrames 3 // a stall (breakpoint, loading screen) must not push every later frame out
+#define frameTimingTimewarpLead 0.25 // timewarp samples a quarter interval before the vsync
+
+void frameTimingReset(FrameTimingEstimator* e, double refreshRate) {
+	memset(e, 0, sizeof(FrameTimingEstimator));
+
+	e->nominalInterval = 1.0 / (refreshRate > 0.0 ? refreshRate : 90.0);
+	e->interval = e->nominalInterval;
+	e->deltaSeconds = e->interval;
+}
+
+void frameTimingBeginFrame(FrameTimingEstimator* e, double now) {
+	if (e->thisFrameSeconds > 0.0) {
+		double delta = now - e->thisFrameSeconds;
+
+		e->deltaSeconds = delta < 0.0 ? 0.0 : (delta > frameTimingMaxDelta ? frameTimingMaxDelta : delta);
+	}
+
+	e->thisFrameSeconds = now;
+	e->expectedScanoutStart = 0.0;
+}
+
+void frameTimingObserveDisplay(FrameTimingEstimator* e, double predictedDisplayTime) {
+	if (predictedDisplayTime <= 0.0 || predictedDisplayTime == e->lastDisplayTime) {
+		return;
+	}
+
+	e->lastDisplayTime = predictedDisplayTime;
+
+	if (!e->hasPhase) {
+		e->vsyncPhase = predictedDisplayTime;
+		e->hasPhase = true;
+		return;
+	}
+
+	double elapsed = predictedDisplayTime - e->vsyncPhase;
+	double frames = floor(elapsed / e->interval + 0.5);
+
+	//after a pause the vsync count is ambiguous, lock onto the new phase and keep the interval
+	if (frames > frameTimingMaxLockedFrames || frames < -frameTimingMaxLockedFrames) {
+		e->vsyncPhase = predictedDisplayTime;
+		return;
+	}
+
+	double error = elapsed - frames * e->interval;
+
+	e->vsyncPhase += frames * e->interval + frameTimingPhaseGain * error;
+
+	//dropped frames show up as several vsyncs between two observations
+	if (frames >= 1.0) {
+		double sample = elapsed / frames;
+		double minInterval = e->nominalInterval * (1.0 - frameTimingMaxIntervalDrift);
+		double maxInterval = e->nominalInterval * (1.0 + frameTimingMaxIntervalDrift);
+
+		e->interval += frameTimingIntervalGain * (sample - e->interval);
+		e->interval = e->interval < minInterval ? minInterval : (e->interval > maxInterval ? maxInterval : e->interval);
+	}
+}
+
+void frameTimingObserveSubmit(FrameTimingEstimator* e, double now) {
+	if (e->thisFrameSeconds <= 0.0 || now < e->thisFrameSeconds) {
+		return;
+	}
+
+	double render = now - e->thisFrameSeconds;
+	double maxRender = e->interval * frameTimingMaxRenderFrames;
+
+	if (render > maxRender) {
+		render = maxRender;
+	}
+
+	if (e->renderSeconds == 0.0) {
+		e->renderSeconds = render;
+	}
+	else {
+		e->renderSeconds += frameTimingRenderGain * (render - e->renderSeconds);
+	}
+
+	if (e->expectedScanoutStart > 0.0 && now > e->expectedScanoutStart) {
+		e->missedFrames++;
+	}
+}
+
+void frameTimingExpectScanout(FrameTimingEstimator* e, double scanoutStart) {
+	e->expectedScanoutStart = scanoutStart;
+}
+
+void frameTimingEstimate(const FrameTimingEstimator* e, double now, double predictedDisplayTime, FrameTimingEstimate* out) {
+	double interval = e->interval;
+
+	//without a BeginFrame for this frame the query time is the frame start
+	double thisFrame = e->thisFrameSeconds;
+	if (thisFrame <= 0.0 || thisFrame > now || now - thisFrame > frameTimingMaxDelta) {
+		thisFrame = now;
+	}
+
+	double midpoint = predictedDisplayTime > 0.0 ? predictedDisplayTime : now + interval;
+
+	if (e->hasPhase) {
+		midpoint = e->vsyncPhase + floor((midpoint - e->vsyncPhase) / interval + 0.5) * interval;
+	}
+
+	//the frame can not reach the display before it is rendered
+	double scanoutStart = midpoint - interval * 0.5;
+	double earliest = thisFrame + e->renderSeconds;
+
+	if (scanoutStart <= earliest) {
+		scanoutStart += (floor((earliest - scanoutStart) / interval) + 1.0) * interval;
+	}
+
+	out->deltaSeconds = e->thisFrameSeconds > 0.0 ? e->deltaSeconds : interval;
+	out->thisFrameSeconds = thisFrame;
+	out->nextFrameSeconds = scanoutStart;
+	out->timewarpPointSeconds = scanoutStart - fmin(interval * frameTimingTimewarpLead, (scanoutStart - thisFrame) * 0.5);
+	out->scanoutMidpointSeconds = scanoutStart + interval * 0.5;
+	out->eyeScanoutSeconds[0] = scanoutStart + interval * 0.25;
+	out->eyeScanoutSeconds[1] = scanoutStart + interval * 0.75;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Vsync phase-locked frame timing estimator behind ovrHmd_BeginFrame / ovrHmd_GetFrameTiming.
+// It only works on the times handed to it and does not call into the runtime or Windows,
+// so it can be driven by a simulated clock.
+
+typedef struct FrameTimingEstimator_
+{
+	double nominalInterval; // 1 / refresh rate of the display
+	double interval; // learned vsync interval
+	double vsyncPhase; // learned absolute time of a display (scanout midpoint) vsync
+	bool hasPhase;
+	double lastDisplayTime; // last predicted display time observed
+	double thisFrameSeconds; // time the current frame began, 0 before the first BeginFrame
+	double deltaSeconds;
+	double renderSeconds; // smoothed time from frame begin to submit
+	unsigned int missedFrames; // submits that came after the vsync they were timed for
+	double expectedScanoutStart; // vsync the current frame was timed for
+} FrameTimingEstimator;
+
+typedef struct FrameTimingEstimate_
+{
+	double deltaSeconds;
+	double thisFrameSeconds;
+	double timewarpPointSeconds;
+	double nextFrameSeconds;
+	double scanoutMidpointSeconds;
+	double eyeScanoutSeconds[2];
+} FrameTimingEstimate;
+
+void frameTimingReset(FrameTimingEstimator* e, double refreshRate);
+void frameTimingBeginFrame(FrameTimingEstimator* e, double now);
+void frameTimingObserveDisplay(FrameTimingEstimator* e, double predictedDisplayTime);
+void frameTimingObserveSubmit(FrameTimingEstimator* e, double now);
+// Vsync the frame begun last was timed for, a later submit counts as a missed frame
+void frameTimingExpectScanout(FrameTimingEstimator* e, double scanoutStart);
+
+// Always returns thisFrame < timewarpPoint < nextFrame < eyeScanout[0] <= scanoutMidpoint <= eyeScanout[1]
+// Only reads the estimator, the predicted display time is learned from frameTimingObserveDisplay.
+void frameTimingEstimate(const FrameTimingEstimator* e, double now, double predictedDisplayTime, FrameTimingEstimate* out);
@@ -0,0 +1,58 @@
+#include "LatencyEstimator.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+void latencyReset(LatencyEstimator* e) {
+	memset(e, 0, sizeof(LatencyEstimator));
+}
+
+void latencyObserveFrame(LatencyEstimator* e, double trackingSampleTime, double submitDoneTime,
+	double predictedDisplayTime, double frameInterval) {
+	//no tracking sample or frame timing for this frame, nothing to measure against
+	if (trackingSampleTime <= 0.0 || predictedDisplayTime <= trackingSampleTime) {
+		return;
+	}
+
+	double displayTime = predictedDisplayTime;
+
+	//a frame submitted after its vsync is shown on one of the next ones
+	if (frameInterval > 0.0 && submitDoneTime > displayTime) {
+		displayTime += ceil((submitDoneTime - displayTime) / frameInterval) * frameInterval;
+	}
+
+	e->samples[e->next] = displayTime - trackingSampleTime;
+	e->next = (e->next + 1) % latencyWindowSize;
+
+	if (e->count < latencyWindowSize) {
+		e->count++;
+	}
+
+	e->sinceReport++;
+}
+
+bool latencyGetStats(const LatencyEstimator* e, LatencyStats* out) {
+	if (e->count == 0) {
+		return false;
+	}
+
+	double sorted[latencyWindowSize];
+	double sum = 0.0;
+
+	for (unsigned int i = 0;i < e->count;i++) {
+		sorted[i] = e->samples[i];
+		sum += e->samples[i];
+	}
+
+	std::sort(sorted, sorted + e->count);
+
+	unsigned int p99 = (unsigned int)ceil(0.99 * e->count);
+
+	out->minSeconds = sorted[0];
+	out->meanSeconds = sum / e->count;
+	out->p99Seconds = sorted[p99 > 0 ? p99 - 1 : 0];
+	out->frames = e->count;
+
+	return true;
+}
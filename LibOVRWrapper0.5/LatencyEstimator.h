@@ -0,0 +1,29 @@
+#pragma once
+
+// Software stand-in for the latency tester behind ovrHmd_GetLatencyTestResult.
+// Each frame's motion-to-photon latency is estimated as the time from the tracking sample the app
+// rendered with to the display time predicted for the frame, pushed out by the vsyncs it missed
+// when the submit finished too late. Like FrameTiming it only works on the times handed to it.
+
+#define latencyWindowSize 128 // frames the statistics are taken over
+
+typedef struct LatencyEstimator_
+{
+	double samples[latencyWindowSize]; // seconds, ring of the last frames
+	unsigned int count; // valid samples, up to latencyWindowSize
+	unsigned int next;
+	unsigned int sinceReport; // samples since the last ovrHmd_GetLatencyTestResult report
+} LatencyEstimator;
+
+typedef struct LatencyStats_
+{
+	double minSeconds;
+	double meanSeconds;
+	double p99Seconds;
+	unsigned int frames;
+} LatencyStats;
+
+void latencyReset(LatencyEstimator* e);
+void latencyObserveFrame(LatencyEstimator* e, double trackingSampleTime, double submitDoneTime,
+	double predictedDisplayTime, double frameInterval);
+bool latencyGetStats(const LatencyEstimator* e, LatencyStats* out);
@@ -9,15 +9,16 @@
 	#define OVR_DLL_BUILD
 #endif
 
-struct ovrHmdStruct {
-	int dummy;
-};
-
 #include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
 #include "../LibOVR0.5/Include/OVR_CAPI_D3D.h"
 
 #include "shimhelper.h"
 #include "OVRShim.h"
+#include "FrameTiming.h"
+#include "DistortionMesh.h"
+#include "Timewarp.h"
+#include "AsyncPresent.h"
+#include "PerfLog.h"
 
 ovrLogCallback oldLogCallback;
 void logcallback(uintptr_t userData, int level, const char* message) {
@@ -26,7 +27,7 @@ void logcallback(uintptr_t userData, int level, const char* message) {
 
 double initTime;
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_Initialize(const ovrInitParams* params) {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_Initialize";
+	TRACE_EVENT(ovr_Initialize);
 
 	const revInitParams* pp = nullptr;
 	if (params) {
@@ -52,49 +53,62 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovr_Initialize(const ovrInitParams* params) {
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Shutdown() {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_Shutdown";
+	TRACE_EVENT(ovr_Shutdown);
 
-	ShutdownD3D11();
+	clearDistortionMeshCache();
 
 	rev_Shutdown();
+
+	traceShutdown();
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovr_GetVersionString() {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_GetVersionString";
+	TRACE_EVENT(ovr_GetVersionString);
 
 	return "0.5.0";
 }
 
 OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message) {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_TraceMessage";
+	TRACE_EVENT(ovr_TraceMessage);
 
 	return rev_TraceMessage(level, message);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_StartPerfLog(ovrHmd hmd, const char* fileName, const char* userData1)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_StartPerfLog";
+	TRACE_EVENT(ovrHmd_StartPerfLog);
 
-	return ovrFalse;
+	if (hmd->Handle->perfLog != NULL) {
+		perfLogStop(hmd->Handle->perfLog);
+	}
+
+	hmd->Handle->perfLog = perfLogStart(fileName, userData1);
+
+	return hmd->Handle->perfLog != NULL;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_StopPerfLog(ovrHmd hmd)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_StopPerfLog";
+	TRACE_EVENT(ovrHmd_StopPerfLog);
 
-	return ovrFalse;
-}
+	if (hmd->Handle->perfLog == NULL) {
+		return ovrFalse;
+	}
+
+	perfLogStop(hmd->Handle->perfLog);
+	hmd->Handle->perfLog = NULL;
 
-float globalRefreshRate = 90.0f;
+	return ovrTrue;
+}
 
 OVR_PUBLIC_FUNCTION(ovrHmd) ovrHmd_CreateDebug(ovrHmdType type) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_CreateDebug";
+	TRACE_EVENT(ovrHmd_CreateDebug);
 
 	return ovrHmd_Create(0);
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovrHmd_GetLastError(ovrHmd hmd) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetLastError";
+	TRACE_EVENT(ovrHmd_GetLastError);
 
 	static revErrorInfo LastError;
 	rev_GetLastErrorInfo(&LastError);
@@ -102,7 +116,7 @@ OVR_PUBLIC_FUNCTION(const char*) ovrHmd_GetLastError(ovrHmd hmd) {
 }
 
 OVR_PUBLIC_FUNCTION(int) ovrHmd_Detect() {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_Detect";
+	TRACE_EVENT(ovrHmd_Detect);
 
 	revHmdDesc desc = rev_GetHmdDesc(NULL);
 
@@ -113,35 +127,36 @@ OVR_PUBLIC_FUNCTION(int) ovrHmd_Detect() {
 	}
 }
 
-revGraphicsLuid globalGraphicsLuid;
-HWND globalMirrorWindowHandle;
-bool globalDisableMirror = false;
-ovrRenderAPIConfig globalAPIConfig;
-ovrFovPort globalEyeFOV[2];
-ovrEyeRenderDesc globalEyeRenderDesc[2];
-
 OVR_PUBLIC_FUNCTION(ovrHmd) ovrHmd_Create(int index) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_Create";
+	TRACE_EVENT(ovrHmd_Create);
 
 	revSession pSession;
 	revGraphicsLuid pLuid;
 
-	globalDisableMirror = false;
-
 	revResult r = rev_Create(&pSession, &pLuid);
 
 	if (!REV_SUCCESS(r)) {
 		return NULL;
 	}
 
-	globalGraphicsLuid = pLuid;
-
 	revHmdDesc desc = rev_GetHmdDesc(pSession);
 
+	ovrHmdStruct* state = (ovrHmdStruct*)_aligned_malloc(sizeof(ovrHmdStruct), ovrSessionStateAlignment);
 	ovrHmdDesc* d = (ovrHmdDesc*)malloc(sizeof(ovrHmdDesc));
+
+	if (state == NULL || d == NULL) {
+		_aligned_free(state);
+		free(d);
+		rev_Destroy(pSession);
+		return NULL;
+	}
+
+	ZeroMemory(state, sizeof(ovrHmdStruct));
 	ZeroMemory(d, sizeof(ovrHmdDesc));
 
-	d->Handle = (ovrHmdStruct *)pSession;
+	state->session = pSession;
+	state->graphicsLuid = pLuid;
+	d->Handle = state;
 	d->HmdCaps = ovrHmdCap_Present | ovrHmdCap_Available | ovrHmdCap_Captured | ovrHmdCap_LowPersistence | ovrHmdCap_DynamicPrediction;
 	d->DistortionCaps = ovrDistortionCap_Vignette | ovrDistortionCap_Overdrive; // ovrDistortionCap_TimeWarp | 
 	d->TrackingCaps = desc.AvailableTrackingCaps;
@@ -154,7 +169,10 @@ OVR_PUBLIC_FUNCTION(ovrHmd) ovrHmd_Create(int index) {
 	d->CameraFrustumVFovInRadians = tracker.FrustumVFovInRadians;
 
 	memcpy(d->DefaultEyeFov, desc.DefaultEyeFov, sizeof(d->DefaultEyeFov));
-	globalRefreshRate = desc.DisplayRefreshRate;
+	state->refreshRate = desc.DisplayRefreshRate;
+	InitializeSRWLock(&state->frameTimingLock);
+	frameTimingReset(&state->frameTiming, state->refreshRate);
+	latencyReset(&state->latency);
 	d->FirmwareMajor = desc.FirmwareMajor;
 	d->FirmwareMinor = desc.FirmwareMinor;
 
@@ -194,7 +212,7 @@ OVR_PUBLIC_FUNCTION(ovrHmd) ovrHmd_Create(int index) {
 #if 0 //ldf
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetMirrorTexture(ovrHmd hmd, ovrTexture** outMirrorTexture)
 {
-	GetMirrorTexture(outMirrorTexture);
+	GetMirrorTexture(hmd->Handle, outMirrorTexture);
 
 	return 1;
 }
@@ -202,45 +220,54 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetMirrorTexture(ovrHmd hmd, ovrTexture** ou
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_AttachToWindow(ovrHmd hmd, void* window,
 	const ovrRecti* destMirrorRect, const ovrRecti* sourceRenderTargetRect)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_AttachToWindow";
+	TRACE_EVENT(ovrHmd_AttachToWindow);
 
-	globalMirrorWindowHandle = (HWND)window;
-	//CreateMirrorTextureD3D11((revSession)hmd->Handle, destMirrorRect, sourceRenderTargetRect);
+	hmd->Handle->mirrorWindow = (HWND)window;
+	//CreateMirrorTextureD3D11(hmd->Handle, destMirrorRect, sourceRenderTargetRect);
 	//todo: possibly save sourceRenderTargetRect which is the area of the mirror window we should draw to (or NULL for whole mirror window)
 	return ovrTrue;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_Destroy(ovrHmd hmd) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_Destroy";
+	TRACE_EVENT(ovrHmd_Destroy);
 
-	rev_Destroy((revSession)hmd->Handle);
+	perfLogStop(hmd->Handle->perfLog);
+	ShutdownD3D11(hmd->Handle);
+	rev_Destroy(hmd->Handle->session);
+
+	_aligned_free(hmd->Handle);
+	free((void*)hmd->Manufacturer);
+	free((void*)hmd->ProductName);
+	free((void*)hmd);
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovrHmd_GetEnabledCaps(ovrHmd hmd) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetEnabledCaps";
+	TRACE_EVENT(ovrHmd_GetEnabledCaps);
 
-	revHmdDesc desc = rev_GetHmdDesc((revSession)hmd->Handle);
+	revHmdDesc desc = rev_GetHmdDesc(hmd->Handle->session);
 
 	//not possible anymore
 	return desc.DefaultHmdCaps | ovrHmdCap_Present | ovrHmdCap_Available | ovrHmdCap_Captured | ovrHmdCap_LowPersistence | ovrHmdCap_DynamicPrediction;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_SetEnabledCaps(ovrHmd hmd, unsigned int hmdCaps) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetEnabledCaps";
-	globalDisableMirror = hmdCaps & ovrHmdCap_NoMirrorToWindow;
+	TRACE_EVENT(ovrHmd_SetEnabledCaps);
+	hmd->Handle->disableMirror = (hmdCaps & ovrHmdCap_NoMirrorToWindow) != 0;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_ConfigureTracking(ovrHmd hmd, unsigned int requestedTrackingCaps,
 	unsigned int requiredTrackingCaps) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_ConfigureTracking";
+	TRACE_EVENT(ovrHmd_ConfigureTracking);
 	//not used anymore
 	return revSuccess;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_RecenterPose(ovrHmd hmd) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_RecenterPose";
+	TRACE_EVENT(ovrHmd_RecenterPose);
+
+	rev_RecenterTrackingOrigin(hmd->Handle->session);
 
-	rev_RecenterTrackingOrigin((revSession)hmd->Handle);
+	hmd->Handle->hmdPosePerEyeValid[0] = hmd->Handle->hmdPosePerEyeValid[1] = false;
 }
 
 void copyPose(ovrPosef* dest, const revPosef* source) {
@@ -262,14 +289,11 @@ void copyPoseState(ovrPoseStatef* dest, const revPoseStatef* source) {
 	dest->TimeInSeconds = source->TimeInSeconds;
 }
 
-double globalTrackingStateTime = 0.0;
-uint32_t globalLastCameraFrameCounter = 0;
-
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovrHmd_GetTrackingState(ovrHmd hmd, double absTime) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetTrackingState";
+	TRACE_EVENT(ovrHmd_GetTrackingState);
 
-	revTrackingState state = rev_GetTrackingState((revSession)hmd->Handle, absTime, ovrTrue);
-	revTrackerPose tpose = rev_GetTrackerPose((revSession)hmd->Handle, 0);	
+	revTrackingState state = rev_GetTrackingState(hmd->Handle->session, absTime, ovrTrue);
+	revTrackerPose tpose = rev_GetTrackerPose(hmd->Handle->session, 0);	
 	
 	ovrTrackingState r;	
 	ZeroMemory(&r, sizeof(ovrTrackingState));
@@ -281,7 +305,7 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovrHmd_GetTrackingState(ovrHmd hmd, double
 	copyPoseState(&(r.HeadPose), &(state.HeadPose));
 
 	//r.LastCameraFrameCounter not filled
-	r.LastCameraFrameCounter = ++globalLastCameraFrameCounter;
+	r.LastCameraFrameCounter = ++hmd->Handle->lastCameraFrameCounter;
 
 	copyPose(&(r.LeveledCameraPose), &(tpose.LeveledPose));
 
@@ -304,14 +328,14 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovrHmd_GetTrackingState(ovrHmd hmd, double
 
 	r.StatusFlags = state.StatusFlags | ovrStatus_CameraPoseTracked | ovrStatus_PositionConnected | ovrStatus_HmdConnected;
 	
-	globalTrackingStateTime = rev_GetTimeInSeconds();
+	hmd->Handle->trackingStateTime = rev_GetTimeInSeconds();
 
 	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrSizei) ovrHmd_GetFovTextureSize(ovrHmd hmd, ovrEyeType eye, ovrFovPort fov,
 	float pixelsPerDisplayPixel) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFovTextureSize";
+	TRACE_EVENT(ovrHmd_GetFovTextureSize);
 	
 	revFovPort fport;
 	fport.DownTan = fov.DownTan;
@@ -319,13 +343,28 @@ OVR_PUBLIC_FUNCTION(ovrSizei) ovrHmd_GetFovTextureSize(ovrHmd hmd, ovrEyeType ey
 	fport.RightTan = fov.RightTan;
 	fport.UpTan = fov.UpTan;
 
-	return *(ovrSizei *)&rev_GetFovTextureSize((revSession)hmd->Handle, (revEyeType)eye, fport, pixelsPerDisplayPixel);
+	return *(ovrSizei *)&rev_GetFovTextureSize(hmd->Handle->session, (revEyeType)eye, fport, pixelsPerDisplayPixel);
 }
 
+// ovrHmd_GetRenderScaleAndOffset is called with the same arguments every frame for both eyes.
+// It takes no hmd, so the cache is shared by all of them and keyed by every argument, entries never go stale.
+typedef struct RenderScaleAndOffset_
+{
+	ovrFovPort fov;
+	ovrSizei textureSize;
+	ovrRecti renderViewport;
+	ovrVector2f uvScaleOffset[2];
+	bool valid;
+} RenderScaleAndOffset;
+
+SRWLOCK globalRenderScaleAndOffsetLock = SRWLOCK_INIT;
+RenderScaleAndOffset globalRenderScaleAndOffset[2];
+unsigned int globalRenderScaleAndOffsetNext = 0;
+
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_ConfigureRendering(ovrHmd hmd, const ovrRenderAPIConfig* apiConfig, unsigned int distortionCaps,
 	const ovrFovPort eyeFovIn[2], ovrEyeRenderDesc eyeRenderDescOut[2])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_ConfigureRendering";
+	TRACE_EVENT(ovrHmd_ConfigureRendering);
 
 	ovrEyeRenderDesc r[2];
 	for (int eye = 0; eye < 2; eye++) {
@@ -333,70 +372,152 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_ConfigureRendering(ovrHmd hmd, const ovrRend
 		if (eyeRenderDescOut)
 			eyeRenderDescOut[eye] = r[eye];
 	}
+
 	if (apiConfig) {
-		globalAPIConfig = *apiConfig;
 		if (apiConfig->Header.API == ovrRenderAPI_D3D11) {
-			ConfigureD3D11((revSession)(hmd->Handle), apiConfig, distortionCaps, eyeFovIn, r);
+			ConfigureD3D11(hmd->Handle, apiConfig, distortionCaps, eyeFovIn, r);
 		} else {
-			BOOST_LOG_TRIVIAL(trace) << "ovrHmd_ConfigureRendering error. unsupported rendering API " << apiConfig->Header.API;
+			TRACE_EVENT1(ovrHmd_ConfigureRenderingUnsupportedApi, apiConfig->Header.API);
 			return ovrFalse;
 		}
 	}
 	return ovrTrue;
 }
 
-unsigned int globalFrameIndex = 0;
-
 OVR_PUBLIC_FUNCTION(ovrFrameTiming) ovrHmd_BeginFrame(ovrHmd hmd, unsigned int frameIndex)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_BeginFrame index " << frameIndex;
+	TRACE_EVENT1(ovrHmd_BeginFrame, frameIndex);
+
+	double now = rev_GetTimeInSeconds();
+
+	hmd->Handle->frameIndex = frameIndex;
+	hmd->Handle->hmdPosePerEyeValid[0] = hmd->Handle->hmdPosePerEyeValid[1] = false;
+
+	AcquireSRWLockExclusive(&hmd->Handle->frameTimingLock);
+	frameTimingBeginFrame(&hmd->Handle->frameTiming, now);
+	frameTimingObserveDisplay(&hmd->Handle->frameTiming, rev_GetPredictedDisplayTime(hmd->Handle->session, frameIndex));
+	ReleaseSRWLockExclusive(&hmd->Handle->frameTimingLock);
 
-	globalFrameIndex = frameIndex;
-	return ovrHmd_GetFrameTiming(hmd, frameIndex);
+	ovrFrameTiming timing = ovrHmd_GetFrameTiming(hmd, frameIndex);
+
+	AcquireSRWLockExclusive(&hmd->Handle->frameTimingLock);
+	frameTimingExpectScanout(&hmd->Handle->frameTiming, timing.NextFrameSeconds);
+	ReleaseSRWLockExclusive(&hmd->Handle->frameTimingLock);
+
+	hmd->Handle->predictedDisplayTime = timing.ScanoutMidpointSeconds;
+
+	if (hmd->Handle->perfLog != NULL) {
+		perfLogBeginFrame(hmd->Handle->perfLog, frameIndex, now, timing.ScanoutMidpointSeconds);
+	}
+
+	return timing;
+}
+
+// Feeds a submitted frame to the timing, latency and perf log estimators
+void observeFrameEnd(ovrHmd hmd, double start)
+{
+	double now = rev_GetTimeInSeconds();
+
+	AcquireSRWLockExclusive(&hmd->Handle->frameTimingLock);
+	frameTimingObserveSubmit(&hmd->Handle->frameTiming, now);
+	double interval = hmd->Handle->frameTiming.interval;
+	unsigned int missedFrames = hmd->Handle->frameTiming.missedFrames;
+	ReleaseSRWLockExclusive(&hmd->Handle->frameTimingLock);
+
+	latencyObserveFrame(&hmd->Handle->latency, hmd->Handle->trackingStateTime, now,
+		hmd->Handle->predictedDisplayTime, interval);
+
+	if (hmd->Handle->perfLog != NULL) {
+		perfLogEndFrame(hmd->Handle->perfLog, now, now - start, missedFrames);
+	}
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_EndFrame(ovrHmd hmd, const ovrPosef renderPose[2], const ovrTexture eyeTexture[2])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_EndFrame";
+	TRACE_EVENT(ovrHmd_EndFrame);
 
 	// This is where we do the actual rendering, using the eye textures that they passed in.
 	if (!eyeTexture || eyeTexture[0].Header.API != ovrRenderAPI_D3D11)
 		return;
-	PresentD3D11((revSession)(hmd->Handle), renderPose, eyeTexture);
+	double start = rev_GetTimeInSeconds();
+
+	PresentD3D11(hmd->Handle, renderPose, eyeTexture);
+
+	observeFrameEnd(hmd, start);
 }
 
 OVR_PUBLIC_FUNCTION(ovrFrameTiming) ovrHmd_BeginFrameTiming(ovrHmd hmd, unsigned int frameIndex)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_BeginFrameTiming";
+	TRACE_EVENT(ovrHmd_BeginFrameTiming);
 
 	return ovrHmd_BeginFrame(hmd, frameIndex);
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_EndFrameTiming(ovrHmd hmd)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_EndFrameTiming";
+	TRACE_EVENT(ovrHmd_EndFrameTiming);
+
+	// They did the distortion themselves, with the linear meshes of ovrHmd_CreateDistortionMesh the eyes
+	// are side by side in their back buffer and the compositor applies the lens distortion to it.
+	ovrHmdStruct* state = hmd->Handle;
+	double start = rev_GetTimeInSeconds();
+
+	//they rendered from the head poses of ovrHmd_GetHmdPosePerEye moved to the eyes,
+	//which ovr_CalcEyePoses does with the HmdToEyeViewOffset of ovrHmd_ConfigureRendering
+	ovrPosef renderPose[2];
+	for (int eye = 0;eye < 2;eye++) {
+		renderPose[eye] = ovrHmd_GetHmdPosePerEye(hmd, (ovrEyeType)eye);
+
+		ovrVector3f offset = quatRotate(&renderPose[eye].Orientation, &state->eyeRenderDesc[eye].HmdToEyeViewOffset);
+		renderPose[eye].Position.x += offset.x;
+		renderPose[eye].Position.y += offset.y;
+		renderPose[eye].Position.z += offset.z;
+	}
+
+	if (!PresentBackBufferD3D11(state, renderPose)) {
+		//without a back buffer from ovrHmd_ConfigureRendering the frame is still submitted,
+		//so the runtime keeps pacing the application and the frame timing stays learned
+		if (state->asyncPresent != NULL) {
+			AsyncPresentFrame* frame = asyncPresentBeginFrame(state->asyncPresent);
+			frame->session = state->session;
+			frame->frameIndex = state->frameIndex;
+			frame->hasLayer = false;
 
-	// This is where we do the actual non-rendering. They are trying to do the distortion themselves.
+			asyncPresentQueue(state->asyncPresent);
+		}
+		else {
+			revLayerHeader* layers[1] = { NULL };
+			rev_SubmitFrame(state->session, state->frameIndex, NULL, layers, 1);
+		}
+	}
+
+	observeFrameEnd(hmd, start);
 }
 
 
 
 OVR_PUBLIC_FUNCTION(ovrPosef) ovrHmd_GetHmdPosePerEye(ovrHmd hmd, ovrEyeType eye)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetHmdPosePerEye";
-
-	// todo
-	{
-		static ovrPosef nullPose;
-		memset(&nullPose, 0, sizeof(nullPose));
-		nullPose.Orientation.w = 1.0f; // Return a proper quaternion.
-		return nullPose;
+	TRACE_EVENT(ovrHmd_GetHmdPosePerEye);
+
+	ovrHmdStruct* state = hmd->Handle;
+
+	//the SDK leaves applying HmdToEyeViewOffset to the caller, only the prediction time depends on the eye
+	if (!state->hmdPosePerEyeValid[eye]) {
+		ovrFrameTiming timing = ovrHmd_GetFrameTiming(hmd, state->frameIndex);
+		revTrackingState tracking = rev_GetTrackingState(state->session, timing.EyeScanoutSeconds[eye], ovrTrue);
+
+		copyPose(&state->hmdPosePerEye[eye], &tracking.HeadPose.ThePose);
+		state->hmdPosePerEyeValid[eye] = true;
+		state->trackingStateTime = rev_GetTimeInSeconds();
 	}
+
+	return state->hmdPosePerEye[eye];
 }
 
 OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovrHmd_GetRenderDesc(ovrHmd hmd,
 	ovrEyeType eyeType, ovrFovPort fov) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetRenderDesc";
+	TRACE_EVENT(ovrHmd_GetRenderDesc);
 
 	revFovPort fport;
 	fport.DownTan = fov.DownTan;
@@ -404,7 +525,7 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovrHmd_GetRenderDesc(ovrHmd hmd,
 	fport.RightTan = fov.RightTan;
 	fport.UpTan = fov.UpTan;
 
-	revEyeRenderDesc desc = rev_GetRenderDesc((revSession)hmd->Handle, (revEyeType)eyeType, fport);
+	revEyeRenderDesc desc = rev_GetRenderDesc(hmd->Handle->session, (revEyeType)eyeType, fport);
 
 	ovrEyeRenderDesc r;
 
@@ -423,46 +544,75 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovrHmd_GetRenderDesc(ovrHmd hmd,
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_CreateDistortionMesh(ovrHmd hmd, ovrEyeType eyeType, ovrFovPort fov,
 	unsigned int distortionCaps, ovrDistortionMesh *meshData)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_CreateDistortionMesh";
+	TRACE_EVENT(ovrHmd_CreateDistortionMesh);
 
-	//todo
-	return ovrFalse;
+	return createDistortionMesh(eyeType, fov, distortionCaps, meshData);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_CreateDistortionMeshDebug(ovrHmd hmd, ovrEyeType eyeType, ovrFovPort fov, unsigned int distortionCaps,
 	ovrDistortionMesh *meshData, float debugEyeReliefOverrideInMetres)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_CreateDistortionMeshDebug";
+	TRACE_EVENT(ovrHmd_CreateDistortionMeshDebug);
 
-	//todo
-	return ovrFalse;
+	//there is no lens model the eye relief could change
+	return createDistortionMesh(eyeType, fov, distortionCaps, meshData);
 }
 
 OVR_PUBLIC_FUNCTION(int) ovrHmd_AddDistortionTimeMeasurement(ovrHmd hmd, double distortionTimeSeconds) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_AddDistortionTimeMeasurement";
+	TRACE_EVENT(ovrHmd_AddDistortionTimeMeasurement);
 	// not sure what to do or return here
 	return ovrFalse;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_DestroyDistortionMesh(ovrDistortionMesh* meshData)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_DestroyDistortionMesh";
+	TRACE_EVENT(ovrHmd_DestroyDistortionMesh);
 
-	//todo - since we can't create a distortion mesh, there's never going to be anything to destroy here
+	destroyDistortionMesh(meshData);
 }
 
 OVR_PUBLIC_FUNCTION(int) ovrHmd_RegisterPostDistortionCallback(ovrHmd hmd, void *callback) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_RegisterPostDistortionCallback";
+	TRACE_EVENT(ovrHmd_RegisterPostDistortionCallback);
 	return 0;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_GetRenderScaleAndOffset(ovrFovPort fov, ovrSizei textureSize, ovrRecti renderViewport,
 	ovrVector2f uvScaleOffsetOut[2])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetRenderScaleAndOffset";
+	TRACE_EVENT(ovrHmd_GetRenderScaleAndOffset);
+
+	AcquireSRWLockShared(&globalRenderScaleAndOffsetLock);
+
+	for (int i = 0;i < 2;i++) {
+		RenderScaleAndOffset* cached = &globalRenderScaleAndOffset[i];
 
-	// todo: set values to something sensible?
-	return;
+		if (cached->valid && memcmp(&cached->fov, &fov, sizeof(fov)) == 0 &&
+			memcmp(&cached->textureSize, &textureSize, sizeof(textureSize)) == 0 &&
+			memcmp(&cached->renderViewport, &renderViewport, sizeof(renderViewport)) == 0) {
+			uvScaleOffsetOut[0] = cached->uvScaleOffset[0];
+			uvScaleOffsetOut[1] = cached->uvScaleOffset[1];
+			ReleaseSRWLockShared(&globalRenderScaleAndOffsetLock);
+			return;
+		}
+	}
+
+	ReleaseSRWLockShared(&globalRenderScaleAndOffsetLock);
+
+	calcRenderScaleAndOffset(fov, textureSize, renderViewport, uvScaleOffsetOut);
+
+	AcquireSRWLockExclusive(&globalRenderScaleAndOffsetLock);
+
+	RenderScaleAndOffset* entry = &globalRenderScaleAndOffset[globalRenderScaleAndOffsetNext];
+	globalRenderScaleAndOffsetNext = (globalRenderScaleAndOffsetNext + 1) % 2;
+
+	entry->fov = fov;
+	entry->textureSize = textureSize;
+	entry->renderViewport = renderViewport;
+	entry->uvScaleOffset[0] = uvScaleOffsetOut[0];
+	entry->uvScaleOffset[1] = uvScaleOffsetOut[1];
+	entry->valid = true;
+
+	ReleaseSRWLockExclusive(&globalRenderScaleAndOffsetLock);
 }
 
 
@@ -470,63 +620,157 @@ OVR_PUBLIC_FUNCTION(void) ovrHmd_GetRenderScaleAndOffset(ovrFovPort fov, ovrSize
 /// ThisFrameSeconds < TimewarpPointSeconds < NextFrameSeconds < 
 /// EyeScanoutSeconds[EyeOrder[0]] <= ScanoutMidpointSeconds <= EyeScanoutSeconds[EyeOrder[1]].
 OVR_PUBLIC_FUNCTION(ovrFrameTiming) ovrHmd_GetFrameTiming(ovrHmd hmd, unsigned int frameIndex) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFrameTiming index " << frameIndex;
+	TRACE_EVENT1(ovrHmd_GetFrameTiming, frameIndex);
+
+	double predictedDisplayTime = rev_GetPredictedDisplayTime(hmd->Handle->session, frameIndex);
+
+	FrameTimingEstimate estimate;
+	AcquireSRWLockShared(&hmd->Handle->frameTimingLock);
+	frameTimingEstimate(&hmd->Handle->frameTiming, rev_GetTimeInSeconds(), predictedDisplayTime, &estimate);
+	ReleaseSRWLockShared(&hmd->Handle->frameTimingLock);
 
 	ovrFrameTiming timing;
-	timing.ScanoutMidpointSeconds = rev_GetPredictedDisplayTime((revSession)hmd->Handle, frameIndex);
-	timing.ThisFrameSeconds = rev_GetTimeInSeconds();
-	timing.DeltaSeconds = 1.0f / globalRefreshRate; //todo: calculate this somehow?
-	timing.NextFrameSeconds = timing.ThisFrameSeconds + timing.DeltaSeconds;
-	timing.EyeScanoutSeconds[0] = timing.ScanoutMidpointSeconds;
-	timing.EyeScanoutSeconds[1] = timing.ScanoutMidpointSeconds;
-	timing.TimewarpPointSeconds = timing.ScanoutMidpointSeconds;
-	
+	timing.DeltaSeconds = (float)estimate.deltaSeconds;
+	timing.Pad = 0.0f;
+	timing.ThisFrameSeconds = estimate.thisFrameSeconds;
+	timing.TimewarpPointSeconds = estimate.timewarpPointSeconds;
+	timing.NextFrameSeconds = estimate.nextFrameSeconds;
+	timing.ScanoutMidpointSeconds = estimate.scanoutMidpointSeconds;
+	timing.EyeScanoutSeconds[0] = estimate.eyeScanoutSeconds[0];
+	timing.EyeScanoutSeconds[1] = estimate.eyeScanoutSeconds[1];
+
 	return timing;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_ResetFrameTiming(ovrHmd hmd, unsigned int frameIndex) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_ResetFrameTiming";
+	TRACE_EVENT(ovrHmd_ResetFrameTiming);
 
-	globalFrameIndex = frameIndex;
+	hmd->Handle->frameIndex = frameIndex;
+
+	AcquireSRWLockExclusive(&hmd->Handle->frameTimingLock);
+	frameTimingReset(&hmd->Handle->frameTiming, hmd->Handle->refreshRate);
+	ReleaseSRWLockExclusive(&hmd->Handle->frameTimingLock);
 }
 
-OVR_PUBLIC_FUNCTION(void) ovrHmd_GetEyeTimewarpMatrices(ovrHmd hmd, ovrEyeType eye, ovrPosef renderPose, ovrMatrix4f twmOut[2])
+// Head orientations predicted for the start of scanout, the switch between the eyes and the end of scanout.
+// Both eyes of a frame need the same three, so they are only queried again when the scanout times move.
+void predictScanoutOrientations(ovrHmd hmd, double timingOffset, ovrQuatf predicted[3])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetEyeTimewarpMatrices";
-	// todo
-	
+	ovrHmdStruct* state = hmd->Handle;
+	ovrFrameTiming timing = ovrHmd_GetFrameTiming(hmd, state->frameIndex);
+	double eyeScanout = timing.ScanoutMidpointSeconds - timing.NextFrameSeconds;
+	double times[3];
+
+	for (int i = 0;i < 3;i++) {
+		times[i] = timing.NextFrameSeconds + i * eyeScanout + timingOffset;
+	}
+
+	if (!state->timewarpValid || memcmp(times, state->timewarpTimes, sizeof(times)) != 0) {
+		for (int i = 0;i < 3;i++) {
+			revTrackingState tracking = rev_GetTrackingState(state->session, times[i], ovrFalse);
+
+			state->timewarpOrientations[i] = *(ovrQuatf*)&tracking.HeadPose.ThePose.Orientation;
+		}
+
+		memcpy(state->timewarpTimes, times, sizeof(times));
+		state->timewarpValid = true;
+		state->timewarpMatricesValid = false;
+	}
+
+	memcpy(predicted, state->timewarpOrientations, sizeof(state->timewarpOrientations));
+}
+
+// The matrices of both eyes from one prediction. Apps ask for one eye at a time and usually render both
+// with the same head orientation, so the second eye of a frame is answered from the first eye's pass.
+void getEyeTimewarpMatricesBothEyes(ovrHmd hmd, const ovrPosef renderPose[2], ovrMatrix4f twmOut[2][2])
+{
+	ovrHmdStruct* state = hmd->Handle;
+	ovrQuatf predicted[3];
+	predictScanoutOrientations(hmd, 0.0, predicted);
+
+	ovrQuatf renderOrientation[2] = { renderPose[0].Orientation, renderPose[1].Orientation };
+
+	if (!state->timewarpMatricesValid || memcmp(renderOrientation, state->timewarpRenderOrientations, sizeof(renderOrientation)) != 0) {
+		calcTimewarpMatricesBothEyes(renderOrientation, predicted, state->timewarpMatrices);
+		memcpy(state->timewarpRenderOrientations, renderOrientation, sizeof(renderOrientation));
+		state->timewarpMatricesValid = true;
+	}
+
+	memcpy(twmOut, state->timewarpMatrices, sizeof(state->timewarpMatrices));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_GetEyeTimewarpMatricesDebug(ovrHmd hmd, ovrEyeType eye, ovrPosef renderPose,
 	ovrQuatf playerTorsoMotion, ovrMatrix4f twmOut[2], double debugTimingOffsetInSeconds)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetEyeTimewarpMatricesDebug";
+	TRACE_EVENT(ovrHmd_GetEyeTimewarpMatricesDebug);
 
-	// todo
+	ovrQuatf predicted[3];
+	predictScanoutOrientations(hmd, debugTimingOffsetInSeconds, predicted);
+
+	//the torso turned by playerTorsoMotion since the frame was rendered, on top of the head motion
+	for (int i = 0;i < 3;i++) {
+		predicted[i] = quatMultiply(&playerTorsoMotion, &predicted[i]);
+	}
+
+	ovrQuatf renderOrientation[2] = { renderPose.Orientation, renderPose.Orientation };
+	ovrMatrix4f twm[2][2];
+	calcTimewarpMatricesBothEyes(renderOrientation, predicted, twm);
+
+	twmOut[0] = twm[eye][0];
+	twmOut[1] = twm[eye][1];
+}
+
+OVR_PUBLIC_FUNCTION(void) ovrHmd_GetEyeTimewarpMatrices(ovrHmd hmd, ovrEyeType eye, ovrPosef renderPose, ovrMatrix4f twmOut[2])
+{
+	TRACE_EVENT(ovrHmd_GetEyeTimewarpMatrices);
+
+	//the pair spans the eye's own half of the scanout, the mesh's TimeWarpFactor runs from 0 to 1 across each eye
+	ovrPosef renderPoses[2] = { renderPose, renderPose };
+	ovrMatrix4f twm[2][2];
+	getEyeTimewarpMatricesBothEyes(hmd, renderPoses, twm);
+
+	twmOut[0] = twm[eye][0];
+	twmOut[1] = twm[eye][1];
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds() {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_GetTimeInSeconds";
+	TRACE_EVENT(ovr_GetTimeInSeconds);
 
 	return rev_GetTimeInSeconds();
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_ProcessLatencyTest(ovrHmd hmd, unsigned char rgbColorOut[3])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_ProcessLatencyTest";
+	TRACE_EVENT(ovrHmd_ProcessLatencyTest);
 
+	//there is no latency tester to flash the screen for, the latency is estimated from the frame timing
 	return ovrFalse;
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovrHmd_GetLatencyTestResult(ovrHmd hmd)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetLatencyTestResult";
-	return "(Unable to load LibOVR)";
+	TRACE_EVENT(ovrHmd_GetLatencyTestResult);
+
+	ovrHmdStruct* state = hmd->Handle;
+	LatencyStats stats;
+
+	//a new result once per window of frames, like the tester reported once per measurement
+	if (state->latency.sinceReport < latencyWindowSize || !latencyGetStats(&state->latency, &stats)) {
+		return NULL;
+	}
+
+	state->latency.sinceReport = 0;
+
+	sprintf_s(state->latencyResult, sizeof(state->latencyResult),
+		"Estimated motion to photon latency: min %.1f ms, mean %.1f ms, p99 %.1f ms over %u frames",
+		stats.minSeconds * 1000.0, stats.meanSeconds * 1000.0, stats.p99Seconds * 1000.0, stats.frames);
+
+	return state->latencyResult;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetLatencyTest2DrawColor(ovrHmd hmd, unsigned char rgbColorOut[3])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetLatencyTest2DrawColor";
+	TRACE_EVENT(ovrHmd_GetLatencyTest2DrawColor);
 
 	return ovrFalse;
 }
@@ -534,7 +778,7 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetLatencyTest2DrawColor(ovrHmd hmd, unsigne
 /* hidden functions */
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetLatencyTestDrawColor(ovrHmd hmd, unsigned char rgbColorOut[3])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetLatencyTestDrawColor";
+	TRACE_EVENT(ovrHmd_GetLatencyTestDrawColor);
 
 	//todo: right parameters
 
@@ -544,16 +788,17 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetLatencyTestDrawColor(ovrHmd hmd, unsigned
 /* hidden functions */
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetMeasuredLatencyTest2(ovrHmd hmd)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetMeasuredLatencyTest2";
+	TRACE_EVENT(ovrHmd_GetMeasuredLatencyTest2);
 
 	//todo: right parameters
 
-	return ovrFalse;
+	LatencyStats stats;
+	return latencyGetStats(&hmd->Handle->latency, &stats);
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_GetHSWDisplayState(ovrHmd hmd, ovrHSWDisplayState *hasWarningState)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetHSWDisplayState";
+	TRACE_EVENT(ovrHmd_GetHSWDisplayState);
 
 	if (hasWarningState) {
 		hasWarningState->Displayed = false;
@@ -564,50 +809,60 @@ OVR_PUBLIC_FUNCTION(void) ovrHmd_GetHSWDisplayState(ovrHmd hmd, ovrHSWDisplaySta
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_DismissHSWDisplay(ovrHmd hmd)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_DismissHSWDisplay";
+	TRACE_EVENT(ovrHmd_DismissHSWDisplay);
 
 	return ovrTrue;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetBool(ovrHmd hmd, const char* propertyName, ovrBool defaultVal) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetBool " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_GetBool, propertyName);
 
-	return rev_GetBool((revSession)hmd->Handle, propertyName, defaultVal);
+	return rev_GetBool(hmd->Handle->session, propertyName, defaultVal);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetBool(ovrHmd hmd, const char* propertyName, ovrBool value) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetBool " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_SetBool, propertyName);
 
-	return rev_SetBool((revSession)hmd->Handle, propertyName, value);
+	return rev_SetBool(hmd->Handle->session, propertyName, value);
 }
 
 OVR_PUBLIC_FUNCTION(int) ovrHmd_GetInt(ovrHmd hmd, const char* propertyName, int defaultVal) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetInt " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_GetInt, propertyName);
 
-	return rev_GetInt((revSession)hmd->Handle, propertyName, defaultVal);
+	int value;
+	if (getWrapperInt(hmd->Handle, propertyName, &value) || getAsyncPresentInt(hmd->Handle->asyncPresent, propertyName, &value)) {
+		return value;
+	}
+
+	return rev_GetInt(hmd->Handle->session, propertyName, defaultVal);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetInt(ovrHmd hmd, const char* propertyName, int value) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetInt " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_SetInt, propertyName);
 
-	return rev_SetInt((revSession)hmd->Handle, propertyName, value);
+	return rev_SetInt(hmd->Handle->session, propertyName, value);
 }
 
 OVR_PUBLIC_FUNCTION(float) ovrHmd_GetFloat(ovrHmd hmd, const char* propertyName, float defaultVal) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFloat " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_GetFloat, propertyName);
 
 	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
 		float values[2];
-		rev_GetFloatArray((revSession)hmd->Handle,	REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
+		rev_GetFloatArray(hmd->Handle->session,	REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
 
 		return values[0] + values[1];
 	}
 
-	return rev_GetFloat((revSession)hmd->Handle, propertyName, defaultVal);
+	float value;
+	if (getAsyncPresentFloat(hmd->Handle->asyncPresent, propertyName, &value)) {
+		return value;
+	}
+
+	return rev_GetFloat(hmd->Handle->session, propertyName, defaultVal);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloat(ovrHmd hmd, const char* propertyName, float value) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetFloat " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_SetFloat, propertyName);
 
 	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
 		return ovrTrue;
@@ -615,54 +870,69 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloat(ovrHmd hmd, const char* propertyNam
 		return ovrTrue;
 	}	
 
-	return rev_SetFloat((revSession)hmd->Handle, propertyName, value);
+	return rev_SetFloat(hmd->Handle->session, propertyName, value);
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovrHmd_GetFloatArray(ovrHmd hmd, const char* propertyName,
 	float values[], unsigned int valuesCapacity) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFloatArray " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_GetFloatArray, propertyName);
+
+	if (strcmp(propertyName, WRAPPER_KEY_MOTION_TO_PHOTON) == 0) {
+		LatencyStats stats;
+
+		if (!latencyGetStats(&hmd->Handle->latency, &stats)) {
+			return 0;
+		}
+
+		float latency[3] = { (float)stats.minSeconds, (float)stats.meanSeconds, (float)stats.p99Seconds };
+		unsigned int count = valuesCapacity < 3 ? valuesCapacity : 3;
+
+		memcpy(values, latency, count * sizeof(float));
+
+		return count;
+	}
 
-	return rev_GetFloatArray((revSession)hmd->Handle, propertyName, values, valuesCapacity);
+	return rev_GetFloatArray(hmd->Handle->session, propertyName, values, valuesCapacity);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloatArray(ovrHmd hmd, const char* propertyName,
 	float values[], unsigned int arraySize) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetFloatArray " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_SetFloatArray, propertyName);
 
-	return rev_SetFloatArray((revSession)hmd->Handle, propertyName, values, arraySize);
+	return rev_SetFloatArray(hmd->Handle->session, propertyName, values, arraySize);
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovrHmd_GetString(ovrHmd hmd, const char* propertyName,
 	const char* defaultVal) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetString " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_GetString, propertyName);
 
-	return rev_GetString((revSession)hmd->Handle, propertyName, defaultVal);
+	return rev_GetString(hmd->Handle->session, propertyName, defaultVal);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetString(ovrHmd hmd, const char* propertyName,
 	const char* value) {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetString " << propertyName;
+	TRACE_EVENT_STR(ovrHmd_SetString, propertyName);
 
-	return rev_SetString((revSession)hmd->Handle, propertyName, value);
+	return rev_SetString(hmd->Handle->session, propertyName, value);
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_InitializeRenderingShim()
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_InitializeRenderingShim";
+	TRACE_EVENT(ovr_InitializeRenderingShim);
 
 	return ovrTrue;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_InitializeRenderingShimVersion(int requestedMinorVersion)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_InitializeRenderingShimVersion";
+	TRACE_EVENT(ovr_InitializeRenderingShimVersion);
 
 	return ovrTrue;
 }
 
 OVR_PUBLIC_FUNCTION(IUnknown *) ovr_GetDX11SwapChain()
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_GetDX11SwapChain";
+	TRACE_EVENT(ovr_GetDX11SwapChain);
 	return NULL;
 }
 
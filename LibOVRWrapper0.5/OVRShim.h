@@ -9,4 +9,6 @@
 #include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
 
 void copyPose(ovrPosef* dest, const revPosef* source);
-void copyPoseState(ovrPoseStatef* dest, const revPoseStatef* source);
\ No newline at end of file
+void copyPoseState(ovrPoseStatef* dest, const revPoseStatef* source);
+void getEyeTimewarpMatricesBothEyes(ovrHmd hmd, const ovrPosef renderPose[2], ovrMatrix4f twmOut[2][2]);
+void calcRenderScaleAndOffset(ovrFovPort fov, ovrSizei textureSize, ovrRecti renderViewport, ovrVector2f uvScaleOffsetOut[2]);
@@ -13,6 +13,8 @@
 #include "../LibOVR0.5/Include/OVR_CAPI_D3D.h"
 
 #include "shimhelper.h"
+#include "AsyncPresent.h"
+#include "../LibOVRWrapperShared/SwapChainMirror.h"
 
 revTextureFormat getOVRFormat(DXGI_FORMAT format) {
 	switch (format) {
@@ -89,29 +91,34 @@ struct OculusTexture
 	revSession            Session;
 	revTextureSwapChain   TextureChain;
 	ovrSizei                  size;	
+	DXGI_FORMAT               format; // of the application's texture
+	unsigned int              lastUse; // ovrHmdStruct::eyeTexturePoolUse when it last held an eye
+	SwapChainMirror           mirror;
 	std::vector<ID3D11Texture2D*> Tex2D;
 
 	OculusTexture() :
 		Session(nullptr),
-		TextureChain(nullptr)
+		TextureChain(nullptr),
+		format(DXGI_FORMAT_UNKNOWN),
+		lastUse(0)
 	{
 	}
 
-	bool Init(revSession session, ID3D11Device *device, ovrD3D11Texture texture)
+	bool Init(revSession session, ID3D11Device *device, ovrD3D11Texture texture, ovrSizei allocSize)
 	{
 		Session = session;
-		size.w = texture.D3D11.Header.TextureSize.w;
-		size.h = texture.D3D11.Header.TextureSize.h;
+		size = allocSize;
 
 		D3D11_TEXTURE2D_DESC orgdesc;
 		texture.D3D11.pTexture->GetDesc(&orgdesc);
+		format = orgdesc.Format;
 
 		revTextureSwapChainDesc desc = {};
 		desc.Type = revTexture_2D;
 		desc.ArraySize = 1;
 		desc.Format = getOVRFormat(orgdesc.Format);
-		desc.Width = texture.D3D11.Header.TextureSize.w;
-		desc.Height = texture.D3D11.Header.TextureSize.h;
+		desc.Width = size.w;
+		desc.Height = size.h;
 		desc.MipLevels = 1;
 		desc.SampleCount = 1;
 		desc.MiscFlags = 0;		
@@ -129,9 +136,8 @@ struct OculusTexture
 		if (!REV_SUCCESS(result))
 			return false;
 
-		int textureCount = 0;
-		rev_GetTextureSwapChainLength(Session, TextureChain, &textureCount);
-		for (int i = 0; i < textureCount; ++i)
+		swapChainMirrorInit(&mirror, Session, TextureChain);
+		for (int i = 0; i < mirror.length; ++i)
 		{
 			ID3D11Texture2D* tex = nullptr;
 			revResult r = rev_GetTextureSwapChainBufferDX(Session, TextureChain, i, IID_PPV_ARGS(&tex));
@@ -157,52 +163,52 @@ struct OculusTexture
 
 	ID3D11Texture2D* GetTex()
 	{
-		int index = 0;		
-		revResult r = rev_GetTextureSwapChainCurrentIndex(Session, TextureChain, &index);
-		if (r < 0) {
-			BOOST_LOG_TRIVIAL(error) << "GetTex rev_GetTextureSwapChainCurrentIndex error " << r;
-		}
-		return this->Tex2D[index];
+		return this->Tex2D[swapChainMirrorCurrentIndex(&mirror, Session, TextureChain)];
 	}
 
 	// Commit changes
 	void Commit()
 	{
-		revResult r = rev_CommitTextureSwapChain(Session, TextureChain);
+		revResult r = swapChainMirrorCommit(&mirror, Session, TextureChain);
 		if (r < 0) {
 			BOOST_LOG_TRIVIAL(error) << "Commit rev_CommitTextureSwapChain error " << r;
 		}
 	}
 };
 
-ovrD3D11Config			 cfg;
-ovrEyeRenderDesc		 EyeRenderDesc[2];
-unsigned int			 globalDistortionCaps;
-ovrFovPort				 eyeRenderFov[2];
-OculusTexture*           pEyeRenderTexture[2] = { nullptr, nullptr };
-ovrTexture*				 mirrorTexture = nullptr;
-
-ID3D11Texture2D*         BackBuffer;
+void hookPresent(ovrHmdStruct* state);
 
 // This gives us the D3D device, the mirror window's backbuffer render target, ovrDistortionCap_FlipInput, ovrDistortionCap_SRGB, ovrDistortionCap_HqDistortion,
 // and the desired FOV. But it doesn't officially give us the render texture size that we need for creating the textures.
-ovrBool ConfigureD3D11(revSession session, const ovrRenderAPIConfig* apiConfig, unsigned int distortionCaps,
+ovrBool ConfigureD3D11(ovrHmdStruct* state, const ovrRenderAPIConfig* apiConfig, unsigned int distortionCaps,
 	const ovrFovPort eyeFovIn[2], ovrEyeRenderDesc eyeRenderDescOut[2])
 {
-	cfg = *(ovrD3D11Config *)apiConfig;
-	globalDistortionCaps = distortionCaps;
+	state->cfg = *(ovrD3D11Config *)apiConfig;
+	state->distortionCaps = distortionCaps;
 	for (int eye = 0; eye < 2; eye++) {
-		eyeRenderFov[eye] = eyeFovIn[eye];
-		EyeRenderDesc[eye] = eyeRenderDescOut[eye];
+		state->eyeRenderFov[eye] = eyeFovIn[eye];
+		state->eyeRenderDesc[eye] = eyeRenderDescOut[eye];
+	}
+	if (state->backBuffer != nullptr) {
+		state->backBuffer->Release();
 	}
-	cfg.D3D11.pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&BackBuffer);
-	cfg.D3D11.pDevice->CreateRenderTargetView(BackBuffer, NULL, &cfg.D3D11.pBackBufferRT);
+	state->cfg.D3D11.pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), (void**)&state->backBuffer);
+	state->cfg.D3D11.pDevice->CreateRenderTargetView(state->backBuffer, NULL, &state->cfg.D3D11.pBackBufferRT);
+	state->backBufferCaptured = false;
+
+	if (globalAsyncPresentEnabled && state->asyncPresent == NULL) {
+		state->asyncPresent = asyncPresentStart(globalAsyncPresentPolicy, state->cfg.D3D11.pDevice);
+	}
+
+	hookPresent(state);
 
 	return ovrTrue;
 }
 
-ovrBool CreateMirrorTextureD3D11(revSession session, const ovrRecti* destMirrorRect, const ovrRecti* sourceRenderTargetRect)
+ovrBool CreateMirrorTextureD3D11(ovrHmdStruct* state, const ovrRecti* destMirrorRect, const ovrRecti* sourceRenderTargetRect)
 {
+	revSession session = state->session;
+
 	D3D11_TEXTURE2D_DESC td = {};
 	td.ArraySize = 1;
 	td.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
@@ -226,7 +232,7 @@ ovrBool CreateMirrorTextureD3D11(revSession session, const ovrRecti* destMirrorR
 		break;
 	}
 	revMirrorTexture* mirror = (revMirrorTexture*)malloc(sizeof(revMirrorTexture));
-	revResult result = rev_CreateMirrorTextureDX(session, (IUnknown*)cfg.D3D11.pDevice, &d, mirror);
+	revResult result = rev_CreateMirrorTextureDX(session, (IUnknown*)state->cfg.D3D11.pDevice, &d, mirror);
 	
 	if (!REV_SUCCESS(result)) {
 		revErrorInfo info;
@@ -253,7 +259,7 @@ ovrBool CreateMirrorTextureD3D11(revSession session, const ovrRecti* destMirrorR
 		depthSrv.Texture2D.MostDetailedMip = 0;
 		depthSrv.Texture2D.MipLevels = td.MipLevels;
 
-		rs = cfg.D3D11.pDevice->CreateShaderResourceView((ID3D11Resource*)ovrtext->D3D11.pTexture, &depthSrv, &(ovrtext->D3D11.pSRView));
+		rs = state->cfg.D3D11.pDevice->CreateShaderResourceView((ID3D11Resource*)ovrtext->D3D11.pTexture, &depthSrv, &(ovrtext->D3D11.pSRView));
 
 		if (rs < 0) {
 			BOOST_LOG_TRIVIAL(error) << "ovrHmd_CreateMirrorTextureD3D11 could not create ShaderResourceView";
@@ -265,48 +271,160 @@ ovrBool CreateMirrorTextureD3D11(revSession session, const ovrRecti* destMirrorR
 	ovrtext->D3D11.Header.TextureSize.w = d.Width;
 	ovrtext->D3D11.Header.TextureSize.h = d.Height;
 	
-	mirrorTexture = (ovrTexture*)ovrtext;
-
-	setMirror(mirror);
+	state->mirrorTexture = (ovrTexture*)ovrtext;
+	state->mirror = mirror;
 
 	return 1;
 }
 
-extern unsigned int globalFrameIndex;
-extern double globalTrackingStateTime;
+ovrSizei globalEyeTextureMaxSize = { 0, 0 };
+
+// With a maximum size configured, chains are allocated at least that large and the application's
+// texture is copied into their top left corner, the submitted viewport stays the same.
+bool eyeTextureFits(const OculusTexture* chain, ovrD3D11Texture texture, DXGI_FORMAT format) {
+	const ovrSizei* wanted = &texture.D3D11.Header.TextureSize;
+
+	if (chain->format != format) {
+		return false;
+	}
+
+	if (globalEyeTextureMaxSize.w > 0 && globalEyeTextureMaxSize.h > 0) {
+		return chain->size.w >= wanted->w && chain->size.h >= wanted->h;
+	}
+
+	return chain->size.w == wanted->w && chain->size.h == wanted->h;
+}
+
+// Chains that stop matching the eye texture are parked in a small per-session pool instead of being destroyed,
+// so applications with dynamic resolution switch between a few chains after warmup.
+void RecreateEyeRenderTexture(ovrHmdStruct* state, int eye, ovrD3D11Texture texture) {
+	OculusTexture** pEyeRenderTexture = state->eyeRenderTexture;
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture.D3D11.pTexture->GetDesc(&desc);
+
+	if (pEyeRenderTexture[eye] && eyeTextureFits(pEyeRenderTexture[eye], texture, desc.Format)) {
+		return;
+	}
+
+	state->eyeTexturePoolUse++;
+
+	OculusTexture* found = nullptr;
+	int slot = -1;
+
+	for (int i = 0;i < eyeTexturePoolSize;i++) {
+		OculusTexture* pooled = state->eyeTexturePool[i];
+
+		if (pooled != nullptr && eyeTextureFits(pooled, texture, desc.Format)) {
+			found = pooled;
+			slot = i;
+			break;
+		}
+	}
+
+	if (found != nullptr) {
+		state->eyeTexturePool[slot] = nullptr;
+		state->eyeTexturePoolHits++;
+	}
+
+	if (pEyeRenderTexture[eye]) {
+		//park the old chain in the free slot or the one of the least recently used chain
+		if (slot < 0) {
+			for (int i = 0;i < eyeTexturePoolSize;i++) {
+				if (state->eyeTexturePool[i] == nullptr) {
+					slot = i;
+					break;
+				}
+				if (slot < 0 || state->eyeTexturePool[i]->lastUse < state->eyeTexturePool[slot]->lastUse) {
+					slot = i;
+				}
+			}
+		}
+
+		if (state->eyeTexturePool[slot] != nullptr) {
+			//a queued frame may still reference the evicted chain
+			asyncPresentDrain(state->asyncPresent);
+			delete state->eyeTexturePool[slot];
+		}
 
-void RecreateEyeRenderTexture(revSession session, int eye, ovrD3D11Texture texture) {
-	bool dirty = false;
-	if (!pEyeRenderTexture[eye]) {
-		dirty = true;
-	} else if (pEyeRenderTexture[eye]->size.w != texture.D3D11.Header.TextureSize.w || pEyeRenderTexture[eye]->size.h != texture.D3D11.Header.TextureSize.h) {
-		delete pEyeRenderTexture[eye];
+		pEyeRenderTexture[eye]->lastUse = state->eyeTexturePoolUse;
+		state->eyeTexturePool[slot] = pEyeRenderTexture[eye];
 		pEyeRenderTexture[eye] = NULL;
-		dirty = true;
 	}
-	if (dirty) {
-		pEyeRenderTexture[eye] = new OculusTexture();
-		if (!pEyeRenderTexture[eye]->Init(session, cfg.D3D11.pDevice, texture))
+
+	if (found == nullptr) {
+		state->eyeTexturePoolMisses++;
+
+		ovrSizei allocSize = texture.D3D11.Header.TextureSize;
+
+		if (globalEyeTextureMaxSize.w > 0 && globalEyeTextureMaxSize.h > 0) {
+			allocSize.w = allocSize.w > globalEyeTextureMaxSize.w ? allocSize.w : globalEyeTextureMaxSize.w;
+			allocSize.h = allocSize.h > globalEyeTextureMaxSize.h ? allocSize.h : globalEyeTextureMaxSize.h;
+		}
+
+		//with the submit thread the runtime renders with its device, never with the application's
+		ID3D11Device* device = state->asyncPresent != NULL ? asyncPresentDevice(state->asyncPresent) : state->cfg.D3D11.pDevice;
+
+		found = new OculusTexture();
+		if (!found->Init(state->session, device, texture, allocSize))
 		{
 			// failed
 			BOOST_LOG_TRIVIAL(error) << "RecreateEyeRenderTexture Init error ";
 		}
 	}
+
+	pEyeRenderTexture[eye] = found;
 }
 
-void PresentD3D11(revSession session, const ovrPosef renderPose[2], const ovrTexture eyeTexture[2])
+// Copies the top left width x height of source into the chain's current buffer and commits it.
+// The context has to belong to the device the chain was created on.
+void CopyEyeRenderTexture(OculusTexture* chain, ID3D11DeviceContext* context, ID3D11Texture2D* source, int width, int height)
 {
-	ovrD3D11Texture* tex;
-	tex = (ovrD3D11Texture*)eyeTexture;
-	for (int eye = 0; eye < 2; ++eye)
+	ID3D11Texture2D *dest = chain->GetTex();
+	if (chain->size.w == width && chain->size.h == height) {
+		context->CopyResource(dest, source);
+	}
+	else {
+		D3D11_BOX box = { 0, 0, 0, (UINT)width, (UINT)height, 1 };
+		context->CopySubresourceRegion(dest, 0, 0, 0, 0, source, 0, &box);
+	}
+	chain->Commit();
+}
+
+// Copies the eye textures into their chains, or stages them with the submit thread.
+// Eyes side by side in one texture, like the SDK samples render them, share a chain and are copied once.
+AsyncPresentFrame* CaptureEyesD3D11(ovrHmdStruct* state, const ovrD3D11Texture tex[2])
+{
+	OculusTexture** pEyeRenderTexture = state->eyeRenderTexture;
+
+	//in block mode this waits for the previous frame to be taken before anything of this one is copied
+	AsyncPresentFrame* frame = state->asyncPresent != NULL ? asyncPresentBeginFrame(state->asyncPresent) : NULL;
+
+	int eyes = tex[0].D3D11.pTexture == tex[1].D3D11.pTexture ? 1 : 2;
+	for (int eye = 0; eye < eyes; ++eye)
 	{
-		RecreateEyeRenderTexture(session, eye, tex[eye]);
-		//CopyEyeRenderTexture
-		ID3D11Texture2D *dest = pEyeRenderTexture[eye]->GetTex();
-		cfg.D3D11.pDeviceContext->CopyResource(dest, tex[eye].D3D11.pTexture);		
-		pEyeRenderTexture[eye]->Commit();
+		RecreateEyeRenderTexture(state, eye, tex[eye]);
+
+		const ovrSizei* size = &tex[eye].D3D11.Header.TextureSize;
+		if (frame != NULL) {
+			//the submit thread copies it on into the chain
+			asyncPresentStageEye(state->asyncPresent, state->cfg.D3D11.pDeviceContext, eye, tex[eye].D3D11.pTexture, size->w, size->h);
+		}
+		else {
+			CopyEyeRenderTexture(pEyeRenderTexture[eye], state->cfg.D3D11.pDeviceContext, tex[eye].D3D11.pTexture, size->w, size->h);
+		}
 	}
 
+	return frame;
+}
+
+// Submits the eyes of CaptureEyesD3D11, or queues them with the submit thread
+void SubmitEyesD3D11(ovrHmdStruct* state, AsyncPresentFrame* frame, const ovrPosef renderPose[2], const ovrD3D11Texture tex[2])
+{
+	OculusTexture* chain[2];
+	chain[0] = state->eyeRenderTexture[0];
+	chain[1] = tex[0].D3D11.pTexture == tex[1].D3D11.pTexture ? chain[0] : state->eyeRenderTexture[1];
+
 	// Initialize our single full screen Fov layer.
 	revLayerHeader* layers[1];
 	revLayerEyeFov ld = {};
@@ -315,39 +433,216 @@ void PresentD3D11(revSession session, const ovrPosef renderPose[2], const ovrTex
 
 	for (int eye = 0; eye < 2; ++eye)
 	{
-		ld.ColorTexture[eye] = pEyeRenderTexture[eye]->TextureChain;
+		ld.ColorTexture[eye] = chain[eye]->TextureChain;
 		ld.Viewport[eye] = *(revRecti*)&tex[eye].D3D11.Header.RenderViewport;
-		ld.Fov[eye].DownTan = eyeRenderFov[eye].DownTan;
-		ld.Fov[eye].LeftTan = eyeRenderFov[eye].LeftTan;
-		ld.Fov[eye].RightTan = eyeRenderFov[eye].RightTan;
-		ld.Fov[eye].UpTan = eyeRenderFov[eye].UpTan;
+		ld.Fov[eye].DownTan = state->eyeRenderFov[eye].DownTan;
+		ld.Fov[eye].LeftTan = state->eyeRenderFov[eye].LeftTan;
+		ld.Fov[eye].RightTan = state->eyeRenderFov[eye].RightTan;
+		ld.Fov[eye].UpTan = state->eyeRenderFov[eye].UpTan;
 		ld.RenderPose[eye].Orientation = *(revQuatf*)&renderPose[eye].Orientation;
 		ld.RenderPose[eye].Position = *(revVector3f*)&renderPose[eye].Position;
-		ld.SensorSampleTime = globalTrackingStateTime;
+		ld.SensorSampleTime = state->trackingStateTime;
 	}
 
-	layers[0] = &ld.Header;
-	rev_SubmitFrame(session, globalFrameIndex, NULL, layers, 1);
+	if (frame != NULL) {
+		//a shared chain was only staged for the left eye, so it is copied and committed once
+		frame->session = state->session;
+		frame->frameIndex = state->frameIndex;
+		frame->hasLayer = true;
+		frame->layer = ld;
+		frame->eyeChain[0] = chain[0];
+		frame->eyeChain[1] = chain[1];
+
+		asyncPresentQueue(state->asyncPresent);
+	}
+	else {
+		layers[0] = &ld.Header;
+		rev_SubmitFrame(state->session, state->frameIndex, NULL, layers, 1);
+	}
+}
+
+void PresentD3D11(ovrHmdStruct* state, const ovrPosef renderPose[2], const ovrTexture eyeTexture[2])
+{
+	const ovrD3D11Texture* tex = (const ovrD3D11Texture*)eyeTexture;
+
+	AsyncPresentFrame* frame = CaptureEyesD3D11(state, tex);
+	SubmitEyesD3D11(state, frame, renderPose, tex);
 
 	// Render mirror
 #if 0
-	ovrD3D11Texture* tex2 = (ovrD3D11Texture*)mirrorTexture;
-	cfg.D3D11.pDeviceContext->CopyResource(BackBuffer, tex2->D3D11.pTexture);
-	cfg.D3D11.pSwapChain->Present(0, 0);
+	ovrD3D11Texture* tex2 = (ovrD3D11Texture*)state->mirrorTexture;
+	state->cfg.D3D11.pDeviceContext->CopyResource(state->backBuffer, tex2->D3D11.pTexture);
+	state->cfg.D3D11.pSwapChain->Present(0, 0);
 #endif
 }
 
-void GetMirrorTexture(ovrTexture** mirrorTex)
+// Client distortion: the back buffer the application distorted into holds the left eye in its left half
+// and the right eye in its right half, both are submitted from one chain with a viewport each.
+void backBufferEyeTextures(ovrHmdStruct* state, ovrD3D11Texture eyeTexture[2])
+{
+	D3D11_TEXTURE2D_DESC desc;
+	state->backBuffer->GetDesc(&desc);
+
+	for (int eye = 0; eye < 2; ++eye)
+	{
+		ZeroMemory(&eyeTexture[eye], sizeof(ovrD3D11Texture));
+		eyeTexture[eye].D3D11.Header.API = ovrRenderAPI_D3D11;
+		eyeTexture[eye].D3D11.Header.TextureSize.w = desc.Width;
+		eyeTexture[eye].D3D11.Header.TextureSize.h = desc.Height;
+		eyeTexture[eye].D3D11.Header.RenderViewport.Pos.x = eye == ovrEye_Left ? 0 : desc.Width / 2;
+		eyeTexture[eye].D3D11.Header.RenderViewport.Pos.y = 0;
+		eyeTexture[eye].D3D11.Header.RenderViewport.Size.w = desc.Width / 2;
+		eyeTexture[eye].D3D11.Header.RenderViewport.Size.h = desc.Height;
+		eyeTexture[eye].D3D11.pTexture = state->backBuffer;
+	}
+}
+
+// The first Present of a frame captures it, ovrHmd_EndFrameTiming submits it
+void CaptureBackBufferD3D11(ovrHmdStruct* state)
 {
-	*mirrorTex = mirrorTexture;
+	if (state->backBuffer == nullptr || state->backBufferCaptured) {
+		return;
+	}
+
+	ovrD3D11Texture eyeTexture[2];
+	backBufferEyeTextures(state, eyeTexture);
+
+	state->backBufferFrame = CaptureEyesD3D11(state, eyeTexture);
+	state->backBufferCaptured = true;
 }
 
-void ShutdownD3D11() {
+// Applications that call ovrHmd_EndFrameTiming before presenting have the back buffer captured here instead
+bool PresentBackBufferD3D11(ovrHmdStruct* state, const ovrPosef renderPose[2])
+{
+	if (state->backBuffer == nullptr) {
+		return false;
+	}
+
+	CaptureBackBufferD3D11(state);
+
+	ovrD3D11Texture eyeTexture[2];
+	backBufferEyeTextures(state, eyeTexture);
+
+	SubmitEyesD3D11(state, state->backBufferFrame, renderPose, eyeTexture);
+	state->backBufferCaptured = false;
+	state->backBufferFrame = NULL;
+
+	return true;
+}
+
+// IDXGISwapChain::Present of the swap chain handed to ovrHmd_ConfigureRendering is patched in its vtable,
+// so the back buffer is captured before it is presented. Afterwards a DXGI_SWAP_EFFECT_DISCARD or flip model
+// back buffer is undefined. The vtable is shared by every swap chain of the implementation, the others pass through.
+#define presentVtableIndex 8
+
+typedef HRESULT(STDMETHODCALLTYPE* PresentFunc)(IDXGISwapChain* swapChain, UINT syncInterval, UINT flags);
+
+SRWLOCK presentHookLock = SRWLOCK_INIT;
+ovrHmdStruct* presentHookState = NULL; // whose swap chain is captured, NULL passes every Present through
+void** presentHookVtable = NULL; // patched, NULL when nothing is
+PresentFunc presentOriginal = NULL; // kept after unpatching, a Present already in the hook still calls it
+
+HRESULT STDMETHODCALLTYPE presentHook(IDXGISwapChain* swapChain, UINT syncInterval, UINT flags)
+{
+	AcquireSRWLockShared(&presentHookLock);
+
+	PresentFunc original = presentOriginal;
+	ovrHmdStruct* state = presentHookState;
+
+	if (state != NULL && state->cfg.D3D11.pSwapChain == swapChain && (flags & DXGI_PRESENT_TEST) == 0) {
+		CaptureBackBufferD3D11(state);
+	}
+
+	ReleaseSRWLockShared(&presentHookLock);
+
+	return original(swapChain, syncInterval, flags);
+}
+
+bool patchVtable(void** vtable, void* function) {
+	DWORD protect;
+	if (!VirtualProtect(&vtable[presentVtableIndex], sizeof(void*), PAGE_READWRITE, &protect)) {
+		return false;
+	}
+
+	vtable[presentVtableIndex] = function;
+	VirtualProtect(&vtable[presentVtableIndex], sizeof(void*), protect, &protect);
+
+	return true;
+}
+
+// Called with presentHookLock held exclusively
+void unhookPresent() {
+	//when something else patched Present on top of the hook it stays, passing every Present through
+	if (presentHookVtable != NULL && presentHookVtable[presentVtableIndex] == (void*)presentHook) {
+		patchVtable(presentHookVtable, (void*)presentOriginal);
+	}
+
+	presentHookVtable = NULL;
+	presentHookState = NULL;
+}
+
+void hookPresent(ovrHmdStruct* state) {
+	void** vtable = *(void***)state->cfg.D3D11.pSwapChain;
+
+	AcquireSRWLockExclusive(&presentHookLock);
+
+	if (presentHookVtable != vtable) {
+		unhookPresent();
+
+		PresentFunc original = (PresentFunc)vtable[presentVtableIndex];
+		if (patchVtable(vtable, (void*)presentHook)) {
+			presentOriginal = original;
+			presentHookVtable = vtable;
+		}
+		else {
+			BOOST_LOG_TRIVIAL(error) << "ConfigureD3D11 could not hook Present, the back buffer is read at ovrHmd_EndFrameTiming";
+		}
+	}
+
+	presentHookState = presentHookVtable != NULL ? state : NULL;
+
+	ReleaseSRWLockExclusive(&presentHookLock);
+}
+
+void GetMirrorTexture(ovrHmdStruct* state, ovrTexture** mirrorTex)
+{
+	*mirrorTex = state->mirrorTexture;
+}
+
+void ShutdownD3D11(ovrHmdStruct* state) {
+	//waits for a Present capturing into the chains below
+	AcquireSRWLockExclusive(&presentHookLock);
+	if (presentHookState == state) {
+		unhookPresent();
+	}
+	ReleaseSRWLockExclusive(&presentHookLock);
+
+	//the submit thread has to be gone before the chains its frames reference
+	asyncPresentStop(state->asyncPresent);
+	state->asyncPresent = NULL;
 
 	for (int i = 0;i < 2;i++) {
-		if (pEyeRenderTexture[i] != nullptr) {
-			delete pEyeRenderTexture[i];
-			pEyeRenderTexture[i] = nullptr;
+		if (state->eyeRenderTexture[i] != nullptr) {
+			delete state->eyeRenderTexture[i];
+			state->eyeRenderTexture[i] = nullptr;
 		}
 	}
+
+	for (int i = 0;i < eyeTexturePoolSize;i++) {
+		if (state->eyeTexturePool[i] != nullptr) {
+			delete state->eyeTexturePool[i];
+			state->eyeTexturePool[i] = nullptr;
+		}
+	}
+
+	if (state->backBuffer != nullptr) {
+		state->backBuffer->Release();
+		state->backBuffer = nullptr;
+	}
+
+	if (state->mirror != nullptr) {
+		rev_DestroyMirrorTexture(state->session, *state->mirror);
+		free(state->mirror);
+		state->mirror = nullptr;
+	}
 }
\ No newline at end of file
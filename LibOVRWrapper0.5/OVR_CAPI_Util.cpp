@@ -42,7 +42,7 @@ limitations under the License.
 // Used to generate projection from ovrEyeDesc::Fov
 OVR_PUBLIC_FUNCTION(ovrMatrix4f) ovrMatrix4f_Projection(ovrFovPort fov, float znear, float zfar, unsigned int projectionModFlags)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrMatrix4f_Projection";
+	TRACE_EVENT(ovrMatrix4f_Projection);
 
     bool rightHanded    = (projectionModFlags & ovrProjection_RightHanded) > 0;
     bool flipZ          = (projectionModFlags & ovrProjection_FarLessThanNear) > 0;
@@ -56,7 +56,7 @@ OVR_PUBLIC_FUNCTION(ovrMatrix4f) ovrMatrix4f_Projection(ovrFovPort fov, float zn
 OVR_PUBLIC_FUNCTION(ovrMatrix4f) ovrMatrix4f_OrthoSubProjection(ovrMatrix4f projection, ovrVector2f orthoScale,
                                            float orthoDistance, float hmdToEyeViewOffsetX)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrMatrix4f_OrthoSubProjection";
+	TRACE_EVENT(ovrMatrix4f_OrthoSubProjection);
 
     ovrMatrix4f ortho;
     float orthoHorizontalOffset = hmdToEyeViewOffsetX / orthoDistance;
@@ -106,12 +106,32 @@ OVR_PUBLIC_FUNCTION(ovrMatrix4f) ovrMatrix4f_OrthoSubProjection(ovrMatrix4f proj
     return ortho;
 }
 
+// The SDK's CreateUVScaleAndOffsetfromNDCScaleandOffset for ovrHmd_GetRenderScaleAndOffset, except for the sign of the Y scale.
+// The SDK's meshes carry tan angles with Y down, the meshes of ovrHmd_CreateDistortionMesh carry them with Y up
+// like the timewarp matrices' basis, see Timewarp.h. Texture rows run down, so the Y scale is negated to map
+// the top of the fov (tan angle UpTan) to the top of the viewport. The offset is the SDK's.
+void calcRenderScaleAndOffset(ovrFovPort fov, ovrSizei textureSize, ovrRecti renderViewport, ovrVector2f uvScaleOffsetOut[2])
+{
+    OVR::ScaleAndOffset2D ndc = OVR::CreateNDCScaleAndOffsetFromFov(fov);
+
+    float scaleX = (float)renderViewport.Size.w / (float)textureSize.w;
+    float scaleY = (float)renderViewport.Size.h / (float)textureSize.h;
+    float offsetX = (float)renderViewport.Pos.x / (float)textureSize.w;
+    float offsetY = (float)renderViewport.Pos.y / (float)textureSize.h;
+
+    // [-1,1] NDC to [0,1] across the viewport, then into the texture
+    uvScaleOffsetOut[0].x = ndc.Scale.x * 0.5f * scaleX;
+    uvScaleOffsetOut[0].y = -ndc.Scale.y * 0.5f * scaleY;
+    uvScaleOffsetOut[1].x = (ndc.Offset.x * 0.5f + 0.5f) * scaleX + offsetX;
+    uvScaleOffsetOut[1].y = (ndc.Offset.y * 0.5f + 0.5f) * scaleY + offsetY;
+}
+
 
 void ovr_CalcEyePoses(ovrPosef headPose,
                       const ovrVector3f hmdToEyeViewOffset[2],
                       ovrPosef outEyePoses[2])
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_CalcEyePoses";
+	TRACE_EVENT(ovr_CalcEyePoses);
 
     if (!hmdToEyeViewOffset || !outEyePoses)
     {        
@@ -132,7 +152,7 @@ OVR_PUBLIC_FUNCTION(void) ovrHmd_GetEyePoses(ovrHmd hmd, unsigned int frameIndex
                         ovrPosef outEyePoses[2],
                         ovrTrackingState* outHmdTrackingState)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetEyePoses";
+	TRACE_EVENT(ovrHmd_GetEyePoses);
 
     ovrFrameTiming   ftiming = ovrHmd_GetFrameTiming(hmd, frameIndex);
     ovrTrackingState hmdState = ovrHmd_GetTrackingState(hmd, ftiming.ScanoutMidpointSeconds);
@@ -148,7 +168,7 @@ OVR_PUBLIC_FUNCTION(void) ovrHmd_GetEyePoses(ovrHmd hmd, unsigned int frameIndex
 
 OVR_PUBLIC_FUNCTION(double) ovr_WaitTillTime(double absTime)
 {
-	BOOST_LOG_TRIVIAL(trace) << "ovr_WaitTillTime";
+	TRACE_EVENT(ovr_WaitTillTime);
 
     double       initialTime = rev_GetTimeInSeconds();
     double       newTime     = initialTime;
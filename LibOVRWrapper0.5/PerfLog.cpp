@@ -0,0 +1,130 @@
+#include "stdafx.h"
+#include "PerfLog.h"
+
+#include <atomic>
+
+#define perfLogRingSize 1024 // records, must be a power of two
+#define perfLogWriterIntervalMs 50
+
+struct PerfLog_
+{
+	std::atomic<uint32_t> head; // next record the render thread writes
+	std::atomic<uint32_t> tail; // next record the writer reads
+	std::atomic<uint32_t> overflows; // frames lost because the ring was full
+	PerfLogRecord current; // frame between BeginFrame and EndFrame, only touched by the render thread
+	bool inFrame;
+	FILE* file;
+	HANDLE writerThread;
+	HANDLE stopEvent;
+	PerfLogRecord records[perfLogRingSize];
+};
+
+void perfLogDrain(PerfLog* log) {
+	uint32_t tail = log->tail.load(std::memory_order_relaxed);
+	uint32_t head = log->head.load(std::memory_order_acquire);
+
+	for (;tail != head;tail++) {
+		const PerfLogRecord* r = &log->records[tail & (perfLogRingSize - 1)];
+
+		fprintf(log->file, "%u,%.6f,%.6f,%.6f,%.6f,%u\n", r->frameIndex, r->beginSeconds, r->endSeconds,
+			r->predictedDisplaySeconds, r->submitSeconds, r->droppedFrames);
+	}
+
+	log->tail.store(tail, std::memory_order_release);
+
+	uint32_t overflows = log->overflows.exchange(0);
+
+	if (overflows > 0) {
+		fprintf(log->file, "# %u frames not logged\n", overflows);
+	}
+}
+
+DWORD WINAPI perfLogWriterMain(LPVOID param) {
+	PerfLog* log = (PerfLog*)param;
+
+	while (WaitForSingleObject(log->stopEvent, perfLogWriterIntervalMs) == WAIT_TIMEOUT) {
+		perfLogDrain(log);
+	}
+
+	return 0;
+}
+
+PerfLog* perfLogStart(const char* fileName, const char* userData) {
+	if (fileName == NULL) {
+		return NULL;
+	}
+
+	PerfLog* log = (PerfLog*)calloc(1, sizeof(PerfLog));
+
+	if (log == NULL) {
+		return NULL;
+	}
+
+	if (fopen_s(&log->file, fileName, "w") != 0) {
+		free(log);
+		return NULL;
+	}
+
+	fprintf(log->file, "# LibOVRWrapper perf log, userData: %s\n", userData != NULL ? userData : "");
+	fprintf(log->file, "frameIndex,beginSeconds,endSeconds,predictedDisplaySeconds,submitSeconds,droppedFrames\n");
+
+	log->stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	log->writerThread = CreateThread(NULL, 0, perfLogWriterMain, log, 0, NULL);
+
+	if (log->writerThread == NULL) {
+		BOOST_LOG_TRIVIAL(error) << "perfLogStart could not create the writer thread";
+		CloseHandle(log->stopEvent);
+		fclose(log->file);
+		free(log);
+		return NULL;
+	}
+
+	return log;
+}
+
+void perfLogStop(PerfLog* log) {
+	if (log == NULL) {
+		return;
+	}
+
+	SetEvent(log->stopEvent);
+	WaitForSingleObject(log->writerThread, INFINITE);
+
+	perfLogDrain(log);
+	fclose(log->file);
+
+	CloseHandle(log->writerThread);
+	CloseHandle(log->stopEvent);
+	free(log);
+}
+
+void perfLogBeginFrame(PerfLog* log, unsigned int frameIndex, double beginSeconds, double predictedDisplaySeconds) {
+	log->current.frameIndex = frameIndex;
+	log->current.beginSeconds = beginSeconds;
+	log->current.predictedDisplaySeconds = predictedDisplaySeconds;
+	log->inFrame = true;
+}
+
+void perfLogEndFrame(PerfLog* log, double endSeconds, double submitSeconds, unsigned int droppedFrames) {
+	//EndFrame without BeginFrame, the app does its own timing
+	if (!log->inFrame) {
+		return;
+	}
+
+	log->inFrame = false;
+
+	uint32_t head = log->head.load(std::memory_order_relaxed);
+
+	if (head - log->tail.load(std::memory_order_acquire) >= perfLogRingSize) {
+		log->overflows.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	PerfLogRecord* r = &log->records[head & (perfLogRingSize - 1)];
+	*r = log->current;
+	r->endSeconds = endSeconds;
+	r->submitSeconds = submitSeconds;
+	r->droppedFrames = droppedFrames;
+
+	log->head.store(head + 1, std::memory_order_release);
+}
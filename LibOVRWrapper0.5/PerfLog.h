@@ -0,0 +1,22 @@
+#pragma once
+
+// Per-frame performance log behind ovrHmd_StartPerfLog / ovrHmd_StopPerfLog.
+// The render thread fills records into a preallocated single producer ring and never waits,
+// frames that find the ring full are only counted. A writer thread streams the ring as CSV.
+
+typedef struct PerfLogRecord_
+{
+	unsigned int frameIndex;
+	unsigned int droppedFrames; // frames that missed their vsync since the session was created
+	double beginSeconds; // ovrHmd_BeginFrame
+	double endSeconds; // ovrHmd_EndFrame returned
+	double predictedDisplaySeconds;
+	double submitSeconds; // spent presenting inside ovrHmd_EndFrame
+} PerfLogRecord;
+
+typedef struct PerfLog_ PerfLog;
+
+PerfLog* perfLogStart(const char* fileName, const char* userData);
+void perfLogStop(PerfLog* log);
+void perfLogBeginFrame(PerfLog* log, unsigned int frameIndex, double beginSeconds, double predictedDisplaySeconds);
+void perfLogEndFrame(PerfLog* log, double endSeconds, double submitSeconds, unsigned int droppedFrames);
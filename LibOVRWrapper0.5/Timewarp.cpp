@@ -0,0 +1,63 @@
+#if !defined(OVR_DLL_BUILD)
+	#define OVR_DLL_BUILD
+#endif
+
+#include "Timewarp.h"
+
+ovrQuatf quatMultiply(const ovrQuatf* a, const ovrQuatf* b) {
+	ovrQuatf r;
+
+	r.w = a->w * b->w - a->x * b->x - a->y * b->y - a->z * b->z;
+	r.x = a->w * b->x + a->x * b->w + a->y * b->z - a->z * b->y;
+	r.y = a->w * b->y - a->x * b->z + a->y * b->w + a->z * b->x;
+	r.z = a->w * b->z + a->x * b->y - a->y * b->x + a->z * b->w;
+
+	return r;
+}
+
+ovrVector3f quatRotate(const ovrQuatf* q, const ovrVector3f* v) {
+	//q * v * conjugate(q), with v as a pure quaternion
+	ovrQuatf p = { v->x, v->y, v->z, 0.0f };
+	ovrQuatf inverse = { -q->x, -q->y, -q->z, q->w };
+	ovrQuatf qp = quatMultiply(q, &p);
+	ovrQuatf r = quatMultiply(&qp, &inverse);
+
+	ovrVector3f out = { r.x, r.y, r.z };
+	return out;
+}
+
+void calcTimewarpMatrix(const ovrQuatf* renderOrientation, const ovrQuatf* predictedOrientation, ovrMatrix4f* out) {
+	//inverse of a unit quaternion is its conjugate
+	ovrQuatf fromEye = { -renderOrientation->x, -renderOrientation->y, -renderOrientation->z, renderOrientation->w };
+	ovrQuatf q = quatMultiply(&fromEye, predictedOrientation);
+
+	float ww = q.w * q.w, xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+
+	out->M[0][0] = ww + xx - yy - zz;
+	out->M[0][1] = 2.0f * (q.x * q.y - q.w * q.z);
+	out->M[0][2] = 2.0f * (q.x * q.z + q.w * q.y);
+	out->M[1][0] = 2.0f * (q.x * q.y + q.w * q.z);
+	out->M[1][1] = ww - xx + yy - zz;
+	out->M[1][2] = 2.0f * (q.y * q.z - q.w * q.x);
+	out->M[2][0] = 2.0f * (q.x * q.z - q.w * q.y);
+	out->M[2][1] = 2.0f * (q.y * q.z + q.w * q.x);
+	out->M[2][2] = ww - xx - yy + zz;
+
+	//tracking space is X right, Y up, Z back, the mesh works in X right, Y up, Z forward.
+	//flipping the Z row and column leaves only the Z row and column outside the diagonal negated
+	out->M[0][2] = -out->M[0][2];
+	out->M[1][2] = -out->M[1][2];
+	out->M[2][0] = -out->M[2][0];
+	out->M[2][1] = -out->M[2][1];
+
+	out->M[0][3] = out->M[1][3] = out->M[2][3] = 0.0f;
+	out->M[3][0] = out->M[3][1] = out->M[3][2] = 0.0f;
+	out->M[3][3] = 1.0f;
+}
+
+void calcTimewarpMatricesBothEyes(const ovrQuatf renderOrientation[2], const ovrQuatf predicted[3], ovrMatrix4f twmOut[2][2]) {
+	for (int eye = 0;eye < 2;eye++) {
+		calcTimewarpMatrix(&renderOrientation[eye], &predicted[eye], &twmOut[eye][0]);
+		calcTimewarpMatrix(&renderOrientation[eye], &predicted[eye + 1], &twmOut[eye][1]);
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
+
+// Orientation timewarp matrices for ovrHmd_GetEyeTimewarpMatrices.
+// The matrix rotates from the orientation the eye was rendered with to the predicted one,
+// in the basis of the distortion mesh's TanEyeAngles (X right, Y up, Z forward).
+// Only math on the orientations handed in, so it builds without the rest of the shim.
+
+ovrQuatf quatMultiply(const ovrQuatf* a, const ovrQuatf* b);
+ovrVector3f quatRotate(const ovrQuatf* q, const ovrVector3f* v);
+
+void calcTimewarpMatrix(const ovrQuatf* renderOrientation, const ovrQuatf* predictedOrientation, ovrMatrix4f* out);
+
+// Both eyes in one pass. predicted holds the orientations at the start of the left eye's scanout,
+// at the switch to the right eye and at the end of the right eye's scanout.
+void calcTimewarpMatricesBothEyes(const ovrQuatf renderOrientation[2], const ovrQuatf predicted[3], ovrMatrix4f twmOut[2][2]);
@@ -0,0 +1,95 @@
+// TraceDecode.cpp : Prints a LibOVRWrapper.trace written by the 0.5 shim as text.
+//
+// Standalone console tool, build with: cl /EHsc TraceDecode.cpp
+// Usage: TraceDecode [LibOVRWrapper.trace]
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../TraceEvents.h"
+
+struct TraceEventInfo
+{
+	const char* name;
+	traceArgKind args;
+};
+
+const TraceEventInfo traceEventInfo[] = {
+#define X(name, args) { #name, args },
+	LIBOVRWRAPPER_TRACE_EVENTS(X)
+#undef X
+};
+
+int main(int argc, char* argv[])
+{
+	const char* filename = argc > 1 ? argv[1] : "LibOVRWrapper.trace";
+
+	FILE* file = fopen(filename, "rb");
+
+	if (file == NULL) {
+		fprintf(stderr, "could not open %s\n", filename);
+		return 1;
+	}
+
+	TraceFileHeader header;
+
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+		fprintf(stderr, "%s is not a LibOVRWrapper trace\n", filename);
+		fclose(file);
+		return 1;
+	}
+
+	if (header.version != TRACE_FILE_VERSION || header.recordSize != sizeof(TraceRecord)) {
+		fprintf(stderr, "unsupported trace version %u\n", header.version);
+		fclose(file);
+		return 1;
+	}
+
+	TraceRecord record;
+	uint64_t first = 0;
+	bool haveFirst = false;
+
+	//records are grouped per thread, so timestamps only increase within a thread
+	while (fread(&record, sizeof(record), 1, file) == 1) {
+		if (!haveFirst || record.timestamp < first) {
+			first = record.timestamp;
+			haveFirst = true;
+		}
+	}
+
+	fseek(file, sizeof(header), SEEK_SET);
+
+	while (fread(&record, sizeof(record), 1, file) == 1) {
+		double ms = (double)(record.timestamp - first) * 1000.0 / (double)header.ticksPerSecond;
+
+		if (record.eventId >= traceEvent_Count) {
+			printf("%12.3f %6u unknown event %u\n", ms, record.threadId, record.eventId);
+			continue;
+		}
+
+		const TraceEventInfo& info = traceEventInfo[record.eventId];
+
+		switch (info.args) {
+		case traceArgs_Int:
+			printf("%12.3f %6u %s %llu\n", ms, record.threadId, info.name, (unsigned long long)record.arg0);
+			break;
+		case traceArgs_String:
+			{
+				char str[sizeof(record.arg0) + sizeof(record.arg1) + 1] = {};
+				memcpy(str, &record.arg0, sizeof(record.arg0));
+				memcpy(str + sizeof(record.arg0), &record.arg1, sizeof(record.arg1));
+
+				printf("%12.3f %6u %s %s\n", ms, record.threadId, info.name, str);
+			}
+			break;
+		default:
+			printf("%12.3f %6u %s\n", ms, record.threadId, info.name);
+			break;
+		}
+	}
+
+	fclose(file);
+
+	return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// Binary trace format shared by the shim's tracer and the TraceDecode tool.
+// Only depends on stdint.h so the decoder can be built without the shim's headers.
+
+#include <stdint.h>
+
+enum traceArgKind
+{
+	traceArgs_None,
+	traceArgs_Int, // arg0 is an integer
+	traceArgs_String // arg0 and arg1 hold the first 16 characters of a string
+};
+
+// Every traced entry point. New events are only ever appended so old traces still decode.
+#define LIBOVRWRAPPER_TRACE_EVENTS(X) \
+	X(ovr_Initialize, traceArgs_None) \
+	X(ovr_Shutdown, traceArgs_None) \
+	X(ovr_GetVersionString, traceArgs_None) \
+	X(ovr_TraceMessage, traceArgs_None) \
+	X(ovrHmd_StartPerfLog, traceArgs_None) \
+	X(ovrHmd_StopPerfLog, traceArgs_None) \
+	X(ovrHmd_CreateDebug, traceArgs_None) \
+	X(ovrHmd_GetLastError, traceArgs_None) \
+	X(ovrHmd_Detect, traceArgs_None) \
+	X(ovrHmd_Create, traceArgs_None) \
+	X(ovrHmd_AttachToWindow, traceArgs_None) \
+	X(ovrHmd_Destroy, traceArgs_None) \
+	X(ovrHmd_GetEnabledCaps, traceArgs_None) \
+	X(ovrHmd_SetEnabledCaps, traceArgs_None) \
+	X(ovrHmd_ConfigureTracking, traceArgs_None) \
+	X(ovrHmd_RecenterPose, traceArgs_None) \
+	X(ovrHmd_GetTrackingState, traceArgs_None) \
+	X(ovrHmd_GetFovTextureSize, traceArgs_None) \
+	X(ovrHmd_ConfigureRendering, traceArgs_None) \
+	X(ovrHmd_BeginFrame, traceArgs_Int) \
+	X(ovrHmd_EndFrame, traceArgs_None) \
+	X(ovrHmd_BeginFrameTiming, traceArgs_None) \
+	X(ovrHmd_EndFrameTiming, traceArgs_None) \
+	X(ovrHmd_GetHmdPosePerEye, traceArgs_None) \
+	X(ovrHmd_GetRenderDesc, traceArgs_None) \
+	X(ovrHmd_CreateDistortionMesh, traceArgs_None) \
+	X(ovrHmd_CreateDistortionMeshDebug, traceArgs_None) \
+	X(ovrHmd_AddDistortionTimeMeasurement, traceArgs_None) \
+	X(ovrHmd_DestroyDistortionMesh, traceArgs_None) \
+	X(ovrHmd_RegisterPostDistortionCallback, traceArgs_None) \
+	X(ovrHmd_GetRenderScaleAndOffset, traceArgs_None) \
+	X(ovrHmd_GetFrameTiming, traceArgs_Int) \
+	X(ovrHmd_ResetFrameTiming, traceArgs_None) \
+	X(ovrHmd_GetEyeTimewarpMatrices, traceArgs_None) \
+	X(ovrHmd_GetEyeTimewarpMatricesDebug, traceArgs_None) \
+	X(ovr_GetTimeInSeconds, traceArgs_None) \
+	X(ovrHmd_ProcessLatencyTest, traceArgs_None) \
+	X(ovrHmd_GetLatencyTestResult, traceArgs_None) \
+	X(ovrHmd_GetLatencyTest2DrawColor, traceArgs_None) \
+	X(ovrHmd_GetLatencyTestDrawColor, traceArgs_None) \
+	X(ovrHmd_GetMeasuredLatencyTest2, traceArgs_None) \
+	X(ovrHmd_GetHSWDisplayState, traceArgs_None) \
+	X(ovrHmd_DismissHSWDisplay, traceArgs_None) \
+	X(ovrHmd_GetBool, traceArgs_String) \
+	X(ovrHmd_SetBool, traceArgs_String) \
+	X(ovrHmd_GetInt, traceArgs_String) \
+	X(ovrHmd_SetInt, traceArgs_String) \
+	X(ovrHmd_GetFloat, traceArgs_String) \
+	X(ovrHmd_SetFloat, traceArgs_String) \
+	X(ovrHmd_GetFloatArray, traceArgs_String) \
+	X(ovrHmd_SetFloatArray, traceArgs_String) \
+	X(ovrHmd_GetString, traceArgs_String) \
+	X(ovrHmd_SetString, traceArgs_String) \
+	X(ovr_InitializeRenderingShim, traceArgs_None) \
+	X(ovr_InitializeRenderingShimVersion, traceArgs_None) \
+	X(ovr_GetDX11SwapChain, traceArgs_None) \
+	X(ovrMatrix4f_Projection, traceArgs_None) \
+	X(ovrMatrix4f_OrthoSubProjection, traceArgs_None) \
+	X(ovr_CalcEyePoses, traceArgs_None) \
+	X(ovrHmd_GetEyePoses, traceArgs_None) \
+	X(ovr_WaitTillTime, traceArgs_None) \
+	X(ovrHmd_ConfigureRenderingUnsupportedApi, traceArgs_Int) \
+	X(TraceRecordsDropped, traceArgs_Int) \
+	X(AsyncPresentSubmit, traceArgs_Int) \
+	X(AsyncPresentDropped, traceArgs_Int)
+
+enum traceEventId
+{
+#define X(name, args) traceEvent_##name,
+	LIBOVRWRAPPER_TRACE_EVENTS(X)
+#undef X
+	traceEvent_Count
+};
+
+#define TRACE_FILE_MAGIC "OVRTRACE"
+#define TRACE_FILE_VERSION 1
+
+typedef struct TraceFileHeader_
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t ticksPerSecond; // QueryPerformanceFrequency of the traced machine
+} TraceFileHeader;
+
+typedef struct TraceRecord_
+{
+	uint64_t timestamp; // QueryPerformanceCounter ticks
+	uint32_t threadId;
+	uint32_t eventId;
+	uint64_t arg0;
+	uint64_t arg1;
+} TraceRecord;
@@ -0,0 +1,237 @@
+#include "stdafx.h"
+#include "TraceLog.h"
+
+#include <atomic>
+
+#define traceRingSize 2048 // records per thread, must be a power of two
+#define traceWriterIntervalMs 10
+
+// Single producer (the owning thread), single consumer (the writer thread)
+typedef struct TraceRing_
+{
+	std::atomic<uint32_t> head; // next slot the owner writes
+	std::atomic<uint32_t> tail; // next slot the writer reads
+	std::atomic<uint32_t> dropped; // records lost because the ring was full
+	uint32_t threadId;
+	struct TraceRing_* next;
+	TraceRecord records[traceRingSize];
+} TraceRing;
+
+volatile bool globalTraceEnabled = false;
+
+std::atomic<TraceRing*> globalTraceRings(nullptr);
+thread_local TraceRing* threadTraceRing = nullptr;
+
+FILE* traceFile = NULL;
+HANDLE traceWriterThread = NULL;
+HANDLE traceStopEvent = NULL;
+CRITICAL_SECTION traceDrainLock;
+
+TraceRing* getThreadRing() {
+	if (threadTraceRing != nullptr) {
+		return threadTraceRing;
+	}
+
+	TraceRing* ring = (TraceRing*)calloc(1, sizeof(TraceRing));
+
+	if (ring == NULL) {
+		return NULL;
+	}
+
+	ring->threadId = GetCurrentThreadId();
+
+	//rings stay registered after their thread exits so nothing written is lost
+	TraceRing* first = globalTraceRings.load();
+	do {
+		ring->next = first;
+	} while (!globalTraceRings.compare_exchange_weak(first, ring));
+
+	threadTraceRing = ring;
+
+	return ring;
+}
+
+extern "C" void traceWrite(uint32_t eventId, uint64_t arg0, uint64_t arg1) {
+	TraceRing* ring = getThreadRing();
+
+	if (ring == NULL) {
+		return;
+	}
+
+	uint32_t head = ring->head.load(std::memory_order_relaxed);
+
+	if (head - ring->tail.load(std::memory_order_acquire) >= traceRingSize) {
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	TraceRecord* record = &ring->records[head & (traceRingSize - 1)];
+	record->timestamp = now.QuadPart;
+	record->threadId = ring->threadId;
+	record->eventId = eventId;
+	record->arg0 = arg0;
+	record->arg1 = arg1;
+
+	ring->head.store(head + 1, std::memory_order_release);
+}
+
+extern "C" void traceWriteString(uint32_t eventId, const char* str) {
+	uint64_t args[2] = { 0, 0 };
+
+	if (str != NULL) {
+		strncpy_s((char*)args, sizeof(args), str, _TRUNCATE);
+	}
+
+	traceWrite(eventId, args[0], args[1]);
+}
+
+void drainRings() {
+	for (TraceRing* ring = globalTraceRings.load();ring != NULL;ring = ring->next) {
+		uint32_t dropped = ring->dropped.exchange(0);
+
+		if (dropped > 0) {
+			TraceRecord record = {};
+			LARGE_INTEGER now;
+			QueryPerformanceCounter(&now);
+
+			record.timestamp = now.QuadPart;
+			record.threadId = ring->threadId;
+			record.eventId = traceEvent_TraceRecordsDropped;
+			record.arg0 = dropped;
+
+			fwrite(&record, sizeof(record), 1, traceFile);
+		}
+
+		uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+		uint32_t head = ring->head.load(std::memory_order_acquire);
+
+		while (tail != head) {
+			//write up to the end of the buffer, a wrapped range takes a second pass
+			uint32_t start = tail & (traceRingSize - 1);
+			uint32_t count = head - tail;
+
+			if (count > traceRingSize - start) {
+				count = traceRingSize - start;
+			}
+
+			fwrite(&ring->records[start], sizeof(TraceRecord), count, traceFile);
+
+			tail += count;
+		}
+
+		ring->tail.store(tail, std::memory_order_release);
+	}
+}
+
+DWORD WINAPI traceWriterMain(LPVOID) {
+	while (WaitForSingleObject(traceStopEvent, traceWriterIntervalMs) == WAIT_TIMEOUT) {
+		EnterCriticalSection(&traceDrainLock);
+		if (traceFile != NULL) {
+			drainRings();
+		}
+		LeaveCriticalSection(&traceDrainLock);
+	}
+
+	return 0;
+}
+
+extern "C" bool traceStart(const char* filename) {
+	if (fopen_s(&traceFile, filename, "wb") != 0) {
+		traceFile = NULL;
+		return false;
+	}
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+
+	TraceFileHeader header = {};
+	memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+	header.version = TRACE_FILE_VERSION;
+	header.recordSize = sizeof(TraceRecord);
+	header.ticksPerSecond = frequency.QuadPart;
+
+	fwrite(&header, sizeof(header), 1, traceFile);
+
+	InitializeCriticalSection(&traceDrainLock);
+	traceStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	traceWriterThread = CreateThread(NULL, 0, traceWriterMain, NULL, 0, NULL);
+
+	globalTraceEnabled = true;
+
+	return true;
+}
+
+extern "C" void traceFlush() {
+	if (traceFile == NULL) {
+		return;
+	}
+
+	EnterCriticalSection(&traceDrainLock);
+	drainRings();
+	fflush(traceFile);
+	LeaveCriticalSection(&traceDrainLock);
+}
+
+// Called from ovr_Shutdown, outside the loader lock, so the writer thread can be waited for.
+// The application has no other thread inside the API by then, so the rings are no longer written and can be freed.
+// Tracing stays off for the rest of the process.
+extern "C" void traceShutdown() {
+	if (traceFile == NULL) {
+		return;
+	}
+
+	globalTraceEnabled = false;
+	SetEvent(traceStopEvent);
+	WaitForSingleObject(traceWriterThread, INFINITE);
+
+	CloseHandle(traceWriterThread);
+	CloseHandle(traceStopEvent);
+	traceWriterThread = NULL;
+	traceStopEvent = NULL;
+
+	drainRings();
+	fclose(traceFile);
+	traceFile = NULL;
+
+	TraceRing* ring = globalTraceRings.exchange(nullptr);
+	while (ring != NULL) {
+		TraceRing* next = ring->next;
+		free(ring);
+		ring = next;
+	}
+
+	//the other threads' pointers dangle, but with tracing off they never write again
+	threadTraceRing = nullptr;
+
+	DeleteCriticalSection(&traceDrainLock);
+}
+
+// Called from DllMain, only does anything when the application never called ovr_Shutdown.
+// The writer thread is never waited for: it cannot exit while we hold the loader lock.
+// When the process is terminating the writer may have been killed inside the drain, then the tail of the trace is lost.
+extern "C" void traceStop(bool processTerminating) {
+	if (traceFile == NULL) {
+		return;
+	}
+
+	globalTraceEnabled = false;
+	SetEvent(traceStopEvent);
+
+	if (processTerminating) {
+		if (!TryEnterCriticalSection(&traceDrainLock)) {
+			return;
+		}
+	}
+	else {
+		EnterCriticalSection(&traceDrainLock);
+	}
+
+	drainRings();
+	fclose(traceFile);
+	traceFile = NULL;
+
+	LeaveCriticalSection(&traceDrainLock);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "TraceEvents.h"
+
+// Binary event tracer for the per-call logging of the shim.
+// Each thread appends fixed size records to its own ring buffer without locking,
+// a background thread drains the rings into a binary file that TraceDecode turns into text.
+// While tracing is off a TRACE_EVENT costs a single test of globalTraceEnabled,
+// building with LIBOVRWRAPPER_DISABLE_TRACE removes the calls completely.
+
+#ifdef __cplusplus
+#define EXTERNC extern "C"
+#else
+#define EXTERNC
+#endif
+
+extern volatile bool globalTraceEnabled;
+
+EXTERNC bool traceStart(const char* filename);
+EXTERNC void traceFlush();
+EXTERNC void traceShutdown();
+EXTERNC void traceStop(bool processTerminating);
+EXTERNC void traceWrite(uint32_t eventId, uint64_t arg0, uint64_t arg1);
+EXTERNC void traceWriteString(uint32_t eventId, const char* str);
+
+#undef EXTERNC
+
+#ifdef LIBOVRWRAPPER_DISABLE_TRACE
+#define TRACE_EVENT(name) do {} while (0)
+#define TRACE_EVENT1(name, arg) do {} while (0)
+#define TRACE_EVENT_STR(name, str) do {} while (0)
+#else
+#define TRACE_EVENT(name) \
+	do { if (globalTraceEnabled) traceWrite(traceEvent_##name, 0, 0); } while (0)
+#define TRACE_EVENT1(name, arg) \
+	do { if (globalTraceEnabled) traceWrite(traceEvent_##name, (uint64_t)(arg), 0); } while (0)
+#define TRACE_EVENT_STR(name, str) \
+	do { if (globalTraceEnabled) traceWriteString(traceEvent_##name, str); } while (0)
+#endif
@@ -1,5 +1,7 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
 #include "stdafx.h"
+#include "AsyncPresent.h"
+#include "shimhelper.h"
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/ini_parser.hpp>
@@ -14,6 +16,7 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 	case DLL_PROCESS_ATTACH:
 		{
 			int loglevel = 0;
+			bool textlog = true;
 			const char inifile[] = "LibOVRWrapper.ini";
 
 			boost::shared_ptr<sinks::synchronous_sink<sinks::text_file_backend>> sink = nullptr;
@@ -24,7 +27,15 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 					boost::property_tree::ini_parser::read_ini(inifile, pt);
 
 					loglevel = pt.get<int>("logging.loglevel", 0);
-					if (loglevel > 0) {
+					textlog = pt.get<bool>("logging.textlog", true);
+
+					globalAsyncPresentEnabled = pt.get<bool>("rendering.asyncPresent", false);
+					globalAsyncPresentPolicy = pt.get<std::string>("rendering.asyncPresentPolicy", "block") == "dropOldest" ?
+						asyncPresentPolicy_DropOldest : asyncPresentPolicy_Block;
+
+					globalEyeTextureMaxSize.w = pt.get<int>("rendering.eyeTextureMaxWidth", 0);
+					globalEyeTextureMaxSize.h = pt.get<int>("rendering.eyeTextureMaxHeight", 0);
+					if (loglevel > 0 && textlog) {
 						sink = logging::add_file_log(
 							keywords::file_name = "LibOVRWrapper.log", 
 							keywords::auto_flush = true
@@ -43,6 +54,15 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 			else if (loglevel > 3)
 				loglevel = 3;
 			
+			//per-call trace events go to the binary trace, the text log only gets the rest
+			if (loglevel == 3) {
+				traceStart("LibOVRWrapper.trace");
+			}
+
+			if (!textlog) {
+				loglevel = 0;
+			}
+
 			switch (loglevel) {
 			case 0:
 				logging::core::get()->set_logging_enabled(false);
@@ -70,9 +90,12 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 			BOOST_LOG_TRIVIAL(info) << "Initialized logging";			
 		}		
 		break;
+	case DLL_PROCESS_DETACH:
+		//ovr_Shutdown already stopped the trace, unless the application never called it
+		traceStop(lpReserved != NULL);
+		break;
 	case DLL_THREAD_ATTACH:
 	case DLL_THREAD_DETACH:
-	case DLL_PROCESS_DETACH:
 		break;
 	}
 	return TRUE;
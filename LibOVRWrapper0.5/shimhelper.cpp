@@ -5,17 +5,29 @@
 
 #include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
 #include "../LibOVR0.5/Include/OVR_CAPI_D3D.h"
-revMirrorTexture* globalMirror;
 extern "C" HRESULT wrapCreateShaderResourceView(ID3D11Device* device, ID3D11Resource* resource, ID3D11ShaderResourceView** srv) {
 	return device->CreateShaderResourceView(resource, NULL, srv);
 }
 
-extern "C"  void setMirror(revMirrorTexture* mirror)
-{
-	globalMirror = mirror;
+extern "C" void initChains() {
 }
 
-extern "C" void initChains() {
+extern "C" bool getWrapperInt(ovrHmdStruct* state, const char* propertyName, int* value) {
+	unsigned int* counter;
+
+	if (strcmp(propertyName, WRAPPER_KEY_EYE_TEXTURE_POOL_HITS) == 0) {
+		counter = &state->eyeTexturePoolHits;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_EYE_TEXTURE_POOL_MISSES) == 0) {
+		counter = &state->eyeTexturePoolMisses;
+	}
+	else {
+		return false;
+	}
+
+	*value = (int)*counter;
+
+	return true;
 }
 
 extern "C" void CopyTexture(ID3D11DeviceContext* device, ID3D11Texture2D* dest, ovrTexture* src) {
@@ -4,6 +4,10 @@
 #include "d3d11.h"
 
 #include "../LibOVR0.5/Include/OVR_CAPI_0_5_0.h"
+#include "../LibOVR0.5/Include/OVR_CAPI_D3D.h"
+
+#include "FrameTiming.h"
+#include "LatencyEstimator.h"
 
 #ifdef __cplusplus
 #define EXTERNC extern "C"
@@ -19,19 +23,91 @@ typedef struct ovrTextureSwapChainWrapper_
 	ID3D11DeviceContext* pContext;	
 } ovrTextureSwapChainWrapper;
 
+struct OculusTexture;
+typedef struct PerfLog_ PerfLog;
+typedef struct AsyncPresent_ AsyncPresent;
+typedef struct AsyncPresentFrame_ AsyncPresentFrame;
+
+#define ovrSessionStateAlignment 64 // one cache line
+#define eyeTexturePoolSize 4 // idle eye texture chains kept per session
+
+// Read only float array of the motion-to-photon latency min, mean and p99 in seconds, served by ovrHmd_GetFloatArray
+#define WRAPPER_KEY_MOTION_TO_PHOTON "LibOVRWrapper.MotionToPhoton"
+
+// Read only counters of eye texture chain lookups answered from the pool and allocations, served by ovrHmd_GetInt
+#define WRAPPER_KEY_EYE_TEXTURE_POOL_HITS "LibOVRWrapper.EyeTexturePoolHits"
+#define WRAPPER_KEY_EYE_TEXTURE_POOL_MISSES "LibOVRWrapper.EyeTexturePoolMisses"
+
+// Per-session state, allocated in ovrHmd_Create and released in ovrHmd_Destroy.
+// The application only sees it as the opaque ovrHmdDesc::Handle.
+// What every frame touches comes first so it shares the leading cache lines, the rendering setup follows.
+struct alignas(ovrSessionStateAlignment) ovrHmdStruct
+{
+	revSession session;
+	unsigned int frameIndex; // of the last ovrHmd_BeginFrame
+	uint32_t lastCameraFrameCounter;
+	double trackingStateTime; // when the app last sampled the tracking state, submitted as SensorSampleTime
+	float refreshRate;
+	SRWLOCK frameTimingLock; // ovrHmd_GetFrameTiming may be called from other threads than the frame loop
+	FrameTimingEstimator frameTiming;
+	PerfLog* perfLog; // set between ovrHmd_StartPerfLog and ovrHmd_StopPerfLog
+	double predictedDisplayTime; // of the frame begun last, 0 before the first ovrHmd_BeginFrame
+	LatencyEstimator latency;
+	char latencyResult[128]; // returned by ovrHmd_GetLatencyTestResult
+
+	// head poses predicted for each eye's scanout, handed out by ovrHmd_GetHmdPosePerEye until the next frame begins
+	ovrPosef hmdPosePerEye[2];
+	bool hmdPosePerEyeValid[2];
+
+	// head orientations predicted for the scanout of the current frame, see predictScanoutOrientations
+	double timewarpTimes[3];
+	ovrQuatf timewarpOrientations[3];
+	bool timewarpValid;
+
+	// matrices of both eyes for the render orientations below, see getEyeTimewarpMatricesBothEyes
+	ovrQuatf timewarpRenderOrientations[2];
+	ovrMatrix4f timewarpMatrices[2][2];
+	bool timewarpMatricesValid;
+
+	AsyncPresent* asyncPresent; // the submit thread when rendering.asyncPresent is set, NULL presents synchronously
+	revGraphicsLuid graphicsLuid;
+	HWND mirrorWindow; // of ovrHmd_AttachToWindow
+	bool disableMirror; // ovrHmdCap_NoMirrorToWindow
+
+	ovrD3D11Config cfg;
+	unsigned int distortionCaps;
+	ovrFovPort eyeRenderFov[2];
+	ovrEyeRenderDesc eyeRenderDesc[2]; // of the last ovrHmd_ConfigureRendering
+	OculusTexture* eyeRenderTexture[2];
+	OculusTexture* eyeTexturePool[eyeTexturePoolSize]; // chains not held by an eye, NULL when free
+	unsigned int eyeTexturePoolUse; // advanced on every chain switch, orders the pool by last use
+	unsigned int eyeTexturePoolHits;
+	unsigned int eyeTexturePoolMisses;
+	revMirrorTexture* mirror;
+	ovrTexture* mirrorTexture;
+	ID3D11Texture2D* backBuffer;
+	bool backBufferCaptured; // by the Present hook since the last ovrHmd_EndFrameTiming, see CaptureBackBufferD3D11
+	AsyncPresentFrame* backBufferFrame; // the capture was staged in, NULL without the submit thread
+};
+
+// Size eye texture chains are allocated at, the largest the application renders at.
+// Smaller textures are copied into a corner, 0 allocates at the application's texture size.
+extern ovrSizei globalEyeTextureMaxSize;
+
 EXTERNC HRESULT wrapCreateShaderResourceView(ID3D11Device* device, ID3D11Resource* resource, ID3D11ShaderResourceView** srv);
 EXTERNC void initChains();
-EXTERNC void setMirror(revMirrorTexture* mirror);
-EXTERNC revMirrorTexture* getMirror();
+EXTERNC bool getWrapperInt(ovrHmdStruct* state, const char* propertyName, int* value);
 EXTERNC void GetContext(ID3D11Device* device, ID3D11DeviceContext** context);
 EXTERNC void CopyTexture(ID3D11DeviceContext* device, ID3D11Texture2D* dest, ovrTexture* src);
  
-ovrBool ConfigureD3D11(revSession session, const ovrRenderAPIConfig* apiConfig, unsigned int distortionCaps,
+ovrBool ConfigureD3D11(ovrHmdStruct* state, const ovrRenderAPIConfig* apiConfig, unsigned int distortionCaps,
 	const ovrFovPort eyeFovIn[2], ovrEyeRenderDesc eyeRenderDescOut[2]);
-ovrBool CreateMirrorTextureD3D11(revSession session, const ovrRecti* destMirrorRect, const ovrRecti* sourceRenderTargetRect);
-void PresentD3D11(revSession session, const ovrPosef renderPose[2], const ovrTexture eyeTexture[2]);
-void ShutdownD3D11();
+ovrBool CreateMirrorTextureD3D11(ovrHmdStruct* state, const ovrRecti* destMirrorRect, const ovrRecti* sourceRenderTargetRect);
+void CopyEyeRenderTexture(OculusTexture* chain, ID3D11DeviceContext* context, ID3D11Texture2D* source, int width, int height);
+void PresentD3D11(ovrHmdStruct* state, const ovrPosef renderPose[2], const ovrTexture eyeTexture[2]);
+bool PresentBackBufferD3D11(ovrHmdStruct* state, const ovrPosef renderPose[2]);
+void ShutdownD3D11(ovrHmdStruct* state);
 
-void GetMirrorTexture(ovrTexture** mirrorTex);
+void GetMirrorTexture(ovrHmdStruct* state, ovrTexture** mirrorTex);
 
 #undef EXTERNC
\ No newline at end of file
@@ -43,6 +43,8 @@ namespace expr = boost::log::expressions;
 namespace attrs = boost::log::attributes;
 namespace keywords = boost::log::keywords;
 
+#include "TraceLog.h"
+
 
 #include "../LibREV/Include/REV_CAPI.h"
 #include "../LibREV/Include/REV_Version.h"
@@ -33,8 +33,6 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params) {
 		oldLogCallback = params->LogCallback;
 	}
 
-	initChains();
-
 	//TODO: handle ovrInit_ServerOptional ?
 
 	return rev_Initialize(&p);
@@ -43,6 +41,8 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params) {
 OVR_PUBLIC_FUNCTION(void) ovr_Shutdown() {
 	BOOST_LOG_TRIVIAL(trace) << "ovr_Shutdown";
 
+	flushAllPropertyCaches();
+
 	rev_Shutdown();
 }
 
@@ -139,6 +139,16 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_Create(int index, ovrHmd* pHmd) {
 	d->EyeRenderOrder[0] = ovrEye_Left;
 	d->EyeRenderOrder[1] = ovrEye_Right;
 
+	ovrSessionState* state = createSessionState(pSession);
+
+	if (state == NULL) {
+		rev_Destroy(pSession);
+
+		return ovrError_MemoryAllocationFailure;
+	}
+
+	state->defaultHmdCaps = desc.DefaultHmdCaps;
+
 	rev_SetTrackingOriginType(pSession, revTrackingOrigin_EyeLevel);
 
 	*pHmd = d;
@@ -149,16 +159,25 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_Create(int index, ovrHmd* pHmd) {
 OVR_PUBLIC_FUNCTION(void) ovrHmd_Destroy(ovrHmd hmd) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_Destroy";
 
+	destroySessionState((revSession)hmd->Handle);
+
 	rev_Destroy((revSession)hmd->Handle);
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovrHmd_GetEnabledCaps(ovrHmd hmd) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetEnabledCaps";
 
-	revHmdDesc desc = rev_GetHmdDesc((revSession)hmd->Handle);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+
+	if (state == NULL) {
+		return rev_GetHmdDesc((revSession)hmd->Handle).DefaultHmdCaps;
+	}
 
 	//not possible anymore
-	return desc.DefaultHmdCaps;
+	unsigned int caps = state->defaultHmdCaps;
+	releaseSessionState(state);
+
+	return caps;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovrHmd_SetEnabledCaps(ovrHmd hmd, unsigned int hmdCaps) {
@@ -177,6 +196,14 @@ OVR_PUBLIC_FUNCTION(void) ovrHmd_RecenterPose(ovrHmd hmd) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_RecenterPose";
 
 	rev_RecenterTrackingOrigin((revSession)hmd->Handle);
+
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+
+	if (state != NULL) {
+		invalidateTrackingSnapshots(state);
+	}
+
+	releaseSessionState(state);
 }
 
 void copyPose(ovrPosef* dest, const revPosef* source) {
@@ -204,6 +231,18 @@ uint32_t globalLastCameraFrameCounter = 0;
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovrHmd_GetTrackingState(ovrHmd hmd, double absTime) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetTrackingState";
 
+	ovrSessionState* sessionState = acquireSessionState((revSession)hmd->Handle);
+
+	if (sessionState != NULL) {
+		ovrTrackingState snapshot;
+
+		if (findTrackingSnapshot(sessionState, absTime, &snapshot)) {
+			releaseSessionState(sessionState);
+
+			return snapshot;
+		}
+	}
+
 	revTrackingState state = rev_GetTrackingState((revSession)hmd->Handle, absTime, ovrTrue);
 	revTrackerPose tpose = rev_GetTrackerPose((revSession)hmd->Handle, 0);	
 	
@@ -240,6 +279,12 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovrHmd_GetTrackingState(ovrHmd hmd, double
 	
 	globalTrackingStateTime = rev_GetTimeInSeconds();
 
+	if (sessionState != NULL) {
+		storeTrackingSnapshot(sessionState, absTime, &r);
+	}
+
+	releaseSessionState(sessionState);
+
 	return r;
 }
 
@@ -306,18 +351,17 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovrHmd_GetRenderDesc(ovrHmd hmd,
 	return r;
 }
 
-revTextureSwapChain renderChain(revSession session, ovrSwapTextureSet* ts)
+revTextureSwapChain renderChain(ovrSessionState* state, ovrSwapTextureSet* ts)
 {
-	ovrTextureSwapChainWrapper* chainwrapper = getChain(session, ts);
-
-	int currentIndex = 0;
-	rev_GetTextureSwapChainCurrentIndex(session, chainwrapper->swapChain, &currentIndex);
+	SwapChainCommitResult result = commitChain(state->session, ts, state->submitSerial);
 
-	CopyTexture(chainwrapper->pContext, chainwrapper->textures[currentIndex], &ts->Textures[ts->CurrentIndex]);	
-	
-	rev_CommitTextureSwapChain(session, chainwrapper->swapChain);
+	if (result == swapChainCommitCopied) {
+		state->copiesDone++;
+	} else if (result == swapChainCommitSkipped) {
+		state->copiesSkipped++;
+	}
 
-	return chainwrapper->swapChain;
+	return getChain(state->session, ts)->swapChain;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frameIndex,
@@ -327,6 +371,17 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frame
 
 	//ovrLayerType 2, 6 do not exists anymore. max layer count is 16 instead of 32
 
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+
+	if (state == nullptr) {
+		return ovrError_InvalidParameter;
+	}
+
+	//every call commits a set once, however many of its layers show it; 0 is kept for sets that were never committed
+	if (++state->submitSerial == 0) {
+		state->submitSerial = 1;
+	}
+
 	unsigned int trueLayerCount = 0;
 	for (unsigned int i = 0;i < layerCount;i++) {
 		if (layerPtrList[i] != nullptr) {
@@ -355,11 +410,11 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frame
 
 			//if both eyes use same swaptextureset
 			if (oldelayer->ColorTexture[0] == oldelayer->ColorTexture[1]) {
-				elayer->ColorTexture[0] = renderChain((revSession)hmd->Handle, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
 				elayer->ColorTexture[1] = elayer->ColorTexture[0];
 			} else {
-				elayer->ColorTexture[0] = renderChain((revSession)hmd->Handle, oldelayer->ColorTexture[0]);
-				elayer->ColorTexture[1] = renderChain((revSession)hmd->Handle, oldelayer->ColorTexture[1]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[1] = renderChain(state, oldelayer->ColorTexture[1]);
 			}		
 			
 			elayer->Fov[0].DownTan = oldelayer->Fov[0].DownTan;
@@ -390,7 +445,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frame
 			elayer->Header.Type = revLayerType_Quad;
 			elayer->Header.Flags = layer->Flags;
 
-			elayer->ColorTexture = renderChain((revSession)hmd->Handle, oldelayer->ColorTexture);
+			elayer->ColorTexture = renderChain(state, oldelayer->ColorTexture);
 			
 			copyPoseR(&elayer->QuadPoseCenter, &oldelayer->QuadPoseCenter);
 
@@ -406,7 +461,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frame
 			elayer->Header.Flags = layer->Flags;
 			elayer->Header.Flags |= revLayerFlag_HeadLocked;
 
-			elayer->ColorTexture = renderChain((revSession)hmd->Handle, oldelayer->ColorTexture);
+			elayer->ColorTexture = renderChain(state, oldelayer->ColorTexture);
 
 			copyPoseR(&elayer->QuadPoseCenter, &oldelayer->QuadPoseCenter);
 
@@ -435,6 +490,14 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_SubmitFrame(ovrHmd hmd, unsigned int frame
 	
 	ovrResult r = rev_SubmitFrame((revSession)hmd->Handle, frameIndex, (const revViewScaleDesc*)viewScaleDesc, newlayers, trueLayerCount);
 
+	//tracking snapshots are only shared between queries made for the same frame
+	advanceTrackingFrame(state);
+
+	//pending property writes of the frame reach the runtime in one go
+	propertyCacheFlush(&state->properties, (revSession)hmd->Handle);
+
+	releaseSessionState(state);
+
 	for (unsigned int i = 0;i < trueLayerCount;i++) {
 		if(newlayers[i] != nullptr)
 			free(newlayers[i]);
@@ -472,38 +535,67 @@ OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds() {
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_GetBool(ovrHmd hmd, const char* propertyName, ovrBool defaultVal) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetBool " << propertyName;
 
-	return rev_GetBool((revSession)hmd->Handle, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheGetBool(getPropertyCache(state), (revSession)hmd->Handle, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetBool(ovrHmd hmd, const char* propertyName, ovrBool value) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetBool " << propertyName;
 
-	return rev_SetBool((revSession)hmd->Handle, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheSetBool(getPropertyCache(state), (revSession)hmd->Handle, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(int) ovrHmd_GetInt(ovrHmd hmd, const char* propertyName, int defaultVal) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetInt " << propertyName;
 
-	return rev_GetInt((revSession)hmd->Handle, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	int value;
+
+	if (!getWrapperInt(state, propertyName, &value)) {
+		value = propertyCacheGetInt(getPropertyCache(state), (revSession)hmd->Handle, propertyName, defaultVal);
+	}
+
+	releaseSessionState(state);
+
+	return value;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetInt(ovrHmd hmd, const char* propertyName, int value) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetInt " << propertyName;
 
-	return rev_SetInt((revSession)hmd->Handle, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheSetInt(getPropertyCache(state), (revSession)hmd->Handle, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(float) ovrHmd_GetFloat(ovrHmd hmd, const char* propertyName, float defaultVal) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFloat " << propertyName;
 
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	float r;
+
 	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
 		float values[2];
-		rev_GetFloatArray((revSession)hmd->Handle, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
+		propertyCacheGetFloatArray(getPropertyCache(state), (revSession)hmd->Handle, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
 
-		return values[0] + values[1];
+		r = values[0] + values[1];
+	}
+	else {
+		r = propertyCacheGetFloat(getPropertyCache(state), (revSession)hmd->Handle, propertyName, defaultVal);
 	}
 
-	return rev_GetFloat((revSession)hmd->Handle, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloat(ovrHmd hmd, const char* propertyName, float value) {
@@ -515,35 +607,55 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloat(ovrHmd hmd, const char* propertyNam
 		return ovrTrue;
 	}	
 
-	return rev_SetFloat((revSession)hmd->Handle, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheSetFloat(getPropertyCache(state), (revSession)hmd->Handle, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovrHmd_GetFloatArray(ovrHmd hmd, const char* propertyName,
 	float values[], unsigned int valuesCapacity) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetFloatArray " << propertyName;
 
-	return rev_GetFloatArray((revSession)hmd->Handle, propertyName, values, valuesCapacity);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	unsigned int r = propertyCacheGetFloatArray(getPropertyCache(state), (revSession)hmd->Handle, propertyName, values, valuesCapacity);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetFloatArray(ovrHmd hmd, const char* propertyName,
 	const float values[], unsigned int valuesSize) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetFloatArray " << propertyName;
 
-	return rev_SetFloatArray((revSession)hmd->Handle, propertyName, values, valuesSize);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheSetFloatArray(getPropertyCache(state), (revSession)hmd->Handle, propertyName, values, valuesSize);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovrHmd_GetString(ovrHmd hmd, const char* propertyName,
 	const char* defaultVal) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_GetString " << propertyName;
 
-	return rev_GetString((revSession)hmd->Handle, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	const char* r = propertyCacheGetString(getPropertyCache(state), (revSession)hmd->Handle, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovrHmd_SetString(ovrHmd hmd, const char* propertyName,
 	const char* value) {
 	BOOST_LOG_TRIVIAL(trace) << "ovrHmd_SetString " << propertyName;
 
-	return rev_SetString((revSession)hmd->Handle, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)hmd->Handle);
+	ovrBool r = propertyCacheSetString(getPropertyCache(state), (revSession)hmd->Handle, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_InitializeRenderingShimVersion(int requestedMinorVersion)
@@ -150,25 +150,34 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_CreateSwapTextureSetD3D11(ovrHmd hmd,
 	
 	d.StaticImage = ovrFalse;
 
-	ovrTextureSwapChainWrapper* chainwrapper = (ovrTextureSwapChainWrapper*)malloc(sizeof(ovrTextureSwapChainWrapper));
+	ovrTextureSwapChainWrapper* chainwrapper;
+	ovrSwapTextureSet* ts = createChain((revSession)hmd->Handle, &chainwrapper);
+
+	if (ts == nullptr) {
+		BOOST_LOG_TRIVIAL(error) << "ovrHmd_CreateSwapTextureSetD3D11 could not allocate SwapTextureSet";
+		return ovrError_MemoryAllocationFailure;
+	}
+
 	device->GetImmediateContext(&chainwrapper->pContext);
 
 	ovrResult result = rev_CreateTextureSwapChainDX((revSession)hmd->Handle, (IUnknown*)device, &d, &chainwrapper->swapChain);
 
 	if (!OVR_SUCCESS(result)) {
 		BOOST_LOG_TRIVIAL(error) << "ovrHmd_CreateSwapTextureSetD3D11 could not create TextureSwapChain";
+		removeChain((revSession)hmd->Handle, ts);
 		return result;
 	}
-	
-	ovrSwapTextureSet* ts = (ovrSwapTextureSet*)malloc(sizeof(ovrSwapTextureSet));
-
-	setChain((revSession)hmd->Handle, ts, chainwrapper);
 
-	rev_GetTextureSwapChainLength((revSession)hmd->Handle, chainwrapper->swapChain, &chainwrapper->textureCount);
+	swapChainMirrorInit(&chainwrapper->mirror, (revSession)hmd->Handle, chainwrapper->swapChain);
+	chainwrapper->textureCount = chainwrapper->mirror.length;
 
 	chainwrapper->textures = (ID3D11Texture2D**)calloc(chainwrapper->textureCount, sizeof(ID3D11Texture2D*));
 
-	ts->TextureCount = 2;
+	//zero copy mode hands the rev buffers to the application directly; typeless buffers would not match the requested format
+	swapChainCommitInit(&chainwrapper->commit, chainwrapper->textureCount,
+		getWrapperSettings()->swapTextureAliasingEnabled && !(d.MiscFlags & revTextureMisc_DX_Typeless));
+
+	ts->TextureCount = chainwrapper->commit.aliased ? chainwrapper->textureCount : 2;
 	ts->CurrentIndex = 0;	
 	ts->Textures = (ovrTexture*)calloc(ts->TextureCount, sizeof(ovrD3D11Texture));
 
@@ -181,14 +190,19 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_CreateSwapTextureSetD3D11(ovrHmd hmd,
 		}
 	}
 
-	for (int i = 0;i < 2;i++) {
+	for (int i = 0;i < ts->TextureCount;i++) {
 		ovrD3D11Texture* ovrtext = (ovrD3D11Texture*)&ts->Textures[i];
 
-		HRESULT hr = device->CreateTexture2D(&descClone, nullptr, &ovrtext->D3D11.pTexture);
+		if (chainwrapper->commit.aliased) {
+			ovrtext->D3D11.pTexture = chainwrapper->textures[i];
+			ovrtext->D3D11.pTexture->AddRef();
+		} else {
+			HRESULT hr = device->CreateTexture2D(&descClone, nullptr, &ovrtext->D3D11.pTexture);
 
-		if (hr < 0) {
-			BOOST_LOG_TRIVIAL(error) << "ovrHmd_CreateSwapTextureSetD3D11 could create texture";
-			return ovrError_ServiceError;
+			if (hr < 0) {
+				BOOST_LOG_TRIVIAL(error) << "ovrHmd_CreateSwapTextureSetD3D11 could create texture";
+				return ovrError_ServiceError;
+			}
 		}
 
 		if (makeShaderView) {
@@ -213,6 +227,10 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovrHmd_CreateSwapTextureSetD3D11(ovrHmd hmd,
 		ovrtext->D3D11.Header.TextureSize.w = d.Width;
 		ovrtext->D3D11.Header.TextureSize.h = d.Height;
 	}
+
+	if (chainwrapper->commit.aliased) {
+		syncAliasedIndex((revSession)hmd->Handle, ts);
+	}
 	
 	*outTextureSet = ts;	
 
@@ -4,6 +4,12 @@
 
 WrapperSettings::WrapperSettings(): 
 	srgbCorrectionEnabled(true), 
+	swapTextureAliasingEnabled(false), 
+	skipUnchangedSwapTextures(false), 
+	trackingSnapshotsEnabled(true), 
+	trackingSnapshotTolerance(0.0), 
+	propertyCacheEnabled(true), 
+	propertyCacheLifetimeMs(1000), 
 	loglevel(0)
 {
 }
@@ -3,6 +3,12 @@ class WrapperSettings
 {
 public:
 	bool srgbCorrectionEnabled;
+	bool swapTextureAliasingEnabled;
+	bool skipUnchangedSwapTextures; //off by default, stale frames are shown by applications that reuse CurrentIndex for new content
+	bool trackingSnapshotsEnabled;
+	double trackingSnapshotTolerance; //seconds, absTime values this close share a snapshot
+	bool propertyCacheEnabled;
+	unsigned int propertyCacheLifetimeMs; //milliseconds a fetched property is served from the cache, 0 for the whole session
 	int loglevel;
 
 	WrapperSettings();
@@ -35,6 +35,12 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 						
 					}
 					settings->srgbCorrectionEnabled = pt.get<bool>("graphics.srgbCorrectionEnabled", true);
+					settings->swapTextureAliasingEnabled = pt.get<bool>("graphics.swapTextureAliasingEnabled", false);
+					settings->skipUnchangedSwapTextures = pt.get<bool>("graphics.skipUnchangedSwapTextures", false);
+					settings->trackingSnapshotsEnabled = pt.get<bool>("tracking.snapshotsEnabled", true);
+					settings->trackingSnapshotTolerance = pt.get<double>("tracking.snapshotToleranceUs", 0.0) / 1000000.0;
+					settings->propertyCacheEnabled = pt.get<bool>("properties.cacheEnabled", true);
+					settings->propertyCacheLifetimeMs = pt.get<unsigned int>("properties.cacheLifetimeMs", 1000);
 
 				}
 				catch (boost::property_tree::ini_parser_error) {
@@ -1,6 +1,6 @@
 #include "stdafx.h"
-#include <unordered_map>
 #include "d3d11.h"
+#include <math.h>
 #include "shimhelper.h"
 
 #include "../LibOVR0.6/Include/OVR_CAPI_0_6_0.h"
@@ -10,7 +10,6 @@ extern "C" HRESULT wrapCreateShaderResourceView(ID3D11Device* device, ID3D11Reso
 	return device->CreateShaderResourceView(resource, NULL, srv);
 }
 
-std::unordered_map<ovrSwapTextureSet*, ovrTextureSwapChainWrapper*> *swapchains;
 revMirrorTexture* globalMirror;
 WrapperSettings* globalWrapperSettings;
 
@@ -21,6 +20,103 @@ void setWrapperSettings(WrapperSettings* settings) {
 	globalWrapperSettings = settings;
 }
 
+extern "C" PropertyCache* getPropertyCache(ovrSessionState* state) {
+	return state != NULL ? &state->properties : NULL;
+}
+
+extern "C" bool getWrapperInt(ovrSessionState* state, const char* propertyName, int* value) {
+	if (state == NULL) {
+		return false;
+	}
+
+	//the tracking counters are changed with interlocked increments, reading one is atomic
+	if (strcmp(propertyName, WRAPPER_KEY_COPIES_DONE) == 0) {
+		*value = (int)state->copiesDone;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_COPIES_SKIPPED) == 0) {
+		*value = (int)state->copiesSkipped;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_TRACKING_HITS) == 0) {
+		*value = (int)state->trackingHits;
+	}
+	else if (strcmp(propertyName, WRAPPER_KEY_TRACKING_MISSES) == 0) {
+		*value = (int)state->trackingMisses;
+	}
+	else {
+		return false;
+	}
+
+	return true;
+}
+
+extern "C" bool findTrackingSnapshot(ovrSessionState* state, double absTime, ovrTrackingState* outState) {
+	WrapperSettings* settings = getWrapperSettings();
+
+	//absTime 0 asks for the current time, which moves between calls
+	if (!settings->trackingSnapshotsEnabled || absTime <= 0.0) {
+		return false;
+	}
+
+	bool found = false;
+
+	//the snapshot is copied out under the lock, another thread may be storing into the same slot.
+	//lookups only read, so queries from several threads don't wait on each other
+	AcquireSRWLockShared(&state->trackingLock);
+
+	for (int i = 0;i < ovrTrackingSnapshotCount;i++) {
+		ovrTrackingSnapshot* snapshot = &state->snapshots[i];
+
+		if (snapshot->valid && snapshot->frame == state->trackingFrame &&
+			fabs(snapshot->absTime - absTime) <= settings->trackingSnapshotTolerance) {
+			*outState = snapshot->state;
+			found = true;
+			break;
+		}
+	}
+
+	ReleaseSRWLockShared(&state->trackingLock);
+
+	InterlockedIncrement(found ? &state->trackingHits : &state->trackingMisses);
+
+	return found;
+}
+
+extern "C" void storeTrackingSnapshot(ovrSessionState* state, double absTime, const ovrTrackingState* trackingState) {
+	if (!getWrapperSettings()->trackingSnapshotsEnabled || absTime <= 0.0) {
+		return;
+	}
+
+	AcquireSRWLockExclusive(&state->trackingLock);
+
+	ovrTrackingSnapshot* snapshot = &state->snapshots[state->nextSnapshot];
+	state->nextSnapshot = (state->nextSnapshot + 1) % ovrTrackingSnapshotCount;
+
+	snapshot->absTime = absTime;
+	snapshot->frame = state->trackingFrame;
+	snapshot->state = *trackingState;
+	snapshot->valid = true;
+
+	ReleaseSRWLockExclusive(&state->trackingLock);
+}
+
+extern "C" void advanceTrackingFrame(ovrSessionState* state) {
+	AcquireSRWLockExclusive(&state->trackingLock);
+	state->trackingFrame++;
+	ReleaseSRWLockExclusive(&state->trackingLock);
+}
+
+extern "C" void invalidateTrackingSnapshots(ovrSessionState* state) {
+	if (state != NULL) {
+		AcquireSRWLockExclusive(&state->trackingLock);
+
+		for (int i = 0;i < ovrTrackingSnapshotCount;i++) {
+			state->snapshots[i].valid = false;
+		}
+
+		ReleaseSRWLockExclusive(&state->trackingLock);
+	}
+}
+
 extern "C" void setMirror(revMirrorTexture* mirror) {
 	globalMirror = mirror;
 }
@@ -29,20 +125,208 @@ extern "C" revMirrorTexture* getMirror() {
 	return globalMirror;
 }
 
-extern "C" void initChains() {
-	swapchains = new std::unordered_map<ovrSwapTextureSet*, ovrTextureSwapChainWrapper*>();
+//the D3D11 side of a commit, buffers are copied on the chain's context and the ring index is kept by the mirror
+class D3D11SwapChainDevice : public SwapChainDevice
+{
+public:
+	D3D11SwapChainDevice(revSession session, ovrSwapTextureSet* ts) : session(session), ts(ts), chain(getChain(session, ts)) {}
+
+	virtual int currentIndex() {
+		return swapChainMirrorCurrentIndex(&chain->mirror, session, chain->swapChain);
+	}
+
+	virtual void copy(int bufferIndex, int textureIndex) {
+		CopyTexture(chain->pContext, chain->textures[bufferIndex], &ts->Textures[textureIndex]);
+	}
+
+	virtual void commit() {
+		swapChainMirrorCommit(&chain->mirror, session, chain->swapChain);
+	}
+
+private:
+	revSession session;
+	ovrSwapTextureSet* ts;
+	ovrTextureSwapChainWrapper* chain;
+};
+
+extern "C" void syncAliasedIndex(revSession session, ovrSwapTextureSet* ts) {
+	D3D11SwapChainDevice device(session, ts);
+
+	ts->CurrentIndex = swapChainAliasedIndex(&getChain(session, ts)->commit, &device);
 }
 
-extern "C" void removeChain(revSession session, ovrSwapTextureSet* ts) {
-	swapchains->erase(ts);
+extern "C" SwapChainCommitResult commitChain(revSession session, ovrSwapTextureSet* ts, unsigned int submitSerial) {
+	D3D11SwapChainDevice device(session, ts);
+
+	return swapChainCommit(&getChain(session, ts)->commit, &device, &ts->CurrentIndex, submitSerial,
+		getWrapperSettings()->skipUnchangedSwapTextures);
 }
 
-extern "C" ovrTextureSwapChainWrapper* getChain(revSession session, ovrSwapTextureSet* ts) {
-	return swapchains->find(ts)->second; //TODO
+//sessions are created, looked up and destroyed from any thread, only change the list while holding the lock exclusively
+SRWLOCK sessionStatesLock = SRWLOCK_INIT;
+ovrSessionState* sessionStates;
+CONDITION_VARIABLE sessionStateReleased = CONDITION_VARIABLE_INIT; // a state unlinked by destroySessionState lost its last user
+
+extern "C" ovrSessionState* createSessionState(revSession session) {
+	ovrSessionState* state = (ovrSessionState*)calloc(1, sizeof(ovrSessionState));
+
+	if (state == NULL) {
+		return NULL;
+	}
+
+	state->session = session;
+	state->users = 1;
+	InitializeSRWLock(&state->chainsLock);
+	InitializeSRWLock(&state->trackingLock);
+	propertyCacheInit(&state->properties, getWrapperSettings()->propertyCacheEnabled, getWrapperSettings()->propertyCacheLifetimeMs / 1000.0);
+
+	AcquireSRWLockExclusive(&sessionStatesLock);
+	state->next = sessionStates;
+	sessionStates = state;
+	ReleaseSRWLockExclusive(&sessionStatesLock);
+
+	return state;
+}
+
+//the state stays alive until it is released again, even when the session is destroyed meanwhile
+extern "C" ovrSessionState* acquireSessionState(revSession session) {
+	ovrSessionState* state;
+
+	AcquireSRWLockShared(&sessionStatesLock);
+	for (state = sessionStates;state != NULL;state = state->next) {
+		if (state->session == session) {
+			InterlockedIncrement(&state->users);
+			break;
+		}
+	}
+	ReleaseSRWLockShared(&sessionStatesLock);
+
+	return state;
+}
+
+extern "C" void releaseSessionState(ovrSessionState* state) {
+	if (state == NULL) {
+		return;
+	}
+
+	//only the list's reference is dropped by destroySessionState, so the count only reaches 0 while it waits.
+	//Taking the lock orders the wake after its check of the count
+	if (InterlockedDecrement(&state->users) == 0) {
+		AcquireSRWLockShared(&sessionStatesLock);
+		ReleaseSRWLockShared(&sessionStatesLock);
+		WakeAllConditionVariable(&sessionStateReleased);
+	}
+}
+
+extern "C" void destroySessionState(revSession session) {
+	ovrSessionState* state = NULL;
+
+	AcquireSRWLockExclusive(&sessionStatesLock);
+	for (ovrSessionState** it = &sessionStates;*it != NULL;it = &(*it)->next) {
+		if ((*it)->session == session) {
+			state = *it;
+			*it = state->next;
+			break;
+		}
+	}
+
+	//calls that acquired the state before it was unlinked finish using it first
+	if (state != NULL && InterlockedDecrement(&state->users) > 0) {
+		while (state->users > 0) {
+			SleepConditionVariableSRW(&sessionStateReleased, &sessionStatesLock, INFINITE, 0);
+		}
+	}
+	ReleaseSRWLockExclusive(&sessionStatesLock);
+
+	if (state == NULL) {
+		return;
+	}
+
+	propertyCacheFlush(&state->properties, session);
+
+	//destroy swap texture sets the application did not destroy itself
+	while (state->chains != NULL) {
+		ovrTextureSwapChainWrapper* chain = state->chains;
+		state->chains = chain->next;
+
+		rev_DestroyTextureSwapChain(session, chain->swapChain);
+
+		if (chain->pContext != NULL) {
+			chain->pContext->Release();
+		}
+
+		free(chain->textures);
+		free((char*)chain - offsetof(ovrSwapTextureSetBlock, chain));
+	}
+
+	free(state);
 }
 
-extern "C" void setChain(revSession session, ovrSwapTextureSet* ts, ovrTextureSwapChainWrapper* chain) {
-	swapchains->emplace(ts, chain);
+//pending property writes of sessions the application did not destroy reach the runtime before it shuts down
+extern "C" void flushAllPropertyCaches() {
+	AcquireSRWLockShared(&sessionStatesLock);
+	for (ovrSessionState* state = sessionStates;state != NULL;state = state->next) {
+		propertyCacheFlush(&state->properties, state->session);
+	}
+	ReleaseSRWLockShared(&sessionStatesLock);
+}
+
+extern "C" ovrSwapTextureSet* createChain(revSession session, ovrTextureSwapChainWrapper** outChain) {
+	ovrSessionState* state = acquireSessionState(session);
+
+	if (state == NULL) {
+		return NULL;
+	}
+
+	ovrSwapTextureSetBlock* block = (ovrSwapTextureSetBlock*)calloc(1, sizeof(ovrSwapTextureSetBlock));
+
+	if (block == NULL) {
+		releaseSessionState(state);
+
+		return NULL;
+	}
+
+	block->tag = ovrSwapTextureSetTag;
+
+	AcquireSRWLockExclusive(&state->chainsLock);
+	block->chain.next = state->chains;
+	state->chains = &block->chain;
+	ReleaseSRWLockExclusive(&state->chainsLock);
+
+	releaseSessionState(state);
+
+	*outChain = &block->chain;
+
+	return &block->textureSet;
+}
+
+extern "C" void removeChain(revSession session, ovrSwapTextureSet* ts) {
+	ovrSwapTextureSetBlock* block = (ovrSwapTextureSetBlock*)ts;
+	ovrSessionState* state = acquireSessionState(session);
+
+	assert(block->tag == ovrSwapTextureSetTag);
+
+	if (state != NULL) {
+		AcquireSRWLockExclusive(&state->chainsLock);
+		for (ovrTextureSwapChainWrapper** it = &state->chains;*it != NULL;it = &(*it)->next) {
+			if (*it == &block->chain) {
+				*it = block->chain.next;
+				break;
+			}
+		}
+		ReleaseSRWLockExclusive(&state->chainsLock);
+
+		releaseSessionState(state);
+	}
+
+	block->tag = 0;
+
+	if (block->chain.pContext != NULL) {
+		block->chain.pContext->Release();
+	}
+
+	free(block->chain.textures);
+	free(block);
 }
 
 extern "C" ovrResult makeD3D11Texture(IUnknown* device,
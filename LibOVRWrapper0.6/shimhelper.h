@@ -2,6 +2,9 @@
 
 #include "stdafx.h"
 #include "d3d11.h"
+#include "../LibOVRWrapperShared/PropertyCache.h"
+#include "../LibOVRWrapperShared/SwapChainMirror.h"
+#include "../LibOVRWrapperShared/SwapChainCommit.h"
 
 #include "../LibOVR0.6/Include/OVR_CAPI_0_6_0.h"
 
@@ -15,18 +18,92 @@ typedef struct ovrTextureSwapChainWrapper_
 {
 	revTextureSwapChain swapChain;
 	int textureCount;
+	SwapChainMirror mirror; // ring index of swapChain, kept without asking the runtime
 	ID3D11Texture2D** textures;	
 	ID3D11DeviceContext* pContext;	
+	SwapChainCommit commit; // aliasing and the last commit of the set, see swapChainCommit
+	struct ovrTextureSwapChainWrapper_* next;
 } ovrTextureSwapChainWrapper;
 
+#define ovrSwapTextureSetTag 0x53545357
+
+// Read only counters of texture copies done and skipped by renderChain, served by ovr_GetInt
+#define WRAPPER_KEY_COPIES_DONE "LibOVRWrapper.CopiesDone"
+#define WRAPPER_KEY_COPIES_SKIPPED "LibOVRWrapper.CopiesSkipped"
+
+// Read only counters of tracking state queries answered from a snapshot and from the runtime
+#define WRAPPER_KEY_TRACKING_HITS "LibOVRWrapper.TrackingSnapshotHits"
+#define WRAPPER_KEY_TRACKING_MISSES "LibOVRWrapper.TrackingSnapshotMisses"
+
+// The ovrSwapTextureSet handed to the application is allocated in one block with its wrapper,
+// so the wrapper is reached from the set pointer without any lookup.
+typedef struct ovrSwapTextureSetBlock_
+{
+	ovrSwapTextureSet textureSet;
+	unsigned int tag;
+	ovrTextureSwapChainWrapper chain;
+} ovrSwapTextureSetBlock;
+
+#define ovrTrackingSnapshotCount 4
+
+// A translated tracking state, reused for queries of the same absTime within one submitted frame
+typedef struct ovrTrackingSnapshot_
+{
+	double absTime;
+	unsigned int frame; // ovrSessionState::trackingFrame the snapshot was taken in
+	bool valid;
+	ovrTrackingState state;
+} ovrTrackingSnapshot;
+
+// Per-session state, allocated in ovrHmd_Create and released in ovrHmd_Destroy.
+// Keeps the swap texture sets created on the session so they can be validated and torn down.
+typedef struct ovrSessionState_
+{
+	revSession session;
+	volatile LONG users; // the session list's reference and one per call using the state, see acquireSessionState
+	SRWLOCK chainsLock; // guards the chain list, swap texture sets are created and destroyed from any thread
+	ovrTextureSwapChainWrapper* chains;
+	unsigned int submitSerial; // advanced by every ovrHmd_SubmitFrame, identifies the call to swapChainCommit
+	unsigned int copiesDone;
+	unsigned int copiesSkipped;
+	unsigned int defaultHmdCaps; //captured at ovrHmd_Create next to the rest of the ovrHmdDesc
+	SRWLOCK trackingLock; // guards the snapshots and trackingFrame, tracking is queried from several threads
+	ovrTrackingSnapshot snapshots[ovrTrackingSnapshotCount];
+	unsigned int nextSnapshot;
+	unsigned int trackingFrame; // advanced by every ovrHmd_SubmitFrame, snapshots never outlive it
+	volatile LONG trackingHits; // counted with InterlockedIncrement, lookups only hold trackingLock shared
+	volatile LONG trackingMisses;
+	PropertyCache properties; // flushed by every submitted frame, before the session is destroyed and at shutdown
+	struct ovrSessionState_* next;
+} ovrSessionState;
+
+inline ovrTextureSwapChainWrapper* getChain(revSession session, ovrSwapTextureSet* ts) {
+	ovrSwapTextureSetBlock* block = (ovrSwapTextureSetBlock*)ts;
+
+	assert(block->tag == ovrSwapTextureSetTag);
+
+	return &block->chain;
+}
+
 WrapperSettings* getWrapperSettings();
 void setWrapperSettings(WrapperSettings* settings);
 
 EXTERNC HRESULT wrapCreateShaderResourceView(ID3D11Device* device, ID3D11Resource* resource, ID3D11ShaderResourceView** srv);
-EXTERNC ovrTextureSwapChainWrapper* getChain(revSession session, ovrSwapTextureSet* ts);
-EXTERNC void setChain(revSession session, ovrSwapTextureSet* ts, ovrTextureSwapChainWrapper* chain);
-EXTERNC void initChains();
+EXTERNC ovrSwapTextureSet* createChain(revSession session, ovrTextureSwapChainWrapper** outChain);
 EXTERNC void removeChain(revSession session, ovrSwapTextureSet* ts);
+EXTERNC void syncAliasedIndex(revSession session, ovrSwapTextureSet* ts);
+EXTERNC SwapChainCommitResult commitChain(revSession session, ovrSwapTextureSet* ts, unsigned int submitSerial);
+EXTERNC ovrSessionState* createSessionState(revSession session);
+EXTERNC ovrSessionState* acquireSessionState(revSession session);
+EXTERNC void releaseSessionState(ovrSessionState* state);
+EXTERNC void destroySessionState(revSession session);
+EXTERNC PropertyCache* getPropertyCache(ovrSessionState* state);
+EXTERNC void flushAllPropertyCaches();
+EXTERNC bool getWrapperInt(ovrSessionState* state, const char* propertyName, int* value);
+EXTERNC bool findTrackingSnapshot(ovrSessionState* state, double absTime, ovrTrackingState* outState);
+EXTERNC void storeTrackingSnapshot(ovrSessionState* state, double absTime, const ovrTrackingState* trackingState);
+EXTERNC void advanceTrackingFrame(ovrSessionState* state);
+EXTERNC void invalidateTrackingSnapshots(ovrSessionState* state);
 EXTERNC void setMirror(revMirrorTexture* mirror);
 EXTERNC revMirrorTexture* getMirror();
 EXTERNC ovrResult makeD3D11Texture(IUnknown* device,
@@ -16,14 +16,14 @@
 #include "OVRShim.h"
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params) {
-	initChains();
-
 	//TODO: handle ovrInit_ServerOptional ?
 
 	return rev_Initialize((revInitParams*)params);
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Shutdown() {
+	flushAllPropertyCaches();
+
 	rev_Shutdown();
 }
 
@@ -41,7 +41,7 @@ OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message) {
 
 float globalRefreshRate = 90.0f;
 
-OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrHmd session) {
+ovrHmdDesc buildHmdDesc(revSession session) {
 	revHmdDesc desc = rev_GetHmdDesc((revSession)session);
 
 	ovrHmdDesc d;
@@ -83,6 +83,27 @@ OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrHmd session) {
 	return d;
 }
 
+OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrHmd session) {
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	//the descriptor only changes on device changes, so avoid the runtime round trips on every call
+	if (state == NULL) {
+		return buildHmdDesc((revSession)session);
+	}
+
+	ovrHmdDesc desc;
+	unsigned int generation;
+
+	if (!loadHmdDesc(state, &desc, &generation)) {
+		desc = buildHmdDesc((revSession)session);
+		storeHmdDesc(state, &desc, generation);
+	}
+
+	releaseSessionState(state);
+
+	return desc;
+}
+
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Create(ovrHmd* pSession, ovrGraphicsLuid* pLuid) {
 	ovrResult r = rev_Create((revSession*)pSession, (revGraphicsLuid*)pLuid);
 
@@ -90,20 +111,32 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_Create(ovrHmd* pSession, ovrGraphicsLuid* pLu
 		return r;
 	}
 
+	ovrSessionState* state = createSessionState(*(revSession*)pSession);
+
+	if (state == NULL) {
+		rev_Destroy(*(revSession*)pSession);
+
+		return ovrError_MemoryAllocationFailure;
+	}
+
+	ovrHmdDesc desc = buildHmdDesc(*(revSession*)pSession);
+	state->hmdPresent = ovrTrue;
+	storeHmdDesc(state, &desc, 0);
+
 	rev_SetTrackingOriginType(*(revSession*)pSession, revTrackingOrigin_EyeLevel);
 
 	return r;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Destroy(ovrHmd session) {
+	destroySessionState((revSession)session);
+
 	rev_Destroy((revSession)session);
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetEnabledCaps(ovrHmd session) {
-	revHmdDesc desc = rev_GetHmdDesc((revSession)session);
-
 	//not possible anymore
-	return desc.DefaultHmdCaps;
+	return ovr_GetHmdDesc(session).DefaultHmdCaps;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_SetEnabledCaps(ovrHmd session, unsigned int hmdCaps) {
@@ -118,6 +151,15 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_ConfigureTracking(ovrHmd session, unsigned in
 
 OVR_PUBLIC_FUNCTION(void) ovr_RecenterPose(ovrHmd session) {
 	rev_RecenterTrackingOrigin((revSession)session);
+
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	if (state != NULL) {
+		invalidateTrackingSnapshots(state);
+		invalidateHmdDesc(state);
+	}
+
+	releaseSessionState(state);
 }
 
 void copyPose(ovrPosef* dest, const revPosef* source) {
@@ -142,6 +184,18 @@ void copyPoseState(ovrPoseStatef* dest, const revPoseStatef* source) {
 double globalTrackingStateTime = 0.0;
 
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrHmd hmd, double absTime) {
+	ovrSessionState* sessionState = acquireSessionState((revSession)hmd);
+
+	if (sessionState != NULL) {
+		ovrTrackingState snapshot;
+
+		if (findTrackingSnapshot(sessionState, absTime, &snapshot)) {
+			releaseSessionState(sessionState);
+
+			return snapshot;
+		}
+	}
+
 	revTrackingState state = rev_GetTrackingState((revSession)hmd, absTime, ovrTrue);
 	revTrackerPose tpose = rev_GetTrackerPose((revSession)hmd, 0);	
 
@@ -163,6 +217,12 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrHmd hmd, double ab
 	
 	globalTrackingStateTime = rev_GetTimeInSeconds();
 
+	if (sessionState != NULL) {
+		storeTrackingSnapshot(sessionState, absTime, &r);
+	}
+
+	releaseSessionState(sessionState);
+
 	return r;
 }
 
@@ -253,18 +313,17 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrHmd session,
 	return r;
 }
 
-revTextureSwapChain renderChain(revSession session, ovrSwapTextureSet* ts)
+revTextureSwapChain renderChain(ovrSessionState* state, ovrSwapTextureSet* ts)
 {
-	ovrTextureSwapChainWrapper* chainwrapper = getChain(session, ts);
+	SwapChainCommitResult result = commitChain(state->session, ts, state->submitSerial);
 
-	int currentIndex = 0;
-	rev_GetTextureSwapChainCurrentIndex(session, chainwrapper->swapChain, &currentIndex);
-
-	CopyTexture(chainwrapper->pContext, chainwrapper->textures[currentIndex], &ts->Textures[ts->CurrentIndex]);	
-	
-	rev_CommitTextureSwapChain(session, chainwrapper->swapChain);
+	if (result == swapChainCommitCopied) {
+		state->copiesDone++;
+	} else if (result == swapChainCommitSkipped) {
+		state->copiesSkipped++;
+	}
 
-	return chainwrapper->swapChain;
+	return getChain(state->session, ts)->swapChain;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrHmd session, unsigned int frameIndex,
@@ -273,18 +332,19 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrHmd session, unsigned int fram
 
 	//ovrLayerType 2, 6 do not exists anymore. max layer count is 16 instead of 32
 
-	unsigned int trueLayerCount = 0;
-	for (unsigned int i = 0;i < layerCount;i++) {
-		if (layerPtrList[i] != NULL) {
-			trueLayerCount++;
-		}
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	if (state == NULL) {
+		return ovrError_InvalidParameter;
 	}
 
-	if (trueLayerCount > 16) {
-		trueLayerCount = 16; //ignore layer counts > 16
-	}	
+	//every call commits a set once, however many of its layers show it; 0 is kept for sets that were never committed
+	if (++state->submitSerial == 0) {
+		state->submitSerial = 1;
+	}
 
-	revLayerHeader** newlayers = (revLayerHeader**)malloc(sizeof(revLayerHeader*) * trueLayerCount);
+	//layers are translated into the session's arena, so nothing is allocated per frame
+	revLayerHeader** newlayers = state->layerPtrs;
 	
 	unsigned int np = 0;
 
@@ -297,15 +357,15 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrHmd session, unsigned int fram
 
 		if (layer->Type == ovrLayerType_EyeFov) {
 			const ovrLayerEyeFov* oldelayer = (const ovrLayerEyeFov*)layer;
-			revLayerEyeFov *elayer = (revLayerEyeFov*)malloc(sizeof(revLayerEyeFov));
+			revLayerEyeFov *elayer = &state->layers[np].EyeFov;
 
 			//if both eyes use same swaptextureset
 			if (oldelayer->ColorTexture[0] == oldelayer->ColorTexture[1]) {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
 				elayer->ColorTexture[1] = elayer->ColorTexture[0];
 			} else {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
-				elayer->ColorTexture[1] = renderChain((revSession)session, oldelayer->ColorTexture[1]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[1] = renderChain(state, oldelayer->ColorTexture[1]);
 			}		
 			
 			elayer->Fov[0].DownTan = oldelayer->Fov[0].DownTan;
@@ -326,47 +386,43 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrHmd session, unsigned int fram
 			elayer->SensorSampleTime = globalTrackingStateTime;
 			elayer->Viewport[0] = *(revRecti*)&oldelayer->Viewport[0];
 			elayer->Viewport[1] = *(revRecti*)&oldelayer->Viewport[1];
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}		
 		else if (layer->Type == ovrLayerType_QuadInWorld) {
 			const ovrLayerQuad* oldelayer = (const ovrLayerQuad*)layer;
-			revLayerQuad *elayer = (revLayerQuad*)malloc(sizeof(revLayerQuad));
+			revLayerQuad *elayer = &state->layers[np].Quad;
 
 			elayer->Header.Type = revLayerType_Quad;
 			elayer->Header.Flags = layer->Flags;
 
-			elayer->ColorTexture = renderChain((revSession)session, oldelayer->ColorTexture);
+			elayer->ColorTexture = renderChain(state, oldelayer->ColorTexture);
 			
+			elayer->Viewport = *(revRecti*)&oldelayer->Viewport;
+
 			copyPoseR(&elayer->QuadPoseCenter, &oldelayer->QuadPoseCenter);
 
 			elayer->QuadSize = *(revVector2f *)&oldelayer->QuadSize;
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else if (layer->Type == ovrLayerType_QuadHeadLocked) {
 			const ovrLayerQuad* oldelayer = (const ovrLayerQuad*)layer;
-			revLayerQuad *elayer = (revLayerQuad*)malloc(sizeof(revLayerQuad));
+			revLayerQuad *elayer = &state->layers[np].Quad;
 			
 			elayer->Header.Type = revLayerType_Quad;
 			elayer->Header.Flags = layer->Flags;
 			elayer->Header.Flags |= revLayerFlag_HeadLocked;
 
-			elayer->ColorTexture = renderChain((revSession)session, oldelayer->ColorTexture);
+			elayer->ColorTexture = renderChain(state, oldelayer->ColorTexture);
+
+			elayer->Viewport = *(revRecti*)&oldelayer->Viewport;
 
 			copyPoseR(&elayer->QuadPoseCenter, &oldelayer->QuadPoseCenter);
 
 			elayer->QuadSize = *(revVector2f *)&oldelayer->QuadSize;
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else if (layer->Type == ovrLayerType_Disabled) {			
-			revLayerHeader *elayer = (revLayerHeader*)malloc(sizeof(revLayerHeader));
+			revLayerHeader *elayer = &state->layers[np].Header;
 
 			elayer->Flags = layer->Flags;
 			elayer->Type = (revLayerType)layer->Type;
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else {
 			continue; //ignore unsupported layers
@@ -374,18 +430,20 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrHmd session, unsigned int fram
 
 		np++;
 
-		if (np > 15) {
+		if (np >= ovrMaxLayerCount) {
 			break;
 		}
 	}
 	
-	ovrResult r = rev_SubmitFrame((revSession)session, frameIndex, (const revViewScaleDesc*)viewScaleDesc, newlayers, trueLayerCount);
+	ovrResult r = rev_SubmitFrame((revSession)session, frameIndex, (const revViewScaleDesc*)viewScaleDesc, newlayers, np);
 
-	for (unsigned int i = 0;i < trueLayerCount;i++) {
-		free(newlayers[i]);
-	}
+	//tracking snapshots are only shared between queries made for the same frame
+	advanceTrackingFrame(state);
+
+	//pending property writes of the frame reach the runtime in one go
+	propertyCacheFlush(&state->properties, (revSession)session);
 
-	free(newlayers);
+	releaseSessionState(state);
 
 	return r;
 }
@@ -414,30 +472,59 @@ OVR_PUBLIC_FUNCTION(void) ovr_ResetMulticameraTracking(ovrHmd session) {
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_GetBool(ovrHmd session, const char* propertyName, ovrBool defaultVal) {
-	return rev_GetBool((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheGetBool(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetBool(ovrHmd session, const char* propertyName, ovrBool value) {
-	return rev_SetBool((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheSetBool(getPropertyCache(state), (revSession)session, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(int) ovr_GetInt(ovrHmd session, const char* propertyName, int defaultVal) {
-	return rev_GetInt((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	int value;
+
+	if (!getWrapperInt(state, propertyName, &value)) {
+		value = propertyCacheGetInt(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+	}
+
+	releaseSessionState(state);
+
+	return value;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetInt(ovrHmd session, const char* propertyName, int value) {
-	return rev_SetInt((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheSetInt(getPropertyCache(state), (revSession)session, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(float) ovr_GetFloat(ovrHmd session, const char* propertyName, float defaultVal) {
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	float r;
+
 	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
 		float values[2];
-		rev_GetFloatArray((revSession)session, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
+		propertyCacheGetFloatArray(getPropertyCache(state), (revSession)session, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
 
-		return values[0] + values[1];
+		r = values[0] + values[1];
 	}
+	else {
+		r = propertyCacheGetFloat(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+	}
+
+	releaseSessionState(state);
 
-	return rev_GetFloat((revSession)session, propertyName, defaultVal);
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloat(ovrHmd session, const char* propertyName, float value) {
@@ -447,27 +534,47 @@ OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloat(ovrHmd session, const char* propertyNa
 		return ovrTrue;
 	}	
 
-	return rev_SetFloat((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheSetFloat(getPropertyCache(state), (revSession)session, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrHmd session, const char* propertyName,
 	float values[], unsigned int valuesCapacity) {
-	return rev_GetFloatArray((revSession)session, propertyName, values, valuesCapacity);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	unsigned int r = propertyCacheGetFloatArray(getPropertyCache(state), (revSession)session, propertyName, values, valuesCapacity);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloatArray(ovrHmd session, const char* propertyName,
 	const float values[], unsigned int valuesSize) {
-	return rev_SetFloatArray((revSession)session, propertyName, values, valuesSize);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheSetFloatArray(getPropertyCache(state), (revSession)session, propertyName, values, valuesSize);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovr_GetString(ovrHmd session, const char* propertyName,
 	const char* defaultVal) {
-	return rev_GetString((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	const char* r = propertyCacheGetString(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetString(ovrHmd session, const char* propertyName,
 	const char* value) {
-	return rev_SetString((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+	ovrBool r = propertyCacheSetString(getPropertyCache(state), (revSession)session, propertyName, value);
+	releaseSessionState(state);
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Lookup(const char* name, void** data) {
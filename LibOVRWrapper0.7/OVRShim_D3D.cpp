@@ -103,23 +103,31 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateSwapTextureSetD3D11(ovrHmd session,
 	
 	d.StaticImage = ovrFalse;
 
-	ovrTextureSwapChainWrapper* chainwrapper = (ovrTextureSwapChainWrapper*)malloc(sizeof(ovrTextureSwapChainWrapper));
+	ovrTextureSwapChainWrapper* chainwrapper;
+	ovrSwapTextureSet* ts = createChain((revSession)session, &chainwrapper);
+
+	if (ts == NULL)
+		return ovrError_MemoryAllocationFailure;
+
 	GetContext(device, &chainwrapper->pContext);
 	
 	ovrResult result = rev_CreateTextureSwapChainDX((revSession)session, (IUnknown*)device, &d, &chainwrapper->swapChain);
 
-	if (!OVR_SUCCESS(result))
+	if (!OVR_SUCCESS(result)) {
+		removeChain((revSession)session, ts);
 		return result;
-	
-	ovrSwapTextureSet* ts = (ovrSwapTextureSet*)malloc(sizeof(ovrSwapTextureSet));
-
-	setChain((revSession)session, ts, chainwrapper);
+	}
 
-	rev_GetTextureSwapChainLength((revSession)session, chainwrapper->swapChain, &chainwrapper->textureCount);
+	swapChainMirrorInit(&chainwrapper->mirror, (revSession)session, chainwrapper->swapChain);
+	chainwrapper->textureCount = chainwrapper->mirror.length;
 
 	chainwrapper->textures = (ID3D11Texture2D**)calloc(chainwrapper->textureCount, sizeof(ID3D11Texture2D*));
 
-	ts->TextureCount = 2;
+	//zero copy mode hands the rev buffers to the application directly; typeless buffers would not match the requested format
+	swapChainCommitInit(&chainwrapper->commit, chainwrapper->textureCount,
+		getWrapperSettings()->swapTextureAliasingEnabled && !(d.MiscFlags & revTextureMisc_DX_Typeless));
+
+	ts->TextureCount = chainwrapper->commit.aliased ? chainwrapper->textureCount : 2;
 	ts->CurrentIndex = 0;	
 	ts->Textures = (ovrTexture*)calloc(ts->TextureCount, sizeof(union ovrD3D11Texture));
 
@@ -128,13 +136,18 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateSwapTextureSetD3D11(ovrHmd session,
 		rev_GetTextureSwapChainBufferDX((revSession)session, chainwrapper->swapChain, i, IID_ID3D11Texture2D, (void**)&chainwrapper->textures[i]);
 	}
 
-	for (int i = 0;i < 2;i++) {
+	for (int i = 0;i < ts->TextureCount;i++) {
 		union ovrD3D11Texture* ovrtext = (union ovrD3D11Texture*)&ts->Textures[i];
 
-		ovrResult tr = makeD3D11Texture((IUnknown*)device, &descClone, &ovrtext->D3D11.pTexture);
+		if (chainwrapper->commit.aliased) {
+			ovrtext->D3D11.pTexture = chainwrapper->textures[i];
+			ovrtext->D3D11.pTexture->AddRef();
+		} else {
+			ovrResult tr = makeD3D11Texture((IUnknown*)device, &descClone, &ovrtext->D3D11.pTexture);
 
-		if (tr < 0) {
-			return ovrError_ServiceError;
+			if (tr < 0) {
+				return ovrError_ServiceError;
+			}
 		}
 
 		if (makeShaderView) {
@@ -145,6 +158,10 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_CreateSwapTextureSetD3D11(ovrHmd session,
 		ovrtext->D3D11.Header.TextureSize.w = d.Width;
 		ovrtext->D3D11.Header.TextureSize.h = d.Height;
 	}
+
+	if (chainwrapper->commit.aliased) {
+		syncAliasedIndex((revSession)session, ts);
+	}
 	
 	*outTextureSet = ts;	
 
@@ -1,6 +1,8 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
 #include "stdafx.h"
 
+#include "shimhelper.h"
+
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
                        LPVOID lpReserved
@@ -9,6 +11,21 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 	switch (ul_reason_for_call)
 	{
 	case DLL_PROCESS_ATTACH:
+		{
+			const char inifile[] = ".\\LibOVRWrapper.ini";
+
+			auto settings = new WrapperSettings();
+
+			settings->swapTextureAliasingEnabled = GetPrivateProfileIntA("graphics", "swapTextureAliasingEnabled", 0, inifile) != 0;
+			settings->skipUnchangedSwapTextures = GetPrivateProfileIntA("graphics", "skipUnchangedSwapTextures", 0, inifile) != 0;
+			settings->trackingSnapshotsEnabled = GetPrivateProfileIntA("tracking", "snapshotsEnabled", 1, inifile) != 0;
+			settings->trackingSnapshotTolerance = (int)GetPrivateProfileIntA("tracking", "snapshotToleranceUs", 0, inifile) / 1000000.0;
+			settings->propertyCacheEnabled = GetPrivateProfileIntA("properties", "cacheEnabled", 1, inifile) != 0;
+			settings->propertyCacheLifetimeMs = GetPrivateProfileIntA("properties", "cacheLifetimeMs", 1000, inifile);
+
+			setWrapperSettings(settings);
+		}
+		break;
 	case DLL_THREAD_ATTACH:
 	case DLL_THREAD_DETACH:
 	case DLL_PROCESS_DETACH:
@@ -0,0 +1,584 @@
+#include "stdafx.h"
+
+#include "CallRecorder.h"
+
+#define callTraceInitialSize (64ull << 20) // bytes mapped up front, the file doubles whenever it fills
+
+volatile bool globalCallRecording = false;
+
+CRITICAL_SECTION callRecordLock;
+bool callRecordLockInitialized = false;
+
+HANDLE callTraceFile = INVALID_HANDLE_VALUE;
+HANDLE callTraceMapping = NULL;
+uint8_t* callTraceView = NULL;
+uint64_t callTraceCapacity = 0;
+uint64_t callTraceUsed = 0;
+uint64_t callTraceLastTicks = 0;
+
+// Maps the file at a new size. The old view stays valid until the new one exists, so a failed grow loses nothing.
+bool mapCallTrace(uint64_t capacity) {
+	HANDLE mapping = CreateFileMappingA(callTraceFile, NULL, PAGE_READWRITE, (DWORD)(capacity >> 32), (DWORD)capacity, NULL);
+
+	if (mapping == NULL) {
+		return false;
+	}
+
+	uint8_t* view = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)capacity);
+
+	if (view == NULL) {
+		CloseHandle(mapping);
+		return false;
+	}
+
+	if (callTraceView != NULL) {
+		UnmapViewOfFile(callTraceView);
+		CloseHandle(callTraceMapping);
+	}
+
+	callTraceMapping = mapping;
+	callTraceView = view;
+	callTraceCapacity = capacity;
+
+	return true;
+}
+
+// Cuts the file to the recorded size. Called with callRecordLock held.
+void closeCallTrace() {
+	if (callTraceView != NULL) {
+		UnmapViewOfFile(callTraceView);
+		CloseHandle(callTraceMapping);
+		callTraceView = NULL;
+		callTraceMapping = NULL;
+	}
+
+	LARGE_INTEGER size;
+	size.QuadPart = (LONGLONG)callTraceUsed;
+
+	SetFilePointerEx(callTraceFile, size, NULL, FILE_BEGIN);
+	SetEndOfFile(callTraceFile);
+	CloseHandle(callTraceFile);
+
+	callTraceFile = INVALID_HANDLE_VALUE;
+}
+
+bool callRecordStart(const char* filename) {
+	if (!callRecordLockInitialized) {
+		InitializeCriticalSection(&callRecordLock);
+		callRecordLockInitialized = true;
+	}
+
+	EnterCriticalSection(&callRecordLock);
+
+	if (callTraceFile != INVALID_HANDLE_VALUE) {
+		LeaveCriticalSection(&callRecordLock);
+		return false;
+	}
+
+	callTraceFile = CreateFileA(filename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (callTraceFile == INVALID_HANDLE_VALUE) {
+		LeaveCriticalSection(&callRecordLock);
+		return false;
+	}
+
+	if (!mapCallTrace(callTraceInitialSize)) {
+		callTraceUsed = 0;
+		closeCallTrace();
+		LeaveCriticalSection(&callRecordLock);
+		return false;
+	}
+
+	LARGE_INTEGER frequency, now;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&now);
+
+	CallTraceHeader header = {};
+	memcpy(header.magic, CALL_TRACE_MAGIC, sizeof(header.magic));
+	header.version = CALL_TRACE_VERSION;
+	header.sdkVersion = 8;
+	header.ticksPerSecond = frequency.QuadPart;
+	header.startTicks = now.QuadPart;
+
+	memcpy(callTraceView, &header, sizeof(header));
+	callTraceUsed = sizeof(header);
+	callTraceLastTicks = now.QuadPart;
+
+	globalCallRecording = true;
+
+	LeaveCriticalSection(&callRecordLock);
+
+	return true;
+}
+
+// Called from DllMain. When the process is terminating another thread may have been killed holding the lock,
+// then the file is left at its mapped size and the reader stops at the zero filled tail.
+void callRecordStop(bool processTerminating) {
+	if (!callRecordLockInitialized) {
+		return;
+	}
+
+	globalCallRecording = false;
+
+	if (processTerminating) {
+		if (!TryEnterCriticalSection(&callRecordLock)) {
+			return;
+		}
+	}
+	else {
+		EnterCriticalSection(&callRecordLock);
+	}
+
+	if (callTraceFile != INVALID_HANDLE_VALUE) {
+		closeCallTrace();
+	}
+
+	LeaveCriticalSection(&callRecordLock);
+}
+
+// Appends one record. The timestamp is taken under the lock so the deltas never go backwards.
+void commitCall(callId id, const CallWriter* w) {
+	if (w->overflow) {
+		return;
+	}
+
+	EnterCriticalSection(&callRecordLock);
+
+	if (!globalCallRecording) {
+		LeaveCriticalSection(&callRecordLock);
+		return;
+	}
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	uint8_t header[40];
+	uint32_t n = callEncodeVarint(header, id);
+	n += callEncodeVarint(header + n, GetCurrentThreadId());
+	n += callEncodeVarint(header + n, (uint64_t)now.QuadPart - callTraceLastTicks);
+	n += callEncodeVarint(header + n, w->size);
+
+	uint64_t needed = callTraceUsed + n + w->size;
+
+	if (needed > callTraceCapacity) {
+		uint64_t capacity = callTraceCapacity * 2 > needed ? callTraceCapacity * 2 : needed;
+
+		//out of disk or address space, keep what was recorded so far
+		if (!mapCallTrace(capacity)) {
+			globalCallRecording = false;
+			LeaveCriticalSection(&callRecordLock);
+			return;
+		}
+	}
+
+	memcpy(callTraceView + callTraceUsed, header, n);
+	memcpy(callTraceView + callTraceUsed + n, w->data, w->size);
+
+	callTraceUsed = needed;
+	callTraceLastTicks = now.QuadPart;
+
+	LeaveCriticalSection(&callRecordLock);
+}
+
+void putPose(CallWriter* w, const ovrPosef* pose) {
+	callPutF(w, pose->Orientation.x);
+	callPutF(w, pose->Orientation.y);
+	callPutF(w, pose->Orientation.z);
+	callPutF(w, pose->Orientation.w);
+	callPutF(w, pose->Position.x);
+	callPutF(w, pose->Position.y);
+	callPutF(w, pose->Position.z);
+}
+
+void putFov(CallWriter* w, const ovrFovPort* fov) {
+	callPutF(w, fov->UpTan);
+	callPutF(w, fov->DownTan);
+	callPutF(w, fov->LeftTan);
+	callPutF(w, fov->RightTan);
+}
+
+void putRect(CallWriter* w, const ovrRecti* rect) {
+	callPutS(w, rect->Pos.x);
+	callPutS(w, rect->Pos.y);
+	callPutS(w, rect->Size.w);
+	callPutS(w, rect->Size.h);
+}
+
+void recordCall(callId id) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	commitCall(id, &w);
+}
+
+void recordSessionCall(callId id, ovrSession session) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+
+	commitCall(id, &w);
+}
+
+void recordSessionObject(callId id, ovrSession session, const void* object) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutPtr(&w, object);
+
+	commitCall(id, &w);
+}
+
+void recordInitialize(const ovrInitParams* params, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutU(&w, params != NULL ? params->Flags : 0);
+	callPutU(&w, params != NULL ? params->RequestedMinorVersion : 0);
+	callPutU(&w, params != NULL ? params->ConnectionTimeoutMS : 0);
+	callPutS(&w, r);
+
+	commitCall(callId_ovr_Initialize, &w);
+}
+
+void recordCreate(ovrSession session, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutS(&w, r);
+
+	commitCall(callId_ovr_Create, &w);
+}
+
+void recordGetSessionStatus(ovrSession session, const ovrSessionStatus* status, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutS(&w, r);
+	callPutU(&w, status->HasVrFocus);
+	callPutU(&w, status->HmdPresent);
+
+	commitCall(callId_ovr_GetSessionStatus, &w);
+}
+
+void recordGetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker, const ovrTrackingState* state) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutD(&w, absTime);
+	callPutU(&w, latencyMarker);
+	callPutU(&w, state->StatusFlags);
+	putPose(&w, &state->HeadPose.ThePose);
+	callPutD(&w, state->HeadPose.TimeInSeconds);
+
+	for (int hand = 0;hand < 2;hand++) {
+		callPutU(&w, state->HandStatusFlags[hand]);
+		putPose(&w, &state->HandPoses[hand].ThePose);
+	}
+
+	commitCall(callId_ovr_GetTrackingState, &w);
+}
+
+void recordGetInputState(ovrSession session, unsigned int controllerTypeMask, const ovrInputState* inputState, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutU(&w, controllerTypeMask);
+	callPutS(&w, r);
+
+	if (OVR_SUCCESS(r)) {
+		callPutU(&w, inputState->ConnectedControllerTypes);
+		callPutU(&w, inputState->Buttons);
+		callPutU(&w, inputState->Touches);
+	}
+
+	commitCall(callId_ovr_GetInputState, &w);
+}
+
+void recordSetControllerVibration(ovrSession session, unsigned int controllerTypeMask, float frequency, float amplitude, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutU(&w, controllerTypeMask);
+	callPutF(&w, frequency);
+	callPutF(&w, amplitude);
+	callPutS(&w, r);
+
+	commitCall(callId_ovr_SetControllerVibration, &w);
+}
+
+void recordGetFovTextureSize(ovrSession session, ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel, ovrSizei size) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutU(&w, eye);
+	putFov(&w, &fov);
+	callPutF(&w, pixelsPerDisplayPixel);
+	callPutS(&w, size.w);
+	callPutS(&w, size.h);
+
+	commitCall(callId_ovr_GetFovTextureSize, &w);
+}
+
+void recordGetRenderDesc(ovrSession session, ovrEyeType eye, ovrFovPort fov) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutU(&w, eye);
+	putFov(&w, &fov);
+
+	commitCall(callId_ovr_GetRenderDesc, &w);
+}
+
+// Layers are written as type + 1 (0 for a NULL entry) and flags, followed by the fields of their type.
+// Swap texture sets are written as the handles ovr_CreateSwapTextureSetD3D11 returned.
+void recordSubmitFrame(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc,
+	ovrLayerHeader const * const * layerPtrList, unsigned int layerCount, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutS(&w, frameIndex);
+	callPutS(&w, r);
+	callPutU(&w, viewScaleDesc != NULL);
+
+	if (viewScaleDesc != NULL) {
+		for (int eye = 0;eye < ovrEye_Count;eye++) {
+			callPutF(&w, viewScaleDesc->HmdToEyeViewOffset[eye].x);
+			callPutF(&w, viewScaleDesc->HmdToEyeViewOffset[eye].y);
+			callPutF(&w, viewScaleDesc->HmdToEyeViewOffset[eye].z);
+		}
+		callPutF(&w, viewScaleDesc->HmdSpaceToWorldScaleInMeters);
+	}
+
+	callPutU(&w, layerCount);
+
+	for (unsigned int i = 0;i < layerCount;i++) {
+		const ovrLayerHeader* layer = layerPtrList[i];
+
+		if (layer == NULL) {
+			callPutU(&w, 0);
+			continue;
+		}
+
+		callPutU(&w, (uint64_t)layer->Type + 1);
+		callPutU(&w, layer->Flags);
+
+		switch (layer->Type) {
+		case ovrLayerType_EyeFov:
+		case ovrLayerType_EyeFovDepth:
+			{
+				//EyeFovDepth starts with the EyeFov fields
+				const ovrLayerEyeFov* l = (const ovrLayerEyeFov*)layer;
+
+				for (int eye = 0;eye < ovrEye_Count;eye++) {
+					callPutPtr(&w, l->ColorTexture[eye]);
+					putRect(&w, &l->Viewport[eye]);
+					putFov(&w, &l->Fov[eye]);
+					putPose(&w, &l->RenderPose[eye]);
+				}
+				callPutD(&w, l->SensorSampleTime);
+
+				if (layer->Type == ovrLayerType_EyeFovDepth) {
+					const ovrLayerEyeFovDepth* d = (const ovrLayerEyeFovDepth*)layer;
+
+					callPutPtr(&w, d->DepthTexture[0]);
+					callPutPtr(&w, d->DepthTexture[1]);
+					callPutF(&w, d->ProjectionDesc.Projection22);
+					callPutF(&w, d->ProjectionDesc.Projection23);
+					callPutF(&w, d->ProjectionDesc.Projection32);
+				}
+			}
+			break;
+		case ovrLayerType_EyeMatrix:
+			{
+				const ovrLayerEyeMatrix* l = (const ovrLayerEyeMatrix*)layer;
+
+				for (int eye = 0;eye < ovrEye_Count;eye++) {
+					callPutPtr(&w, l->ColorTexture[eye]);
+					putRect(&w, &l->Viewport[eye]);
+					putPose(&w, &l->RenderPose[eye]);
+					callPutBytes(&w, &l->Matrix[eye], sizeof(ovrMatrix4f));
+				}
+				callPutD(&w, l->SensorSampleTime);
+			}
+			break;
+		case ovrLayerType_Quad:
+			{
+				const ovrLayerQuad* l = (const ovrLayerQuad*)layer;
+
+				callPutPtr(&w, l->ColorTexture);
+				putRect(&w, &l->Viewport);
+				putPose(&w, &l->QuadPoseCenter);
+				callPutF(&w, l->QuadSize.x);
+				callPutF(&w, l->QuadSize.y);
+			}
+			break;
+		case ovrLayerType_Direct:
+			{
+				const ovrLayerDirect* l = (const ovrLayerDirect*)layer;
+
+				for (int eye = 0;eye < ovrEye_Count;eye++) {
+					callPutPtr(&w, l->ColorTexture[eye]);
+					putRect(&w, &l->Viewport[eye]);
+				}
+			}
+			break;
+		}
+	}
+
+	commitCall(callId_ovr_SubmitFrame, &w);
+}
+
+void recordGetPredictedDisplayTime(ovrSession session, long long frameIndex, double r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutS(&w, frameIndex);
+	callPutD(&w, r);
+
+	commitCall(callId_ovr_GetPredictedDisplayTime, &w);
+}
+
+void recordGetTimeInSeconds(double r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutD(&w, r);
+
+	commitCall(callId_ovr_GetTimeInSeconds, &w);
+}
+
+// ovr_GetBool/GetInt record the default and the result, ovr_SetBool/SetInt the value and the result
+void recordPropertyInt(callId id, ovrSession session, const char* propertyName, int value, int r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutS(&w, value);
+	callPutS(&w, r);
+
+	commitCall(id, &w);
+}
+
+void recordGetFloat(ovrSession session, const char* propertyName, float defaultVal, float r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutF(&w, defaultVal);
+	callPutF(&w, r);
+
+	commitCall(callId_ovr_GetFloat, &w);
+}
+
+void recordSetFloat(ovrSession session, const char* propertyName, float value, ovrBool r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutF(&w, value);
+	callPutU(&w, r);
+
+	commitCall(callId_ovr_SetFloat, &w);
+}
+
+void recordGetFloatArray(ovrSession session, const char* propertyName, const float values[], unsigned int valuesCapacity, unsigned int r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutU(&w, valuesCapacity);
+	callPutU(&w, r);
+
+	for (unsigned int i = 0;i < r && i < valuesCapacity;i++) {
+		callPutF(&w, values[i]);
+	}
+
+	commitCall(callId_ovr_GetFloatArray, &w);
+}
+
+void recordSetFloatArray(ovrSession session, const char* propertyName, const float values[], unsigned int valuesSize, ovrBool r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutU(&w, valuesSize);
+
+	for (unsigned int i = 0;i < valuesSize;i++) {
+		callPutF(&w, values[i]);
+	}
+
+	callPutU(&w, r);
+
+	commitCall(callId_ovr_SetFloatArray, &w);
+}
+
+void recordGetString(ovrSession session, const char* propertyName, const char* defaultVal, const char* r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutStr(&w, defaultVal);
+	callPutStr(&w, r);
+
+	commitCall(callId_ovr_GetString, &w);
+}
+
+void recordSetString(ovrSession session, const char* propertyName, const char* value, ovrBool r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutStr(&w, propertyName);
+	callPutStr(&w, value);
+	callPutU(&w, r);
+
+	commitCall(callId_ovr_SetString, &w);
+}
+
+void recordSetQueueAheadFraction(ovrSession session, float queueAheadFraction, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutF(&w, queueAheadFraction);
+	callPutS(&w, r);
+
+	commitCall(callId_ovr_SetQueueAheadFraction, &w);
+}
+
+// The created swap texture set or mirror texture is recorded as a handle later calls refer to
+void recordCreateTextureD3D11(callId id, ovrSession session, const D3D11_TEXTURE2D_DESC* desc, unsigned int miscFlags, const void* object, ovrResult r) {
+	CallWriter w;
+	callWriterInit(&w);
+
+	callPutPtr(&w, session);
+	callPutU(&w, desc->Width);
+	callPutU(&w, desc->Height);
+	callPutU(&w, desc->MipLevels);
+	callPutU(&w, desc->ArraySize);
+	callPutU(&w, desc->Format);
+	callPutU(&w, desc->SampleDesc.Count);
+	callPutU(&w, desc->BindFlags);
+	callPutU(&w, miscFlags);
+	callPutS(&w, r);
+	callPutPtr(&w, OVR_SUCCESS(r) ? object : NULL);
+
+	commitCall(id, &w);
+}
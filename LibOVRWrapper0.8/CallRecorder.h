@@ -0,0 +1,54 @@
+#pragma once
+
+#include "stdafx.h"
+#include "d3d11.h"
+
+#if !defined(OVR_DLL_BUILD)
+#define OVR_DLL_BUILD
+#endif
+
+#include "../LibOVR0.8/Include/OVR_CAPI_0_8_0.h"
+
+#include "CallTrace.h"
+
+// Records the ovr_* calls made on the shim, with their arguments and results, into a memory mapped
+// CallTrace file that the CallReplay tool plays back. Enabled by tracing.callTraceFile in the ini.
+// Records are appended under one lock in call order, while recording is off a CALL_RECORD costs a
+// single test of globalCallRecording, building with LIBOVRWRAPPER_DISABLE_TRACE removes it completely.
+
+extern volatile bool globalCallRecording;
+
+bool callRecordStart(const char* filename);
+void callRecordStop(bool processTerminating);
+
+void recordCall(callId id);
+void recordSessionCall(callId id, ovrSession session);
+void recordSessionObject(callId id, ovrSession session, const void* object);
+void recordInitialize(const ovrInitParams* params, ovrResult r);
+void recordCreate(ovrSession session, ovrResult r);
+void recordGetSessionStatus(ovrSession session, const ovrSessionStatus* status, ovrResult r);
+void recordGetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker, const ovrTrackingState* state);
+void recordGetInputState(ovrSession session, unsigned int controllerTypeMask, const ovrInputState* inputState, ovrResult r);
+void recordSetControllerVibration(ovrSession session, unsigned int controllerTypeMask, float frequency, float amplitude, ovrResult r);
+void recordGetFovTextureSize(ovrSession session, ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel, ovrSizei size);
+void recordGetRenderDesc(ovrSession session, ovrEyeType eye, ovrFovPort fov);
+void recordSubmitFrame(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc,
+	ovrLayerHeader const * const * layerPtrList, unsigned int layerCount, ovrResult r);
+void recordGetPredictedDisplayTime(ovrSession session, long long frameIndex, double r);
+void recordGetTimeInSeconds(double r);
+void recordPropertyInt(callId id, ovrSession session, const char* propertyName, int value, int r);
+void recordGetFloat(ovrSession session, const char* propertyName, float defaultVal, float r);
+void recordSetFloat(ovrSession session, const char* propertyName, float value, ovrBool r);
+void recordGetFloatArray(ovrSession session, const char* propertyName, const float values[], unsigned int valuesCapacity, unsigned int r);
+void recordSetFloatArray(ovrSession session, const char* propertyName, const float values[], unsigned int valuesSize, ovrBool r);
+void recordGetString(ovrSession session, const char* propertyName, const char* defaultVal, const char* r);
+void recordSetString(ovrSession session, const char* propertyName, const char* value, ovrBool r);
+void recordSetQueueAheadFraction(ovrSession session, float queueAheadFraction, ovrResult r);
+void recordCreateTextureD3D11(callId id, ovrSession session, const D3D11_TEXTURE2D_DESC* desc, unsigned int miscFlags, const void* object, ovrResult r);
+
+#ifdef LIBOVRWRAPPER_DISABLE_TRACE
+#define CALL_RECORD(call) do {} while (0)
+#else
+#define CALL_RECORD(call) \
+	do { if (globalCallRecording) call; } while (0)
+#endif
@@ -0,0 +1,735 @@
+// CallReplay.cpp : Replays a call trace recorded by the 0.8 shim (tracing.callTraceFile).
+//
+// Standalone console tool, build with: cl /EHsc CallReplay.cpp
+//                                  or: g++ -std=c++11 -O2 CallReplay.cpp -ldl
+// Usage: CallReplay [--decode] [--fast] [--target library] [trace]
+//   --decode  prints the calls instead of replaying them
+//   --fast    replays as fast as possible instead of at the recorded timing
+//   --target  library exporting the 0.8 ovr_* API, a build of the shim against the runtime to test.
+//             Without it the trace is only paced and decoded, which measures the tool itself.
+//
+// Calls are replayed on one thread in recorded order. Calls that need a graphics device
+// (swap texture set and mirror texture creation) are skipped, so submitted layers are replayed
+// as disabled layers with the recorded type's flags: the submission path still runs every frame,
+// the texture copies and commits do not. At the end the time spent in each entry point is printed.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define loadTarget(name) ((void*)LoadLibraryA(name))
+#define findExport(library, name) ((void*)GetProcAddress((HMODULE)(library), name))
+#else
+#include <dlfcn.h>
+#define loadTarget(name) dlopen(name, RTLD_NOW)
+#define findExport(library, name) dlsym(library, name)
+#endif
+
+#define OVR_CAPI_NO_UTILS
+#include "../../LibOVR0.8/Include/OVR_CAPI_0_8_0.h"
+
+#include "../CallTrace.h"
+
+const char* callNames[] = {
+#define X(name) #name,
+	LIBOVRWRAPPER_CALLS(X)
+#undef X
+};
+
+struct ReplayTarget
+{
+	ovrResult (OVR_CDECL *Initialize)(const ovrInitParams* params);
+	void (OVR_CDECL *Shutdown)();
+	ovrResult (OVR_CDECL *Create)(ovrSession* pSession, ovrGraphicsLuid* pLuid);
+	void (OVR_CDECL *Destroy)(ovrSession session);
+	ovrResult (OVR_CDECL *GetSessionStatus)(ovrSession session, ovrSessionStatus* sessionStatus);
+	ovrHmdDesc (OVR_CDECL *GetHmdDesc)(ovrSession session);
+	void (OVR_CDECL *RecenterPose)(ovrSession session);
+	ovrTrackingState (OVR_CDECL *GetTrackingState)(ovrSession session, double absTime, ovrBool latencyMarker);
+	ovrResult (OVR_CDECL *GetInputState)(ovrSession session, unsigned int controllerTypeMask, ovrInputState* inputState);
+	ovrResult (OVR_CDECL *SetControllerVibration)(ovrSession session, unsigned int controllerTypeMask, float frequency, float amplitude);
+	ovrSizei (OVR_CDECL *GetFovTextureSize)(ovrSession session, ovrEyeType eye, ovrFovPort fov, float pixelsPerDisplayPixel);
+	ovrEyeRenderDesc (OVR_CDECL *GetRenderDesc)(ovrSession session, ovrEyeType eyeType, ovrFovPort fov);
+	ovrResult (OVR_CDECL *SubmitFrame)(ovrSession session, long long frameIndex, const ovrViewScaleDesc* viewScaleDesc,
+		ovrLayerHeader const * const * layerPtrList, unsigned int layerCount);
+	double (OVR_CDECL *GetPredictedDisplayTime)(ovrSession session, long long frameIndex);
+	double (OVR_CDECL *GetTimeInSeconds)();
+	ovrBool (OVR_CDECL *GetBool)(ovrSession session, const char* propertyName, ovrBool defaultVal);
+	ovrBool (OVR_CDECL *SetBool)(ovrSession session, const char* propertyName, ovrBool value);
+	int (OVR_CDECL *GetInt)(ovrSession session, const char* propertyName, int defaultVal);
+	ovrBool (OVR_CDECL *SetInt)(ovrSession session, const char* propertyName, int value);
+	float (OVR_CDECL *GetFloat)(ovrSession session, const char* propertyName, float defaultVal);
+	ovrBool (OVR_CDECL *SetFloat)(ovrSession session, const char* propertyName, float value);
+	unsigned int (OVR_CDECL *GetFloatArray)(ovrSession session, const char* propertyName, float values[], unsigned int valuesCapacity);
+	ovrBool (OVR_CDECL *SetFloatArray)(ovrSession session, const char* propertyName, const float values[], unsigned int valuesSize);
+	const char* (OVR_CDECL *GetString)(ovrSession session, const char* propertyName, const char* defaultVal);
+	ovrBool (OVR_CDECL *SetString)(ovrSession session, const char* propertyName, const char* value);
+	ovrResult (OVR_CDECL *SetQueueAheadFraction)(ovrSession session, float queueAheadFraction);
+};
+
+struct CallStats
+{
+	uint64_t count;
+	uint64_t skipped; // not replayed, no target, unknown session or needs a graphics device
+	uint64_t resultMismatches; // the target returned another ovrResult than the recording
+	double totalSeconds;
+	double maxSeconds;
+};
+
+struct Replay
+{
+	bool decode;
+	ReplayTarget* target;
+	std::unordered_map<uint64_t, ovrSession> sessions; // recorded session handle to the live one
+	double timeOffset; // live ovr_GetTimeInSeconds minus the recorded one, applied to recorded absTimes
+	CallStats stats[callId_Count];
+};
+
+template<typename T> bool bindExport(void* library, const char* name, T* function) {
+	*function = (T)findExport(library, name);
+
+	if (*function == NULL) {
+		fprintf(stderr, "target does not export %s\n", name);
+		return false;
+	}
+
+	return true;
+}
+
+bool bindTarget(void* library, ReplayTarget* t) {
+	return bindExport(library, "ovr_Initialize", &t->Initialize) &&
+		bindExport(library, "ovr_Shutdown", &t->Shutdown) &&
+		bindExport(library, "ovr_Create", &t->Create) &&
+		bindExport(library, "ovr_Destroy", &t->Destroy) &&
+		bindExport(library, "ovr_GetSessionStatus", &t->GetSessionStatus) &&
+		bindExport(library, "ovr_GetHmdDesc", &t->GetHmdDesc) &&
+		bindExport(library, "ovr_RecenterPose", &t->RecenterPose) &&
+		bindExport(library, "ovr_GetTrackingState", &t->GetTrackingState) &&
+		bindExport(library, "ovr_GetInputState", &t->GetInputState) &&
+		bindExport(library, "ovr_SetControllerVibration", &t->SetControllerVibration) &&
+		bindExport(library, "ovr_GetFovTextureSize", &t->GetFovTextureSize) &&
+		bindExport(library, "ovr_GetRenderDesc", &t->GetRenderDesc) &&
+		bindExport(library, "ovr_SubmitFrame", &t->SubmitFrame) &&
+		bindExport(library, "ovr_GetPredictedDisplayTime", &t->GetPredictedDisplayTime) &&
+		bindExport(library, "ovr_GetTimeInSeconds", &t->GetTimeInSeconds) &&
+		bindExport(library, "ovr_GetBool", &t->GetBool) &&
+		bindExport(library, "ovr_SetBool", &t->SetBool) &&
+		bindExport(library, "ovr_GetInt", &t->GetInt) &&
+		bindExport(library, "ovr_SetInt", &t->SetInt) &&
+		bindExport(library, "ovr_GetFloat", &t->GetFloat) &&
+		bindExport(library, "ovr_SetFloat", &t->SetFloat) &&
+		bindExport(library, "ovr_GetFloatArray", &t->GetFloatArray) &&
+		bindExport(library, "ovr_SetFloatArray", &t->SetFloatArray) &&
+		bindExport(library, "ovr_GetString", &t->GetString) &&
+		bindExport(library, "ovr_SetString", &t->SetString) &&
+		bindExport(library, "ovr_SetQueueAheadFraction", &t->SetQueueAheadFraction);
+}
+
+void getFov(CallReader* r, ovrFovPort* fov) {
+	fov->UpTan = callGetF(r);
+	fov->DownTan = callGetF(r);
+	fov->LeftTan = callGetF(r);
+	fov->RightTan = callGetF(r);
+}
+
+void skipBytes(CallReader* r, uint32_t count) {
+	if ((uint64_t)(r->end - r->p) < count) {
+		r->error = true;
+		return;
+	}
+
+	r->p += count;
+}
+
+// Reads a recorded session handle. Returns false when the call cannot be replayed on a live session.
+bool getSession(Replay* replay, CallReader* r, uint64_t* recorded, ovrSession* session) {
+	*recorded = callGetU(r);
+
+	auto it = replay->sessions.find(*recorded);
+
+	if (it == replay->sessions.end()) {
+		return false;
+	}
+
+	*session = it->second;
+
+	return true;
+}
+
+typedef std::chrono::steady_clock replayClock;
+
+double secondsSince(replayClock::time_point start) {
+	return std::chrono::duration<double>(replayClock::now() - start).count();
+}
+
+void countCall(Replay* replay, callId id, replayClock::time_point start, bool replayed) {
+	CallStats* stats = &replay->stats[id];
+
+	stats->count++;
+
+	if (!replayed) {
+		stats->skipped++;
+		return;
+	}
+
+	double seconds = secondsSince(start);
+
+	stats->totalSeconds += seconds;
+	if (seconds > stats->maxSeconds) {
+		stats->maxSeconds = seconds;
+	}
+}
+
+void checkResult(Replay* replay, callId id, int64_t recorded, ovrResult live) {
+	if (recorded != live) {
+		replay->stats[id].resultMismatches++;
+	}
+}
+
+// Decodes one call and replays it on the target. Only the time spent inside the target is counted.
+void replayCall(Replay* replay, callId id, CallReader* r) {
+	ReplayTarget* t = replay->decode ? NULL : replay->target;
+	replayClock::time_point start;
+	bool replayed = false;
+	uint64_t recordedSession = 0;
+	ovrSession session = NULL;
+	char name[256];
+
+	switch (id) {
+	case callId_ovr_Initialize:
+		{
+			ovrInitParams params = {};
+			params.Flags = (uint32_t)callGetU(r);
+			params.RequestedMinorVersion = (uint32_t)callGetU(r);
+			params.ConnectionTimeoutMS = (uint32_t)callGetU(r);
+			int64_t recorded = callGetS(r);
+
+			if (t != NULL) {
+				start = replayClock::now();
+				checkResult(replay, id, recorded, t->Initialize(&params));
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_Shutdown:
+		if (t != NULL) {
+			start = replayClock::now();
+			t->Shutdown();
+			replayed = true;
+		}
+		break;
+	case callId_ovr_Create:
+		{
+			recordedSession = callGetU(r);
+			int64_t recorded = callGetS(r);
+
+			if (replay->decode) {
+				printf(" session %llx result %lld", (unsigned long long)recordedSession, (long long)recorded);
+			}
+
+			if (t != NULL) {
+				ovrGraphicsLuid luid;
+
+				start = replayClock::now();
+				ovrResult live = t->Create(&session, &luid);
+				replayed = true;
+
+				checkResult(replay, id, recorded, live);
+
+				if (OVR_SUCCESS(live) && recorded >= 0) {
+					replay->sessions[recordedSession] = session;
+				}
+			}
+		}
+		break;
+	case callId_ovr_Destroy:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			start = replayClock::now();
+			t->Destroy(session);
+			replayed = true;
+
+			replay->sessions.erase(recordedSession);
+		}
+		break;
+	case callId_ovr_GetSessionStatus:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			int64_t recorded = callGetS(r);
+			ovrSessionStatus status;
+
+			start = replayClock::now();
+			checkResult(replay, id, recorded, t->GetSessionStatus(session, &status));
+			replayed = true;
+		}
+		break;
+	case callId_ovr_GetHmdDesc:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			start = replayClock::now();
+			t->GetHmdDesc(session);
+			replayed = true;
+		}
+		break;
+	case callId_ovr_RecenterPose:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			start = replayClock::now();
+			t->RecenterPose(session);
+			replayed = true;
+		}
+		break;
+	case callId_ovr_GetTrackingState:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			double absTime = callGetD(r);
+			ovrBool latencyMarker = (ovrBool)callGetU(r);
+
+			//0 asks for the current time, other times are moved onto the replaying runtime's clock
+			if (absTime > 0.0) {
+				absTime += replay->timeOffset;
+			}
+
+			start = replayClock::now();
+			t->GetTrackingState(session, absTime, latencyMarker);
+			replayed = true;
+		}
+		break;
+	case callId_ovr_GetInputState:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			unsigned int mask = (unsigned int)callGetU(r);
+			int64_t recorded = callGetS(r);
+			ovrInputState inputState;
+
+			start = replayClock::now();
+			checkResult(replay, id, recorded, t->GetInputState(session, mask, &inputState));
+			replayed = true;
+		}
+		break;
+	case callId_ovr_SetControllerVibration:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			unsigned int mask = (unsigned int)callGetU(r);
+			float frequency = callGetF(r);
+			float amplitude = callGetF(r);
+			int64_t recorded = callGetS(r);
+
+			start = replayClock::now();
+			checkResult(replay, id, recorded, t->SetControllerVibration(session, mask, frequency, amplitude));
+			replayed = true;
+		}
+		break;
+	case callId_ovr_GetFovTextureSize:
+	case callId_ovr_GetRenderDesc:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			ovrEyeType eye = (ovrEyeType)callGetU(r);
+			ovrFovPort fov;
+			getFov(r, &fov);
+			float pixelsPerDisplayPixel = id == callId_ovr_GetFovTextureSize ? callGetF(r) : 0.0f;
+
+			start = replayClock::now();
+			if (id == callId_ovr_GetFovTextureSize) {
+				t->GetFovTextureSize(session, eye, fov, pixelsPerDisplayPixel);
+			}
+			else {
+				t->GetRenderDesc(session, eye, fov);
+			}
+			replayed = true;
+		}
+		break;
+	case callId_ovr_SubmitFrame:
+		{
+			bool live = getSession(replay, r, &recordedSession, &session);
+			long long frameIndex = (long long)callGetS(r);
+			int64_t recorded = callGetS(r);
+			ovrViewScaleDesc viewScaleDesc;
+			bool hasViewScale = callGetU(r) != 0;
+
+			if (hasViewScale) {
+				for (int eye = 0;eye < ovrEye_Count;eye++) {
+					viewScaleDesc.HmdToEyeViewOffset[eye].x = callGetF(r);
+					viewScaleDesc.HmdToEyeViewOffset[eye].y = callGetF(r);
+					viewScaleDesc.HmdToEyeViewOffset[eye].z = callGetF(r);
+				}
+				viewScaleDesc.HmdSpaceToWorldScaleInMeters = callGetF(r);
+			}
+
+			unsigned int layerCount = (unsigned int)callGetU(r);
+
+			if (layerCount > 32) {
+				r->error = true;
+				break;
+			}
+
+			ovrLayerHeader layers[32];
+			const ovrLayerHeader* layerPtrs[32];
+
+			for (unsigned int i = 0;i < layerCount && !r->error;i++) {
+				uint64_t type = callGetU(r);
+
+				if (type == 0) {
+					layerPtrs[i] = NULL;
+					continue;
+				}
+
+				type--;
+				layers[i].Type = ovrLayerType_Disabled;
+				layers[i].Flags = (unsigned int)callGetU(r);
+				layerPtrs[i] = &layers[i];
+
+				//the type's fields are only read to get to the next layer
+				switch (type) {
+				case ovrLayerType_EyeFov:
+				case ovrLayerType_EyeFovDepth:
+					for (int eye = 0;eye < ovrEye_Count;eye++) {
+						callGetU(r);
+						callGetS(r); callGetS(r); callGetS(r); callGetS(r);
+						skipBytes(r, 4 * sizeof(float) + 7 * sizeof(float));
+					}
+					callGetD(r);
+
+					if (type == ovrLayerType_EyeFovDepth) {
+						callGetU(r);
+						callGetU(r);
+						skipBytes(r, 3 * sizeof(float));
+					}
+					break;
+				case ovrLayerType_EyeMatrix:
+					for (int eye = 0;eye < ovrEye_Count;eye++) {
+						callGetU(r);
+						callGetS(r); callGetS(r); callGetS(r); callGetS(r);
+						skipBytes(r, 7 * sizeof(float) + sizeof(ovrMatrix4f));
+					}
+					callGetD(r);
+					break;
+				case ovrLayerType_Quad:
+					callGetU(r);
+					callGetS(r); callGetS(r); callGetS(r); callGetS(r);
+					skipBytes(r, 7 * sizeof(float) + 2 * sizeof(float));
+					break;
+				case ovrLayerType_Direct:
+					for (int eye = 0;eye < ovrEye_Count;eye++) {
+						callGetU(r);
+						callGetS(r); callGetS(r); callGetS(r); callGetS(r);
+					}
+					break;
+				}
+			}
+
+			if (replay->decode) {
+				printf(" frame %lld layers %u result %lld", frameIndex, layerCount, (long long)recorded);
+			}
+
+			if (live && t != NULL && !r->error) {
+				start = replayClock::now();
+				checkResult(replay, id, recorded, t->SubmitFrame(session, frameIndex, hasViewScale ? &viewScaleDesc : NULL, layerPtrs, layerCount));
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_GetPredictedDisplayTime:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			long long frameIndex = (long long)callGetS(r);
+
+			start = replayClock::now();
+			t->GetPredictedDisplayTime(session, frameIndex);
+			replayed = true;
+		}
+		break;
+	case callId_ovr_GetTimeInSeconds:
+		{
+			double recorded = callGetD(r);
+
+			if (t != NULL) {
+				start = replayClock::now();
+				double live = t->GetTimeInSeconds();
+				replayed = true;
+
+				replay->timeOffset = live - recorded;
+			}
+		}
+		break;
+	case callId_ovr_GetBool:
+	case callId_ovr_SetBool:
+	case callId_ovr_GetInt:
+	case callId_ovr_SetInt:
+		{
+			bool live = getSession(replay, r, &recordedSession, &session);
+			callGetStr(r, name, sizeof(name));
+			int value = (int)callGetS(r);
+
+			if (replay->decode) {
+				printf(" %s %d", name, value);
+			}
+
+			if (live && t != NULL) {
+				start = replayClock::now();
+				switch (id) {
+				case callId_ovr_GetBool:
+					t->GetBool(session, name, (ovrBool)value);
+					break;
+				case callId_ovr_SetBool:
+					t->SetBool(session, name, (ovrBool)value);
+					break;
+				case callId_ovr_GetInt:
+					t->GetInt(session, name, value);
+					break;
+				default:
+					t->SetInt(session, name, value);
+					break;
+				}
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_GetFloat:
+	case callId_ovr_SetFloat:
+		{
+			bool live = getSession(replay, r, &recordedSession, &session);
+			callGetStr(r, name, sizeof(name));
+			float value = callGetF(r);
+
+			if (replay->decode) {
+				printf(" %s %g", name, value);
+			}
+
+			if (live && t != NULL) {
+				start = replayClock::now();
+				if (id == callId_ovr_GetFloat) {
+					t->GetFloat(session, name, value);
+				}
+				else {
+					t->SetFloat(session, name, value);
+				}
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_GetFloatArray:
+	case callId_ovr_SetFloatArray:
+		{
+			bool live = getSession(replay, r, &recordedSession, &session);
+			callGetStr(r, name, sizeof(name));
+			unsigned int count = (unsigned int)callGetU(r);
+
+			if (replay->decode) {
+				printf(" %s %u", name, count);
+			}
+
+			std::vector<float> values(count > 0 ? count : 1);
+
+			if (id == callId_ovr_SetFloatArray) {
+				for (unsigned int i = 0;i < count && !r->error;i++) {
+					values[i] = callGetF(r);
+				}
+			}
+
+			if (live && t != NULL && !r->error) {
+				start = replayClock::now();
+				if (id == callId_ovr_GetFloatArray) {
+					t->GetFloatArray(session, name, values.data(), count);
+				}
+				else {
+					t->SetFloatArray(session, name, values.data(), count);
+				}
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_GetString:
+	case callId_ovr_SetString:
+		{
+			bool live = getSession(replay, r, &recordedSession, &session);
+			callGetStr(r, name, sizeof(name));
+			char value[256];
+			bool hasValue = callGetStr(r, value, sizeof(value));
+
+			if (replay->decode) {
+				printf(" %s %s", name, hasValue ? value : "(null)");
+			}
+
+			if (live && t != NULL) {
+				start = replayClock::now();
+				if (id == callId_ovr_GetString) {
+					t->GetString(session, name, hasValue ? value : NULL);
+				}
+				else {
+					t->SetString(session, name, hasValue ? value : NULL);
+				}
+				replayed = true;
+			}
+		}
+		break;
+	case callId_ovr_SetQueueAheadFraction:
+		if (getSession(replay, r, &recordedSession, &session) && t != NULL) {
+			float fraction = callGetF(r);
+			int64_t recorded = callGetS(r);
+
+			start = replayClock::now();
+			checkResult(replay, id, recorded, t->SetQueueAheadFraction(session, fraction));
+			replayed = true;
+		}
+		break;
+	default:
+		//texture creation needs the application's device, the handles are never used by the replayed layers
+		break;
+	}
+
+	if (!replay->decode) {
+		countCall(replay, id, start, replayed);
+	}
+}
+
+void printStats(Replay* replay, double replaySeconds, double recordedSeconds, double maxLateSeconds) {
+	printf("%-32s %10s %10s %10s %12s %12s %10s\n", "call", "count", "skipped", "mismatch", "mean us", "max us", "total ms");
+
+	for (int i = 0;i < callId_Count;i++) {
+		CallStats* stats = &replay->stats[i];
+
+		if (stats->count == 0) {
+			continue;
+		}
+
+		uint64_t replayed = stats->count - stats->skipped;
+
+		printf("%-32s %10llu %10llu %10llu %12.3f %12.3f %10.3f\n", callNames[i],
+			(unsigned long long)stats->count, (unsigned long long)stats->skipped, (unsigned long long)stats->resultMismatches,
+			replayed > 0 ? stats->totalSeconds * 1000000.0 / (double)replayed : 0.0,
+			stats->maxSeconds * 1000000.0, stats->totalSeconds * 1000.0);
+	}
+
+	printf("replayed %.3f s of %.3f s recorded, calls started up to %.3f ms late\n", replaySeconds, recordedSeconds, maxLateSeconds * 1000.0);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* filename = "LibOVRWrapper.calls";
+	const char* targetName = NULL;
+	bool fast = false;
+
+	static Replay replay = {};
+
+	for (int i = 1;i < argc;i++) {
+		if (strcmp(argv[i], "--decode") == 0) {
+			replay.decode = true;
+		}
+		else if (strcmp(argv[i], "--fast") == 0) {
+			fast = true;
+		}
+		else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+			targetName = argv[++i];
+		}
+		else {
+			filename = argv[i];
+		}
+	}
+
+	FILE* file = fopen(filename, "rb");
+
+	if (file == NULL) {
+		fprintf(stderr, "could not open %s\n", filename);
+		return 1;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	std::vector<uint8_t> trace(size > 0 ? (size_t)size : 1);
+	size_t read = fread(trace.data(), 1, (size_t)size, file);
+	fclose(file);
+
+	CallTraceHeader header;
+
+	if (read < sizeof(header) || (memcpy(&header, trace.data(), sizeof(header)), memcmp(header.magic, CALL_TRACE_MAGIC, sizeof(header.magic)) != 0)) {
+		fprintf(stderr, "%s is not a LibOVRWrapper call trace\n", filename);
+		return 1;
+	}
+
+	if (header.version != CALL_TRACE_VERSION || header.sdkVersion != 8) {
+		fprintf(stderr, "unsupported call trace version %u for sdk 0.%u\n", header.version, header.sdkVersion);
+		return 1;
+	}
+
+	static ReplayTarget target;
+
+	if (targetName != NULL && !replay.decode) {
+		void* library = loadTarget(targetName);
+
+		if (library == NULL) {
+			fprintf(stderr, "could not load %s\n", targetName);
+			return 1;
+		}
+
+		if (!bindTarget(library, &target)) {
+			return 1;
+		}
+
+		replay.target = &target;
+	}
+
+	CallReader reader = { trace.data() + sizeof(header), trace.data() + read, false };
+	uint64_t ticks = 0;
+	double maxLateSeconds = 0.0;
+	replayClock::time_point replayStart = replayClock::now();
+
+	while (reader.p < reader.end) {
+		callId id = (callId)callGetU(&reader);
+		uint64_t threadId = callGetU(&reader);
+		ticks += callGetU(&reader);
+		uint64_t payloadSize = callGetU(&reader);
+
+		if (reader.error || threadId == 0) {
+			break;
+		}
+
+		if ((uint64_t)(reader.end - reader.p) < payloadSize) {
+			fprintf(stderr, "trace is cut off\n");
+			break;
+		}
+
+		double recordedSeconds = (double)ticks / (double)header.ticksPerSecond;
+
+		if (replay.decode) {
+			printf("%12.3f %6llu %s", recordedSeconds * 1000.0, (unsigned long long)threadId,
+				id < callId_Count ? callNames[id] : "unknown");
+		}
+		else if (!fast) {
+			//sleep most of the way, then spin so that calls start close to their recorded time
+			replayClock::time_point due = replayStart + std::chrono::duration_cast<replayClock::duration>(std::chrono::duration<double>(recordedSeconds));
+			replayClock::time_point now = replayClock::now();
+
+			if (due - now > std::chrono::milliseconds(2)) {
+				std::this_thread::sleep_until(due - std::chrono::milliseconds(1));
+			}
+			while (replayClock::now() < due) {
+			}
+
+			double late = secondsSince(due);
+			if (late > maxLateSeconds) {
+				maxLateSeconds = late;
+			}
+		}
+
+		CallReader payload = { reader.p, reader.p + payloadSize, false };
+
+		if (id < callId_Count) {
+			replayCall(&replay, id, &payload);
+		}
+
+		if (replay.decode) {
+			printf(payload.error ? " (truncated)\n" : "\n");
+		}
+
+		reader.p += payloadSize;
+	}
+
+	if (!replay.decode) {
+		printStats(&replay, secondsSince(replayStart), (double)ticks / (double)header.ticksPerSecond, maxLateSeconds);
+	}
+
+	return 0;
+}
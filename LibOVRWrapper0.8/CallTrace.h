@@ -0,0 +1,229 @@
+#pragma once
+
+// Binary call trace format shared by the 0.8 shim's recorder and the CallReplay tool.
+// Only depends on stdint.h and string.h so the replay tool can be built without the shim's headers.
+//
+// The file starts with a CallTraceHeader followed by one record per call:
+//   varint callId, varint threadId, varint ticks since the previous record, varint payload size, payload
+// Payloads are built from varints (zigzag for signed values), raw little endian floats and doubles,
+// and strings stored as a varint length followed by the characters. A length of 0 is a NULL string,
+// any other length is one more than the number of characters.
+// The payload size lets a reader skip calls it does not know. A thread id of 0 ends the trace,
+// it is the zero filled tail of a file whose process died before the recorder closed it.
+
+#include <stdint.h>
+#include <string.h>
+
+// Every recorded entry point. New calls are only ever appended so old traces still replay.
+#define LIBOVRWRAPPER_CALLS(X) \
+	X(ovr_Initialize) \
+	X(ovr_Shutdown) \
+	X(ovr_Create) \
+	X(ovr_Destroy) \
+	X(ovr_GetSessionStatus) \
+	X(ovr_GetHmdDesc) \
+	X(ovr_RecenterPose) \
+	X(ovr_GetTrackingState) \
+	X(ovr_GetInputState) \
+	X(ovr_SetControllerVibration) \
+	X(ovr_GetFovTextureSize) \
+	X(ovr_GetRenderDesc) \
+	X(ovr_SubmitFrame) \
+	X(ovr_GetPredictedDisplayTime) \
+	X(ovr_GetTimeInSeconds) \
+	X(ovr_GetBool) \
+	X(ovr_SetBool) \
+	X(ovr_GetInt) \
+	X(ovr_SetInt) \
+	X(ovr_GetFloat) \
+	X(ovr_SetFloat) \
+	X(ovr_GetFloatArray) \
+	X(ovr_SetFloatArray) \
+	X(ovr_GetString) \
+	X(ovr_SetString) \
+	X(ovr_SetQueueAheadFraction) \
+	X(ovr_CreateSwapTextureSetD3D11) \
+	X(ovr_DestroySwapTextureSet) \
+	X(ovr_CreateMirrorTextureD3D11) \
+	X(ovr_DestroyMirrorTexture)
+
+enum callId
+{
+#define X(name) callId_##name,
+	LIBOVRWRAPPER_CALLS(X)
+#undef X
+	callId_Count
+};
+
+#define CALL_TRACE_MAGIC "OVRCALLS"
+#define CALL_TRACE_VERSION 1
+
+typedef struct CallTraceHeader_
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t sdkVersion; // minor version of the recorded shim's API, 8 for LibOVRWrapper0.8
+	uint64_t ticksPerSecond; // QueryPerformanceFrequency of the recording machine
+	uint64_t startTicks; // QueryPerformanceCounter when recording started, the first delta counts from here
+} CallTraceHeader;
+
+#define callMaxPayload 8192 // enough for ovr_SubmitFrame with 32 layers of the largest type
+
+// Encoder over a fixed buffer, a payload that does not fit marks the writer as overflowed
+typedef struct CallWriter_
+{
+	uint8_t data[callMaxPayload];
+	uint32_t size;
+	bool overflow;
+} CallWriter;
+
+inline void callWriterInit(CallWriter* w) {
+	w->size = 0;
+	w->overflow = false;
+}
+
+inline void callPutBytes(CallWriter* w, const void* bytes, uint32_t count) {
+	if (w->overflow || count > callMaxPayload - w->size) {
+		w->overflow = true;
+		return;
+	}
+
+	memcpy(w->data + w->size, bytes, count);
+	w->size += count;
+}
+
+inline uint32_t callEncodeVarint(uint8_t* out, uint64_t value) {
+	uint32_t n = 0;
+
+	while (value >= 0x80) {
+		out[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	out[n++] = (uint8_t)value;
+
+	return n;
+}
+
+inline void callPutU(CallWriter* w, uint64_t value) {
+	uint8_t bytes[10];
+
+	callPutBytes(w, bytes, callEncodeVarint(bytes, value));
+}
+
+inline void callPutS(CallWriter* w, int64_t value) {
+	callPutU(w, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+inline void callPutF(CallWriter* w, float value) {
+	callPutBytes(w, &value, sizeof(value));
+}
+
+inline void callPutD(CallWriter* w, double value) {
+	callPutBytes(w, &value, sizeof(value));
+}
+
+inline void callPutPtr(CallWriter* w, const void* value) {
+	callPutU(w, (uint64_t)(uintptr_t)value);
+}
+
+inline void callPutStr(CallWriter* w, const char* value) {
+	if (value == NULL) {
+		callPutU(w, 0);
+		return;
+	}
+
+	uint32_t length = (uint32_t)strlen(value);
+
+	callPutU(w, (uint64_t)length + 1);
+	callPutBytes(w, value, length);
+}
+
+// Decoder over a record's payload, reading past the end marks the reader as failed and yields zeros
+typedef struct CallReader_
+{
+	const uint8_t* p;
+	const uint8_t* end;
+	bool error;
+} CallReader;
+
+inline uint64_t callGetU(CallReader* r) {
+	uint64_t value = 0;
+
+	for (int shift = 0;shift < 64;shift += 7) {
+		if (r->p >= r->end) {
+			r->error = true;
+			return 0;
+		}
+
+		uint8_t b = *r->p++;
+		value |= (uint64_t)(b & 0x7f) << shift;
+
+		if (!(b & 0x80)) {
+			return value;
+		}
+	}
+
+	r->error = true;
+
+	return 0;
+}
+
+inline int64_t callGetS(CallReader* r) {
+	uint64_t value = callGetU(r);
+
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+inline bool callGetBytes(CallReader* r, void* bytes, uint32_t count) {
+	if (r->error || (uint64_t)(r->end - r->p) < count) {
+		r->error = true;
+		memset(bytes, 0, count);
+		return false;
+	}
+
+	memcpy(bytes, r->p, count);
+	r->p += count;
+
+	return true;
+}
+
+inline float callGetF(CallReader* r) {
+	float value;
+
+	callGetBytes(r, &value, sizeof(value));
+
+	return value;
+}
+
+inline double callGetD(CallReader* r) {
+	double value;
+
+	callGetBytes(r, &value, sizeof(value));
+
+	return value;
+}
+
+// Copies the string into buffer, truncated to its size. Returns false for a NULL string.
+inline bool callGetStr(CallReader* r, char* buffer, uint32_t bufferSize) {
+	uint64_t length = callGetU(r);
+
+	buffer[0] = '\0';
+
+	if (length == 0) {
+		return false;
+	}
+
+	length--;
+
+	if (r->error || (uint64_t)(r->end - r->p) < length) {
+		r->error = true;
+		return true;
+	}
+
+	uint32_t copied = length < bufferSize ? (uint32_t)length : bufferSize - 1;
+	memcpy(buffer, r->p, copied);
+	buffer[copied] = '\0';
+	r->p += length;
+
+	return true;
+}
@@ -14,15 +14,29 @@
 
 #include "shimhelper.h"
 #include "OVRShim.h"
+#include "CallRecorder.h"
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Initialize(const ovrInitParams* params) {
-	initChains();
+	WrapperSettings* settings = getWrapperSettings();
 
-	return rev_Initialize((revInitParams*)params);
+	//recording spans every initialize/shutdown cycle of the process, the file is closed when the dll unloads
+	if (!globalCallRecording && settings->callTraceFile[0] != '\0') {
+		callRecordStart(settings->callTraceFile);
+	}
+
+	ovrResult r = rev_Initialize((revInitParams*)params);
+
+	CALL_RECORD(recordInitialize(params, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Shutdown() {
+	flushAllPropertyCaches();
+
 	rev_Shutdown();
+
+	CALL_RECORD(recordCall(callId_ovr_Shutdown));
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_GetLastErrorInfo(ovrErrorInfo* errorInfo) {
@@ -37,7 +51,7 @@ OVR_PUBLIC_FUNCTION(int) ovr_TraceMessage(int level, const char* message) {
 	return rev_TraceMessage(level, message);
 }
 
-OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session) {
+ovrHmdDesc buildHmdDesc(revSession session) {
 	revHmdDesc desc = rev_GetHmdDesc((revSession)session);
 
 	ovrHmdDesc d;
@@ -78,19 +92,67 @@ OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session) {
 	return d;
 }
 
+//the cached descriptor, without recording a call, for the functions answered from it
+ovrHmdDesc getHmdDesc(ovrSession session) {
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	//the descriptor only changes on device changes, so avoid the runtime round trips on every call
+	if (state == NULL) {
+		return buildHmdDesc((revSession)session);
+	}
+
+	ovrHmdDesc desc;
+	unsigned int generation;
+
+	if (!loadHmdDesc(state, &desc, &generation)) {
+		desc = buildHmdDesc((revSession)session);
+		storeHmdDesc(state, &desc, generation);
+	}
+
+	releaseSessionState(state);
+
+	return desc;
+}
+
+OVR_PUBLIC_FUNCTION(ovrHmdDesc) ovr_GetHmdDesc(ovrSession session) {
+	CALL_RECORD(recordSessionCall(callId_ovr_GetHmdDesc, session));
+
+	return getHmdDesc(session);
+}
+
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Create(ovrSession* pSession, ovrGraphicsLuid* pLuid) {
 	ovrResult r = rev_Create((revSession*)pSession, (revGraphicsLuid*)pLuid);
 
 	if (!OVR_SUCCESS(r)) {
+		CALL_RECORD(recordCreate(NULL, r));
+
 		return r;
 	}
 
+	ovrSessionState* state = createSessionState(*(revSession*)pSession);
+
+	if (state == NULL) {
+		rev_Destroy(*(revSession*)pSession);
+
+		return ovrError_MemoryAllocationFailure;
+	}
+
+	ovrHmdDesc desc = buildHmdDesc(*(revSession*)pSession);
+	state->hmdPresent = ovrTrue;
+	storeHmdDesc(state, &desc, 0);
+
 	rev_SetTrackingOriginType(*(revSession*)pSession, revTrackingOrigin_EyeLevel);
 
+	CALL_RECORD(recordCreate(*pSession, r));
+
 	return r;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_Destroy(ovrSession session) {
+	CALL_RECORD(recordSessionCall(callId_ovr_Destroy, session));
+
+	destroySessionState((revSession)session);
+
 	rev_Destroy((revSession)session);
 }
 
@@ -102,20 +164,33 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessi
 	sessionStatus->HmdPresent = status.HmdPresent;
 	sessionStatus->HasVrFocus = status.IsVisible;
 
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	if (state != NULL) {
+		observeHmdPresent(state, status.HmdPresent);
+	}
+
 	if (status.ShouldRecenter) {
 		rev_RecenterTrackingOrigin((revSession)session);
 
+		if (state != NULL) {
+			invalidateTrackingSnapshots(state);
+			invalidateHmdDesc(state);
+		}
+
 		//or ovr_ClearShouldRecenterFlag?
 	}
 
+	releaseSessionState(state);
+
+	CALL_RECORD(recordGetSessionStatus(session, sessionStatus, r));
+
 	return r;
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetEnabledCaps(ovrSession session) {
-	revHmdDesc desc = rev_GetHmdDesc((revSession)session);
-
 	//not possible anymore
-	return desc.DefaultHmdCaps;
+	return getHmdDesc(session).DefaultHmdCaps;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_SetEnabledCaps(ovrSession session, unsigned int hmdCaps) {
@@ -123,9 +198,7 @@ OVR_PUBLIC_FUNCTION(void) ovr_SetEnabledCaps(ovrSession session, unsigned int hm
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetTrackingCaps(ovrSession session) {
-	revHmdDesc desc = rev_GetHmdDesc((revSession)session);
-
-	return desc.DefaultTrackingCaps;
+	return getHmdDesc(session).DefaultTrackingCaps;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_ConfigureTracking(ovrSession session, unsigned int requestedTrackingCaps,
@@ -135,7 +208,18 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_ConfigureTracking(ovrSession session, unsigne
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_RecenterPose(ovrSession session) {
+	CALL_RECORD(recordSessionCall(callId_ovr_RecenterPose, session));
+
 	rev_RecenterTrackingOrigin((revSession)session);
+
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	if (state != NULL) {
+		invalidateTrackingSnapshots(state);
+		invalidateHmdDesc(state);
+	}
+
+	releaseSessionState(state);
 }
 
 void copyPose(ovrPosef* dest, const revPosef* source) {
@@ -158,6 +242,21 @@ void copyPoseState(ovrPoseStatef* dest, const revPoseStatef* source) {
 }
 
 OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, double absTime, ovrBool latencyMarker) {
+	ovrSessionState* sessionState = acquireSessionState((revSession)session);
+
+	//a latency marker tells the runtime when the frame sampled tracking, so that query always has to reach it
+	if (sessionState != NULL && !latencyMarker) {
+		ovrTrackingState snapshot;
+
+		if (findTrackingSnapshot(sessionState, absTime, &snapshot)) {
+			releaseSessionState(sessionState);
+
+			CALL_RECORD(recordGetTrackingState(session, absTime, latencyMarker, &snapshot));
+
+			return snapshot;
+		}
+	}
+
 	revTrackingState state = rev_GetTrackingState((revSession)session, absTime, latencyMarker);
 	revTrackerPose tpose = rev_GetTrackerPose((revSession)session, 0);
 
@@ -179,7 +278,15 @@ OVR_PUBLIC_FUNCTION(ovrTrackingState) ovr_GetTrackingState(ovrSession session, d
 
 	//r.RawSensorData not filled
 	r.StatusFlags = state.StatusFlags | ovrStatus_CameraPoseTracked | ovrStatus_PositionConnected | ovrStatus_HmdConnected;
-	
+
+	if (sessionState != NULL) {
+		storeTrackingSnapshot(sessionState, absTime, &r);
+	}
+
+	releaseSessionState(sessionState);
+
+	CALL_RECORD(recordGetTrackingState(session, absTime, latencyMarker, &r));
+
 	return r;
 }
 
@@ -189,6 +296,8 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, unsigned in
 	ovrResult res = rev_GetInputState((revSession)session, (revControllerType)controllerTypeMask, &state);
 
 	if (res < 0) {
+		CALL_RECORD(recordGetInputState(session, controllerTypeMask, inputState, res));
+
 		return res;
 	}
 
@@ -206,21 +315,31 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetInputState(ovrSession session, unsigned in
 	inputState->TimeInSeconds = state.TimeInSeconds;
 	inputState->Touches = state.Touches;
 
+	CALL_RECORD(recordGetInputState(session, controllerTypeMask, inputState, res));
+
 	return res;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetControllerVibration(ovrSession session, unsigned int controllerTypeMask,
 	float frequency, float amplitude) {
-	return rev_SetControllerVibration((revSession)session, (revControllerType)controllerTypeMask, frequency, amplitude);
+	ovrResult r = rev_SetControllerVibration((revSession)session, (revControllerType)controllerTypeMask, frequency, amplitude);
+
+	CALL_RECORD(recordSetControllerVibration(session, controllerTypeMask, frequency, amplitude, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_DestroySwapTextureSet(ovrSession session, ovrSwapTextureSet* textureSet) {	
+	CALL_RECORD(recordSessionObject(callId_ovr_DestroySwapTextureSet, session, textureSet));
+
 	rev_DestroyTextureSwapChain((revSession)session, getChain((revSession)session, textureSet)->swapChain);
 
 	removeChain((revSession)session, textureSet);
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_DestroyMirrorTexture(ovrSession session, ovrTexture* mirrorTexture) {
+	CALL_RECORD(recordSessionObject(callId_ovr_DestroyMirrorTexture, session, mirrorTexture));
+
 	revMirrorTexture* mirror = getMirror();
 
 	rev_DestroyMirrorTexture((revSession)session, *mirror);
@@ -242,7 +361,11 @@ OVR_PUBLIC_FUNCTION(ovrSizei) ovr_GetFovTextureSize(ovrSession session, ovrEyeTy
 	fport.RightTan = fov.RightTan;
 	fport.UpTan = fov.UpTan;
 
-	return *(ovrSizei *)&rev_GetFovTextureSize((revSession)session, (revEyeType)eye, fport, pixelsPerDisplayPixel);
+	ovrSizei r = *(ovrSizei *)&rev_GetFovTextureSize((revSession)session, (revEyeType)eye, fport, pixelsPerDisplayPixel);
+
+	CALL_RECORD(recordGetFovTextureSize(session, eye, fov, pixelsPerDisplayPixel, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session,
@@ -256,6 +379,8 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session,
 
 	revEyeRenderDesc desc = rev_GetRenderDesc((revSession)session, (revEyeType)eyeType, fport);
 
+	CALL_RECORD(recordGetRenderDesc(session, eyeType, fov));
+
 	ovrEyeRenderDesc r;
 
 	r.DistortedViewport = *(ovrRecti*)&desc.DistortedViewport;
@@ -270,18 +395,17 @@ OVR_PUBLIC_FUNCTION(ovrEyeRenderDesc) ovr_GetRenderDesc(ovrSession session,
 	return r;
 }
 
-revTextureSwapChain renderChain(revSession session, ovrSwapTextureSet* ts)
+revTextureSwapChain renderChain(ovrSessionState* state, ovrSwapTextureSet* ts)
 {
-	ovrTextureSwapChainWrapper* chainwrapper = getChain(session, ts);
-
-	int currentIndex = 0;
-	rev_GetTextureSwapChainCurrentIndex(session, chainwrapper->swapChain, &currentIndex);
+	SwapChainCommitResult result = commitChain(state->session, ts, state->submitSerial);
 
-	CopyTexture(chainwrapper->pContext, chainwrapper->textures[currentIndex], &ts->Textures[ts->CurrentIndex]);	
-	
-	rev_CommitTextureSwapChain(session, chainwrapper->swapChain);
+	if (result == swapChainCommitCopied) {
+		state->copiesDone++;
+	} else if (result == swapChainCommitSkipped) {
+		state->copiesSkipped++;
+	}
 
-	return chainwrapper->swapChain;
+	return getChain(state->session, ts)->swapChain;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long frameIndex,
@@ -290,18 +414,21 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 
 	//ovrLayerType 2, 6 do not exists anymore. max layer count is 16 instead of 32
 
-	unsigned int trueLayerCount = 0;
-	for (unsigned int i = 0;i < layerCount;i++) {
-		if (layerPtrList[i] != NULL) {
-			trueLayerCount++;
-		}
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	if (state == NULL) {
+		CALL_RECORD(recordSubmitFrame(session, frameIndex, viewScaleDesc, layerPtrList, layerCount, ovrError_InvalidSession));
+
+		return ovrError_InvalidSession;
 	}
 
-	if (trueLayerCount > 16) {
-		trueLayerCount = 16; //ignore layer counts > 16
-	}	
+	//every call commits a set once, however many of its layers show it; 0 is kept for sets that were never committed
+	if (++state->submitSerial == 0) {
+		state->submitSerial = 1;
+	}
 
-	revLayerHeader** newlayers = (revLayerHeader**)malloc(sizeof(revLayerHeader*) * trueLayerCount);
+	//layers are translated into the session's arena, so nothing is allocated per frame
+	revLayerHeader** newlayers = state->layerPtrs;
 	
 	unsigned int np = 0;
 
@@ -314,15 +441,15 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 
 		if (layer->Type == ovrLayerType_EyeFov) {
 			const ovrLayerEyeFov* oldelayer = (const ovrLayerEyeFov*)layer;
-			revLayerEyeFov *elayer = (revLayerEyeFov*)malloc(sizeof(revLayerEyeFov));
+			revLayerEyeFov *elayer = &state->layers[np].EyeFov;
 
 			//if both eyes use same swaptextureset
 			if (oldelayer->ColorTexture[0] == oldelayer->ColorTexture[1]) {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
 				elayer->ColorTexture[1] = elayer->ColorTexture[0];
 			} else {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
-				elayer->ColorTexture[1] = renderChain((revSession)session, oldelayer->ColorTexture[1]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[1] = renderChain(state, oldelayer->ColorTexture[1]);
 			}		
 			
 			elayer->Fov[0].DownTan = oldelayer->Fov[0].DownTan;
@@ -343,21 +470,19 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 			elayer->SensorSampleTime = oldelayer->SensorSampleTime;
 			elayer->Viewport[0] = *(revRecti*)&oldelayer->Viewport[0];
 			elayer->Viewport[1] = *(revRecti*)&oldelayer->Viewport[1];
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else if (layer->Type == ovrLayerType_EyeMatrix) {
 			const ovrLayerEyeMatrix* oldelayer = (const ovrLayerEyeMatrix*)layer;
-			revLayerEyeMatrix *elayer = (revLayerEyeMatrix*)malloc(sizeof(revLayerEyeMatrix));
+			revLayerEyeMatrix *elayer = &state->layers[np].EyeMatrix;
 
 			//if both eyes use same swaptextureset
 			if (oldelayer->ColorTexture[0] == oldelayer->ColorTexture[1]) {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
 				elayer->ColorTexture[1] = elayer->ColorTexture[0];
 			}
 			else {
-				elayer->ColorTexture[0] = renderChain((revSession)session, oldelayer->ColorTexture[0]);
-				elayer->ColorTexture[1] = renderChain((revSession)session, oldelayer->ColorTexture[1]);
+				elayer->ColorTexture[0] = renderChain(state, oldelayer->ColorTexture[0]);
+				elayer->ColorTexture[1] = renderChain(state, oldelayer->ColorTexture[1]);
 			}
 
 			elayer->Matrix[0] = *(revMatrix4f *)&oldelayer->Matrix[0];
@@ -372,31 +497,27 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 			elayer->SensorSampleTime = oldelayer->SensorSampleTime;
 			elayer->Viewport[0] = *(revRecti*)&oldelayer->Viewport[0];
 			elayer->Viewport[1] = *(revRecti*)&oldelayer->Viewport[1];
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else if (layer->Type == ovrLayerType_Quad) {
 			const ovrLayerQuad* oldelayer = (const ovrLayerQuad*)layer;
-			revLayerQuad *elayer = (revLayerQuad*)malloc(sizeof(revLayerQuad));
+			revLayerQuad *elayer = &state->layers[np].Quad;
 
 			elayer->Header.Type = revLayerType_Quad;
 			elayer->Header.Flags = layer->Flags;
 
-			elayer->ColorTexture = renderChain((revSession)session, oldelayer->ColorTexture);
+			elayer->ColorTexture = renderChain(state, oldelayer->ColorTexture);
 			
+			elayer->Viewport = *(revRecti*)&oldelayer->Viewport;
+
 			copyPoseR(&elayer->QuadPoseCenter, &oldelayer->QuadPoseCenter);
 
 			elayer->QuadSize = *(revVector2f *)&oldelayer->QuadSize;
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else if (layer->Type == ovrLayerType_Disabled) {			
-			revLayerHeader *elayer = (revLayerHeader*)malloc(sizeof(revLayerHeader));
+			revLayerHeader *elayer = &state->layers[np].Header;
 
 			elayer->Flags = layer->Flags;
 			elayer->Type = (revLayerType)layer->Type;
-
-			newlayers[np] = (revLayerHeader*)elayer;
 		}
 		else {
 			continue; //ignore unsupported layers
@@ -404,28 +525,40 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 
 		np++;
 
-		if (np > 15) {
+		if (np >= ovrMaxLayerCount) {
 			break;
 		}
 	}
 	
-	ovrResult r = rev_SubmitFrame((revSession)session, frameIndex, (const revViewScaleDesc*)viewScaleDesc, newlayers, trueLayerCount);
+	ovrResult r = rev_SubmitFrame((revSession)session, frameIndex, (const revViewScaleDesc*)viewScaleDesc, newlayers, np);
 
-	for (unsigned int i = 0;i < trueLayerCount;i++) {
-		free(newlayers[i]);
-	}
+	//tracking snapshots are only shared between queries made for the same frame
+	advanceTrackingFrame(state);
+
+	//pending property writes of the frame reach the runtime in one go
+	propertyCacheFlush(&state->properties, (revSession)session);
 
-	free(newlayers);
+	releaseSessionState(state);
+
+	CALL_RECORD(recordSubmitFrame(session, frameIndex, viewScaleDesc, layerPtrList, layerCount, r));
 
 	return r;
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long long frameIndex) {
-	return rev_GetPredictedDisplayTime((revSession)session, frameIndex);
+	double r = rev_GetPredictedDisplayTime((revSession)session, frameIndex);
+
+	CALL_RECORD(recordGetPredictedDisplayTime(session, frameIndex, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds() {
-	return rev_GetTimeInSeconds();
+	double r = rev_GetTimeInSeconds();
+
+	CALL_RECORD(recordGetTimeInSeconds(r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(void) ovr_ResetBackOfHeadTracking(ovrSession session) {
@@ -437,62 +570,153 @@ OVR_PUBLIC_FUNCTION(void) ovr_ResetMulticameraTracking(ovrSession session) {
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_GetBool(ovrSession session, const char* propertyName, ovrBool defaultVal) {
-	return rev_GetBool((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = propertyCacheGetBool(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordPropertyInt(callId_ovr_GetBool, session, propertyName, defaultVal, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetBool(ovrSession session, const char* propertyName, ovrBool value) {
-	return rev_SetBool((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = propertyCacheSetBool(getPropertyCache(state), (revSession)session, propertyName, value);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordPropertyInt(callId_ovr_SetBool, session, propertyName, value, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(int) ovr_GetInt(ovrSession session, const char* propertyName, int defaultVal) {
-	return rev_GetInt((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	int value;
+
+	if (!getWrapperInt(state, propertyName, &value)) {
+		value = propertyCacheGetInt(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+	}
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordPropertyInt(callId_ovr_GetInt, session, propertyName, defaultVal, value));
+
+	return value;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetInt(ovrSession session, const char* propertyName, int value) {
-	return rev_SetInt((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = propertyCacheSetInt(getPropertyCache(state), (revSession)session, propertyName, value);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordPropertyInt(callId_ovr_SetInt, session, propertyName, value, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(float) ovr_GetFloat(ovrSession session, const char* propertyName, float defaultVal) {
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	float r;
+
 	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
 		float values[2];
-		rev_GetFloatArray((revSession)session, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
+		propertyCacheGetFloatArray(getPropertyCache(state), (revSession)session, REV_KEY_NECK_TO_EYE_DISTANCE_, values, 2);
 
-		return values[0] + values[1];
+		r = values[0] + values[1];
+	}
+	else {
+		r = propertyCacheGetFloat(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
 	}
 
-	return rev_GetFloat((revSession)session, propertyName, defaultVal);
+	releaseSessionState(state);
+
+	CALL_RECORD(recordGetFloat(session, propertyName, defaultVal, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloat(ovrSession session, const char* propertyName, float value) {
-	if (strcmp(propertyName, OVR_KEY_IPD) == 0) {
-		return ovrFalse;
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = ovrFalse;
+
+	if (strcmp(propertyName, OVR_KEY_IPD) != 0) {
+		r = propertyCacheSetFloat(getPropertyCache(state), (revSession)session, propertyName, value);
 	}
 
-	return rev_SetFloat((revSession)session, propertyName, value);
+	releaseSessionState(state);
+
+	CALL_RECORD(recordSetFloat(session, propertyName, value, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrSession session, const char* propertyName,
 	float values[], unsigned int valuesCapacity) {
-	return rev_GetFloatArray((revSession)session, propertyName, values, valuesCapacity);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	unsigned int r = propertyCacheGetFloatArray(getPropertyCache(state), (revSession)session, propertyName, values, valuesCapacity);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordGetFloatArray(session, propertyName, values, valuesCapacity, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetFloatArray(ovrSession session, const char* propertyName,
 	const float values[], unsigned int valuesSize) {
-	return rev_SetFloatArray((revSession)session, propertyName, values, valuesSize);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = propertyCacheSetFloatArray(getPropertyCache(state), (revSession)session, propertyName, values, valuesSize);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordSetFloatArray(session, propertyName, values, valuesSize, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(const char*) ovr_GetString(ovrSession session, const char* propertyName,
 	const char* defaultVal) {
-	return rev_GetString((revSession)session, propertyName, defaultVal);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	const char* r = propertyCacheGetString(getPropertyCache(state), (revSession)session, propertyName, defaultVal);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordGetString(session, propertyName, defaultVal, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrBool) ovr_SetString(ovrSession session, const char* propertyName,
 	const char* value) {
-	return rev_SetString((revSession)session, propertyName, value);
+	ovrSessionState* state = acquireSessionState((revSession)session);
+
+	ovrBool r = propertyCacheSetString(getPropertyCache(state), (revSession)session, propertyName, value);
+
+	releaseSessionState(state);
+
+	CALL_RECORD(recordSetString(session, propertyName, value, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_SetQueueAheadFraction(ovrSession session, float queueAheadFraction) {
-	return rev_SetQueueAheadFraction((revSession)session, queueAheadFraction);
+	ovrResult r = rev_SetQueueAheadFraction((revSession)session, queueAheadFraction);
+
+	CALL_RECORD(recordSetQueueAheadFraction(session, queueAheadFraction, r));
+
+	return r;
 }
 
 OVR_PUBLIC_FUNCTION(ovrResult) ovr_Lookup(const char* name, void** data) {
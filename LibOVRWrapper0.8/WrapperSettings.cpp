@@ -0,0 +1,19 @@
+#include "WrapperSettings.h"
+
+
+
+WrapperSettings::WrapperSettings(): 
+	swapTextureAliasingEnabled(false),
+	skipUnchangedSwapTextures(false),
+	trackingSnapshotsEnabled(true),
+	trackingSnapshotTolerance(0.0),
+	propertyCacheEnabled(true),
+	propertyCacheLifetimeMs(1000)
+{
+	callTraceFile[0] = '\0';
+}
+
+
+WrapperSettings::~WrapperSettings()
+{
+}
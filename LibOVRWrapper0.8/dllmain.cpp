@@ -1,6 +1,9 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
 #include "stdafx.h"
 
+#include "shimhelper.h"
+#include "CallRecorder.h"
+
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
                        LPVOID lpReserved
@@ -9,9 +12,27 @@ BOOL APIENTRY DllMain( HMODULE hModule,
 	switch (ul_reason_for_call)
 	{
 	case DLL_PROCESS_ATTACH:
+		{
+			const char inifile[] = ".\\LibOVRWrapper.ini";
+
+			auto settings = new WrapperSettings();
+
+			settings->swapTextureAliasingEnabled = GetPrivateProfileIntA("graphics", "swapTextureAliasingEnabled", 0, inifile) != 0;
+			settings->skipUnchangedSwapTextures = GetPrivateProfileIntA("graphics", "skipUnchangedSwapTextures", 0, inifile) != 0;
+			settings->trackingSnapshotsEnabled = GetPrivateProfileIntA("tracking", "snapshotsEnabled", 1, inifile) != 0;
+			settings->trackingSnapshotTolerance = (int)GetPrivateProfileIntA("tracking", "snapshotToleranceUs", 0, inifile) / 1000000.0;
+			settings->propertyCacheEnabled = GetPrivateProfileIntA("properties", "cacheEnabled", 1, inifile) != 0;
+			settings->propertyCacheLifetimeMs = GetPrivateProfileIntA("properties", "cacheLifetimeMs", 1000, inifile);
+			GetPrivateProfileStringA("tracing", "callTraceFile", "", settings->callTraceFile, sizeof(settings->callTraceFile), inifile);
+
+			setWrapperSettings(settings);
+		}
+		break;
+	case DLL_PROCESS_DETACH:
+		callRecordStop(lpReserved != NULL);
+		break;
 	case DLL_THREAD_ATTACH:
 	case DLL_THREAD_DETACH:
-	case DLL_PROCESS_DETACH:
 		break;
 	}
 	return TRUE;
@@ -2,6 +2,9 @@
 
 #include "stdafx.h"
 #include "d3d11.h"
+#include "../LibOVRWrapperShared/PropertyCache.h"
+#include "../LibOVRWrapperShared/SwapChainMirror.h"
+#include "../LibOVRWrapperShared/SwapChainCommit.h"
 
 #include "../LibOVR0.8/Include/OVR_CAPI_0_8_0.h"
 
@@ -15,15 +18,113 @@ typedef struct ovrTextureSwapChainWrapper_
 {
 	revTextureSwapChain swapChain;
 	int textureCount;
+	SwapChainMirror mirror; // ring index of swapChain, kept without asking the runtime
 	ID3D11Texture2D** textures;	
 	ID3D11DeviceContext* pContext;	
+	SwapChainCommit commit; // aliasing and the last commit of the set, see swapChainCommit
+	struct ovrTextureSwapChainWrapper_* next;
 } ovrTextureSwapChainWrapper;
 
+#define ovrSwapTextureSetTag 0x53545357
+
+// Read only counters of texture copies done and skipped by renderChain, served by ovr_GetInt
+#define WRAPPER_KEY_COPIES_DONE "LibOVRWrapper.CopiesDone"
+#define WRAPPER_KEY_COPIES_SKIPPED "LibOVRWrapper.CopiesSkipped"
+
+// Read only counters of tracking state queries answered from a snapshot and from the runtime
+#define WRAPPER_KEY_TRACKING_HITS "LibOVRWrapper.TrackingSnapshotHits"
+#define WRAPPER_KEY_TRACKING_MISSES "LibOVRWrapper.TrackingSnapshotMisses"
+
+// The ovrSwapTextureSet handed to the application is allocated in one block with its wrapper,
+// so the wrapper is reached from the set pointer without any lookup.
+typedef struct ovrSwapTextureSetBlock_
+{
+	ovrSwapTextureSet textureSet;
+	unsigned int tag;
+	ovrTextureSwapChainWrapper chain;
+} ovrSwapTextureSetBlock;
+
+inline ovrTextureSwapChainWrapper* getChain(revSession session, ovrSwapTextureSet* ts) {
+	ovrSwapTextureSetBlock* block = (ovrSwapTextureSetBlock*)ts;
+
+	assert(block->tag == ovrSwapTextureSetTag);
+
+	return &block->chain;
+}
+
+#define ovrMaxLayerCount 16
+#define ovrTrackingSnapshotCount 4
+
+// A translated tracking state, reused for queries of the same absTime within one submitted frame
+typedef struct ovrTrackingSnapshot_
+{
+	double absTime;
+	unsigned int frame; // ovrSessionState::trackingFrame the snapshot was taken in
+	bool valid;
+	ovrTrackingState state;
+} ovrTrackingSnapshot;
+
+// Large enough to hold any layer type that can be passed to rev_SubmitFrame
+typedef union revLayerSlot_
+{
+	revLayerHeader Header;
+	revLayerEyeFov EyeFov;
+	revLayerEyeMatrix EyeMatrix;
+	revLayerQuad Quad;
+} revLayerSlot;
+
+// Per-session state, allocated in ovr_Create and released in ovr_Destroy.
+// The layer arena is reused by ovr_SubmitFrame every frame so that submission does not allocate.
+// The chain list keeps the swap texture sets created on the session for validation and teardown.
+typedef struct ovrSessionState_
+{
+	revSession session;
+	volatile LONG users; // the session list's reference and one per call using the state, see acquireSessionState
+	SRWLOCK chainsLock; // guards the chain list, swap texture sets are created and destroyed from any thread
+	revLayerSlot layers[ovrMaxLayerCount];
+	revLayerHeader* layerPtrs[ovrMaxLayerCount];
+	ovrTextureSwapChainWrapper* chains;
+	unsigned int submitSerial; // advanced by every ovr_SubmitFrame, identifies the call to swapChainCommit
+	unsigned int copiesDone;
+	unsigned int copiesSkipped;
+	SRWLOCK hmdDescLock; // guards the descriptor, hmdPresent and the generation, ovr_GetHmdDesc may be called from several threads
+	ovrHmdDesc hmdDesc; // served by ovr_GetHmdDesc until invalidateHmdDesc is called
+	bool hmdDescValid;
+	unsigned int hmdDescGeneration; // advanced by every invalidation, a descriptor built before one is not stored
+	ovrBool hmdPresent;
+	SRWLOCK trackingLock; // guards the snapshots and trackingFrame, tracking is queried from several threads
+	ovrTrackingSnapshot snapshots[ovrTrackingSnapshotCount];
+	unsigned int nextSnapshot;
+	unsigned int trackingFrame; // advanced by every ovr_SubmitFrame, snapshots never outlive it
+	volatile LONG trackingHits; // counted with InterlockedIncrement, lookups only hold trackingLock shared
+	volatile LONG trackingMisses;
+	PropertyCache properties; // flushed by every submitted frame, before the session is destroyed and at shutdown
+	struct ovrSessionState_* next;
+} ovrSessionState;
+
+WrapperSettings* getWrapperSettings();
+void setWrapperSettings(WrapperSettings* settings);
+
 EXTERNC HRESULT wrapCreateShaderResourceView(ID3D11Device* device, ID3D11Resource* resource, ID3D11ShaderResourceView** srv);
-EXTERNC ovrTextureSwapChainWrapper* getChain(revSession session, ovrSwapTextureSet* ts);
-EXTERNC void setChain(revSession session, ovrSwapTextureSet* ts, ovrTextureSwapChainWrapper* chain);
-EXTERNC void initChains();
+EXTERNC ovrSwapTextureSet* createChain(revSession session, ovrTextureSwapChainWrapper** outChain);
 EXTERNC void removeChain(revSession session, ovrSwapTextureSet* ts);
+EXTERNC void syncAliasedIndex(revSession session, ovrSwapTextureSet* ts);
+EXTERNC SwapChainCommitResult commitChain(revSession session, ovrSwapTextureSet* ts, unsigned int submitSerial);
+EXTERNC ovrSessionState* createSessionState(revSession session);
+EXTERNC ovrSessionState* acquireSessionState(revSession session);
+EXTERNC void releaseSessionState(ovrSessionState* state);
+EXTERNC void destroySessionState(revSession session);
+EXTERNC PropertyCache* getPropertyCache(ovrSessionState* state);
+EXTERNC void flushAllPropertyCaches();
+EXTERNC bool getWrapperInt(ovrSessionState* state, const char* propertyName, int* value);
+EXTERNC bool findTrackingSnapshot(ovrSessionState* state, double absTime, ovrTrackingState* outState);
+EXTERNC void storeTrackingSnapshot(ovrSessionState* state, double absTime, const ovrTrackingState* trackingState);
+EXTERNC void advanceTrackingFrame(ovrSessionState* state);
+EXTERNC void invalidateTrackingSnapshots(ovrSessionState* state);
+EXTERNC bool loadHmdDesc(ovrSessionState* state, ovrHmdDesc* outDesc, unsigned int* outGeneration);
+EXTERNC void storeHmdDesc(ovrSessionState* state, const ovrHmdDesc* desc, unsigned int generation);
+EXTERNC void observeHmdPresent(ovrSessionState* state, ovrBool hmdPresent);
+EXTERNC void invalidateHmdDesc(ovrSessionState* state);
 EXTERNC void setMirror(revMirrorTexture* mirror);
 EXTERNC revMirrorTexture* getMirror();
 EXTERNC ovrResult makeD3D11Texture(IUnknown* device,
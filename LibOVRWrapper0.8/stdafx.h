@@ -20,6 +20,8 @@
 #include <windows.h>
 
 // reference additional headers your program requires here
+#include "WrapperSettings.h"
+
 #include "../LibREV/Include/REV_CAPI.h"
 #include "../LibREV/Include/REV_Version.h"
 #include "../LibREV/Include/REV_ErrorCode.h"
@@ -0,0 +1,529 @@
+#include "PropertyCache.h"
+
+#include <string.h>
+
+// ovr_GetString only guarantees its result until the next call, a copy per thread can't be
+// overwritten by another thread fetching or evicting the entry
+thread_local char propertyCacheString[propertyCacheStringLength];
+
+void propertyCacheInit(PropertyCache* cache, bool enabled, double lifetime) {
+	memset(cache, 0, sizeof(PropertyCache));
+	InitializeSRWLock(&cache->lock);
+	InitializeSRWLock(&cache->flushLock);
+
+	cache->enabled = enabled;
+	cache->lifetime = lifetime;
+}
+
+// The cache of a session the wrapper doesn't know is NULL, its properties go straight to the runtime
+static bool isEnabled(PropertyCache* cache) {
+	return cache != NULL && cache->enabled;
+}
+
+// The lookups below expect the lock to be held
+
+static PropertyCacheEntry* findEntry(PropertyCache* cache, const char* propertyName, PropertyType type) {
+	for (int i = 0;i < propertyCacheSize;i++) {
+		PropertyCacheEntry* entry = &cache->entries[i];
+
+		if (entry->valid && entry->type == type && strcmp(entry->name, propertyName) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+// A pending write is always served, it is the value the runtime will have
+static bool isFresh(PropertyCache* cache, PropertyCacheEntry* entry, double now) {
+	return entry->dirty || cache->lifetime <= 0.0 || now - entry->time < cache->lifetime;
+}
+
+// Takes an empty slot or the oldest one without a pending write,
+// NULL when the name does not fit or every slot holds a pending write
+static PropertyCacheEntry* allocEntry(PropertyCache* cache, const char* propertyName, PropertyType type) {
+	if (strlen(propertyName) >= propertyCacheNameLength) {
+		return NULL;
+	}
+
+	PropertyCacheEntry* victim = NULL;
+
+	for (int i = 0;i < propertyCacheSize;i++) {
+		PropertyCacheEntry* entry = &cache->entries[i];
+
+		if (!entry->valid) {
+			victim = entry;
+			break;
+		}
+
+		if (!entry->dirty && (victim == NULL || entry->time < victim->time)) {
+			victim = entry;
+		}
+	}
+
+	if (victim != NULL) {
+		memset(victim, 0, sizeof(PropertyCacheEntry));
+		strncpy_s(victim->name, sizeof(victim->name), propertyName, _TRUNCATE);
+		victim->type = type;
+		victim->valid = true;
+	}
+
+	return victim;
+}
+
+static PropertyCacheEntry* findOrAllocEntry(PropertyCache* cache, const char* propertyName, PropertyType type) {
+	PropertyCacheEntry* entry = findEntry(cache, propertyName, type);
+
+	return entry != NULL ? entry : allocEntry(cache, propertyName, type);
+}
+
+// A property written as one type invalidates whatever was cached or pending for it as another,
+// so a read never answers with a value the write replaced
+static void dropName(PropertyCache* cache, const char* propertyName, PropertyCacheEntry* keep) {
+	for (int i = 0;i < propertyCacheSize;i++) {
+		PropertyCacheEntry* entry = &cache->entries[i];
+
+		if (entry != keep && entry->valid && strcmp(entry->name, propertyName) == 0) {
+			entry->valid = false;
+			entry->dirty = false;
+		}
+	}
+}
+
+// Fetched values expire by the clock, the caller asks it once outside the lock
+static double cacheNow(PropertyCache* cache) {
+	return isEnabled(cache) && cache->lifetime > 0.0 ? rev_GetTimeInSeconds() : 0.0;
+}
+
+// Whole unions are compared, so the unused bytes have to be zero
+static PropertyValue makeBool(revBool b) {
+	PropertyValue v;
+	memset(&v, 0, sizeof(v));
+	v.b = b;
+	return v;
+}
+
+static PropertyValue makeInt(int i) {
+	PropertyValue v;
+	memset(&v, 0, sizeof(v));
+	v.i = i;
+	return v;
+}
+
+static PropertyValue makeFloat(float f) {
+	PropertyValue v;
+	memset(&v, 0, sizeof(v));
+	v.f = f;
+	return v;
+}
+
+// Answers a bool, int or float from the cache, false when it has to be fetched.
+// Defaults are compared bitwise so that a NaN default still hits.
+static bool getCachedValue(PropertyCache* cache, const char* propertyName, PropertyType type, PropertyValue defaultVal,
+	double now, PropertyValue* value) {
+	if (!isEnabled(cache)) {
+		return false;
+	}
+
+	AcquireSRWLockShared(&cache->lock);
+
+	PropertyCacheEntry* entry = findEntry(cache, propertyName, type);
+	bool hit = entry != NULL && isFresh(cache, entry, now) &&
+		(entry->written || memcmp(&entry->defaultVal, &defaultVal, sizeof(PropertyValue)) == 0);
+
+	if (hit) {
+		*value = entry->value;
+	}
+
+	ReleaseSRWLockShared(&cache->lock);
+
+	return hit;
+}
+
+// Called with the lock held after a fetch, NULL when the application wrote the property in the meantime
+static PropertyCacheEntry* storeFetch(PropertyCache* cache, const char* propertyName, PropertyType type, double now) {
+	PropertyCacheEntry* entry = findOrAllocEntry(cache, propertyName, type);
+
+	if (entry == NULL || entry->dirty) {
+		return NULL;
+	}
+
+	entry->written = false;
+	entry->time = now;
+
+	return entry;
+}
+
+static void storeFetchedValue(PropertyCache* cache, const char* propertyName, PropertyType type, PropertyValue defaultVal,
+	PropertyValue value, double now) {
+	if (!isEnabled(cache)) {
+		return;
+	}
+
+	AcquireSRWLockExclusive(&cache->lock);
+
+	PropertyCacheEntry* entry = storeFetch(cache, propertyName, type, now);
+
+	if (entry != NULL) {
+		entry->value = value;
+		entry->defaultVal = defaultVal;
+	}
+
+	ReleaseSRWLockExclusive(&cache->lock);
+}
+
+// Called with the lock held, NULL when no slot is free and the write has to go to the runtime right away
+static PropertyCacheEntry* storeWrite(PropertyCache* cache, const char* propertyName, PropertyType type) {
+	PropertyCacheEntry* entry = findOrAllocEntry(cache, propertyName, type);
+
+	dropName(cache, propertyName, entry);
+
+	if (entry != NULL) {
+		entry->dirty = true;
+		entry->written = true;
+		entry->isDefault = false;
+		entry->writeSeq = ++cache->writeSeq;
+	}
+
+	return entry;
+}
+
+static bool storeWrittenValue(PropertyCache* cache, const char* propertyName, PropertyType type, PropertyValue value) {
+	if (!isEnabled(cache)) {
+		return false;
+	}
+
+	AcquireSRWLockExclusive(&cache->lock);
+
+	PropertyCacheEntry* entry = storeWrite(cache, propertyName, type);
+
+	if (entry != NULL) {
+		entry->value = value;
+	}
+
+	ReleaseSRWLockExclusive(&cache->lock);
+
+	return entry != NULL;
+}
+
+// A value the cache can't hold goes to the runtime directly and must not be shadowed by a cached or pending one
+static void dropProperty(PropertyCache* cache, const char* propertyName) {
+	if (!isEnabled(cache)) {
+		return;
+	}
+
+	AcquireSRWLockExclusive(&cache->lock);
+	dropName(cache, propertyName, NULL);
+	ReleaseSRWLockExclusive(&cache->lock);
+}
+
+revBool propertyCacheGetBool(PropertyCache* cache, revSession session, const char* propertyName, revBool defaultVal) {
+	double now = cacheNow(cache);
+	PropertyValue value;
+
+	if (getCachedValue(cache, propertyName, propertyType_Bool, makeBool(defaultVal), now, &value)) {
+		return value.b;
+	}
+
+	revBool fetched = rev_GetBool(session, propertyName, defaultVal);
+	storeFetchedValue(cache, propertyName, propertyType_Bool, makeBool(defaultVal), makeBool(fetched), now);
+
+	return fetched;
+}
+
+int propertyCacheGetInt(PropertyCache* cache, revSession session, const char* propertyName, int defaultVal) {
+	double now = cacheNow(cache);
+	PropertyValue value;
+
+	if (getCachedValue(cache, propertyName, propertyType_Int, makeInt(defaultVal), now, &value)) {
+		return value.i;
+	}
+
+	int fetched = rev_GetInt(session, propertyName, defaultVal);
+	storeFetchedValue(cache, propertyName, propertyType_Int, makeInt(defaultVal), makeInt(fetched), now);
+
+	return fetched;
+}
+
+float propertyCacheGetFloat(PropertyCache* cache, revSession session, const char* propertyName, float defaultVal) {
+	double now = cacheNow(cache);
+	PropertyValue value;
+
+	if (getCachedValue(cache, propertyName, propertyType_Float, makeFloat(defaultVal), now, &value)) {
+		return value.f;
+	}
+
+	float fetched = rev_GetFloat(session, propertyName, defaultVal);
+	storeFetchedValue(cache, propertyName, propertyType_Float, makeFloat(defaultVal), makeFloat(fetched), now);
+
+	return fetched;
+}
+
+unsigned int propertyCacheGetFloatArray(PropertyCache* cache, revSession session, const char* propertyName,
+	float values[], unsigned int valuesCapacity) {
+	if (!isEnabled(cache)) {
+		return rev_GetFloatArray(session, propertyName, values, valuesCapacity);
+	}
+
+	double now = cacheNow(cache);
+
+	AcquireSRWLockShared(&cache->lock);
+
+	PropertyCacheEntry* entry = findEntry(cache, propertyName, propertyType_FloatArray);
+
+	//a full fetched entry may have been cut short, larger requests go to the runtime
+	if (entry != NULL && isFresh(cache, entry, now) &&
+		(entry->written || entry->floatCount < propertyCacheMaxFloats || valuesCapacity <= propertyCacheMaxFloats)) {
+		unsigned int count = entry->floatCount < valuesCapacity ? entry->floatCount : valuesCapacity;
+		memcpy(values, entry->floats, count * sizeof(float));
+
+		ReleaseSRWLockShared(&cache->lock);
+
+		return count;
+	}
+
+	ReleaseSRWLockShared(&cache->lock);
+
+	if (valuesCapacity > propertyCacheMaxFloats) {
+		return rev_GetFloatArray(session, propertyName, values, valuesCapacity);
+	}
+
+	float fetched[propertyCacheMaxFloats];
+	unsigned int fetchedCount = rev_GetFloatArray(session, propertyName, fetched, propertyCacheMaxFloats);
+
+	AcquireSRWLockExclusive(&cache->lock);
+
+	entry = storeFetch(cache, propertyName, propertyType_FloatArray, now);
+
+	if (entry != NULL) {
+		memcpy(entry->floats, fetched, fetchedCount * sizeof(float));
+		entry->floatCount = fetchedCount;
+	}
+
+	ReleaseSRWLockExclusive(&cache->lock);
+
+	unsigned int count = fetchedCount < valuesCapacity ? fetchedCount : valuesCapacity;
+	memcpy(values, fetched, count * sizeof(float));
+
+	return count;
+}
+
+const char* propertyCacheGetString(PropertyCache* cache, revSession session, const char* propertyName, const char* defaultVal) {
+	if (!isEnabled(cache)) {
+		return rev_GetString(session, propertyName, defaultVal);
+	}
+
+	double now = cacheNow(cache);
+
+	AcquireSRWLockShared(&cache->lock);
+
+	PropertyCacheEntry* entry = findEntry(cache, propertyName, propertyType_String);
+
+	if (entry != NULL && isFresh(cache, entry, now)) {
+		bool isDefault = entry->isDefault;
+		if (!isDefault) {
+			strncpy_s(propertyCacheString, sizeof(propertyCacheString), entry->string, _TRUNCATE);
+		}
+
+		ReleaseSRWLockShared(&cache->lock);
+
+		return isDefault ? defaultVal : propertyCacheString;
+	}
+
+	ReleaseSRWLockShared(&cache->lock);
+
+	const char* value = rev_GetString(session, propertyName, defaultVal);
+
+	if (value == defaultVal) {
+		AcquireSRWLockExclusive(&cache->lock);
+
+		entry = storeFetch(cache, propertyName, propertyType_String, now);
+
+		if (entry != NULL) {
+			entry->isDefault = true;
+		}
+
+		ReleaseSRWLockExclusive(&cache->lock);
+
+		return defaultVal;
+	}
+
+	//too long to be cached, an older cached value must not be served instead
+	if (value == NULL || strlen(value) >= propertyCacheStringLength) {
+		AcquireSRWLockExclusive(&cache->lock);
+
+		entry = findEntry(cache, propertyName, propertyType_String);
+
+		if (entry != NULL && !entry->dirty) {
+			entry->valid = false;
+		}
+
+		ReleaseSRWLockExclusive(&cache->lock);
+
+		return value;
+	}
+
+	strncpy_s(propertyCacheString, sizeof(propertyCacheString), value, _TRUNCATE);
+
+	AcquireSRWLockExclusive(&cache->lock);
+
+	entry = storeFetch(cache, propertyName, propertyType_String, now);
+
+	if (entry != NULL) {
+		entry->isDefault = false;
+		strncpy_s(entry->string, sizeof(entry->string), propertyCacheString, _TRUNCATE);
+	}
+
+	ReleaseSRWLockExclusive(&cache->lock);
+
+	return propertyCacheString;
+}
+
+// Setters report success once the value is pending, a write the runtime refuses at the flush
+// drops the entry so the next read fetches the runtime's value again
+
+revBool propertyCacheSetBool(PropertyCache* cache, revSession session, const char* propertyName, revBool value) {
+	if (storeWrittenValue(cache, propertyName, propertyType_Bool, makeBool(value))) {
+		return revTrue;
+	}
+
+	return rev_SetBool(session, propertyName, value);
+}
+
+revBool propertyCacheSetInt(PropertyCache* cache, revSession session, const char* propertyName, int value) {
+	if (storeWrittenValue(cache, propertyName, propertyType_Int, makeInt(value))) {
+		return revTrue;
+	}
+
+	return rev_SetInt(session, propertyName, value);
+}
+
+revBool propertyCacheSetFloat(PropertyCache* cache, revSession session, const char* propertyName, float value) {
+	if (storeWrittenValue(cache, propertyName, propertyType_Float, makeFloat(value))) {
+		return revTrue;
+	}
+
+	return rev_SetFloat(session, propertyName, value);
+}
+
+revBool propertyCacheSetFloatArray(PropertyCache* cache, revSession session, const char* propertyName,
+	const float values[], unsigned int valuesSize) {
+	if (valuesSize > propertyCacheMaxFloats) {
+		dropProperty(cache, propertyName);
+
+		return rev_SetFloatArray(session, propertyName, values, valuesSize);
+	}
+
+	PropertyCacheEntry* entry = NULL;
+
+	if (isEnabled(cache)) {
+		AcquireSRWLockExclusive(&cache->lock);
+
+		entry = storeWrite(cache, propertyName, propertyType_FloatArray);
+
+		if (entry != NULL) {
+			memcpy(entry->floats, values, valuesSize * sizeof(float));
+			entry->floatCount = valuesSize;
+		}
+
+		ReleaseSRWLockExclusive(&cache->lock);
+	}
+
+	return entry != NULL ? revTrue : rev_SetFloatArray(session, propertyName, values, valuesSize);
+}
+
+revBool propertyCacheSetString(PropertyCache* cache, revSession session, const char* propertyName, const char* value) {
+	if (value == NULL || strlen(value) >= propertyCacheStringLength) {
+		dropProperty(cache, propertyName);
+
+		return rev_SetString(session, propertyName, value);
+	}
+
+	PropertyCacheEntry* entry = NULL;
+
+	if (isEnabled(cache)) {
+		AcquireSRWLockExclusive(&cache->lock);
+
+		entry = storeWrite(cache, propertyName, propertyType_String);
+
+		if (entry != NULL) {
+			strncpy_s(entry->string, sizeof(entry->string), value, _TRUNCATE);
+		}
+
+		ReleaseSRWLockExclusive(&cache->lock);
+	}
+
+	return entry != NULL ? revTrue : rev_SetString(session, propertyName, value);
+}
+
+static revBool sendEntry(revSession session, PropertyCacheEntry* entry) {
+	switch (entry->type) {
+	case propertyType_Bool:
+		return rev_SetBool(session, entry->name, entry->value.b);
+	case propertyType_Int:
+		return rev_SetInt(session, entry->name, entry->value.i);
+	case propertyType_Float:
+		return rev_SetFloat(session, entry->name, entry->value.f);
+	case propertyType_FloatArray:
+		return rev_SetFloatArray(session, entry->name, entry->floats, entry->floatCount);
+	case propertyType_String:
+		return rev_SetString(session, entry->name, entry->string);
+	}
+
+	return revFalse;
+}
+
+void propertyCacheFlush(PropertyCache* cache, revSession session) {
+	if (!isEnabled(cache)) {
+		return;
+	}
+
+	AcquireSRWLockExclusive(&cache->flushLock);
+
+	//the writes are copied out, so readers and writers aren't blocked while the runtime syncs its settings
+	int slots[propertyCacheSize];
+	int count = 0;
+
+	AcquireSRWLockShared(&cache->lock);
+
+	for (int i = 0;i < propertyCacheSize;i++) {
+		PropertyCacheEntry* entry = &cache->entries[i];
+
+		if (entry->valid && entry->dirty) {
+			cache->flushing[count] = *entry;
+			slots[count++] = i;
+		}
+	}
+
+	ReleaseSRWLockShared(&cache->lock);
+
+	if (count == 0) {
+		ReleaseSRWLockExclusive(&cache->flushLock);
+		return;
+	}
+
+	revBool results[propertyCacheSize];
+
+	for (int i = 0;i < count;i++) {
+		results[i] = sendEntry(session, &cache->flushing[i]);
+	}
+
+	double now = cacheNow(cache);
+
+	AcquireSRWLockExclusive(&cache->lock);
+
+	for (int i = 0;i < count;i++) {
+		PropertyCacheEntry* entry = &cache->entries[slots[i]];
+
+		//an entry written again during the flush stays pending with its new value
+		if (entry->valid && entry->dirty && entry->writeSeq == cache->flushing[i].writeSeq) {
+			entry->dirty = false;
+			entry->valid = results[i] != revFalse;
+			entry->time = now;
+		}
+	}
+
+	ReleaseSRWLockExclusive(&cache->lock);
+
+	ReleaseSRWLockExclusive(&cache->flushLock);
+}
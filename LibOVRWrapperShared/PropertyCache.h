@@ -0,0 +1,84 @@
+#pragma once
+
+#include <windows.h>
+
+#include "../LibREV/Include/REV_CAPI.h"
+
+// Write-behind cache of the rev_Get*/rev_Set* properties of one session, shared by the wrapper versions.
+// Every rev property call is a settings round trip in the runtime and every setter syncs the settings,
+// while engines poll properties like the eye height and IPD each frame.
+// Reads are answered from the cache after the first fetch, a read of a property with a pending write returns that value.
+// Writes are combined per property and kept until propertyCacheFlush, which the wrapper calls after each
+// submitted frame and when the session is destroyed. A write the runtime refuses drops the entry, so the
+// next read fetches the runtime's value again.
+// Entries that are not pending are fetched again once they are lifetime seconds old, so changes made in the
+// runtime still show up. A lifetime of 0 keeps them until the session ends.
+// The cache is locked, the application may call the property functions from any thread.
+
+#define propertyCacheSize 32
+#define propertyCacheNameLength 64
+#define propertyCacheMaxFloats 16
+#define propertyCacheStringLength 256
+
+typedef enum PropertyType_
+{
+	propertyType_Bool,
+	propertyType_Int,
+	propertyType_Float,
+	propertyType_FloatArray,
+	propertyType_String
+} PropertyType;
+
+typedef union PropertyValue_
+{
+	revBool b;
+	int i;
+	float f;
+} PropertyValue;
+
+typedef struct PropertyCacheEntry_
+{
+	char name[propertyCacheNameLength];
+	PropertyType type;
+	bool valid;
+	bool dirty; // written by the application and not yet sent to the runtime
+	bool written; // by the application, the value holds whatever default a read passes
+	bool isDefault; // strings only, the runtime handed back the default so the property is not set
+	double time; // the value was fetched or flushed at, in rev_GetTimeInSeconds
+	unsigned int writeSeq; // of the last write, tells a flush whether the entry was written again while it was sent
+	PropertyValue value, defaultVal; // defaultVal is the one the value was fetched with, the runtime returns it for unset properties
+	unsigned int floatCount;
+	float floats[propertyCacheMaxFloats];
+	char string[propertyCacheStringLength];
+} PropertyCacheEntry;
+
+typedef struct PropertyCache_
+{
+	SRWLOCK lock; // guards the entries
+	SRWLOCK flushLock; // serializes the flushes, so two of them can't send the writes of one property out of order
+	bool enabled;
+	double lifetime; // seconds a fetched value is served for, 0 for the whole session
+	unsigned int writeSeq;
+	PropertyCacheEntry entries[propertyCacheSize];
+	PropertyCacheEntry flushing[propertyCacheSize]; // copies of the pending writes a flush is sending, guarded by flushLock
+} PropertyCache;
+
+void propertyCacheInit(PropertyCache* cache, bool enabled, double lifetime);
+
+revBool propertyCacheGetBool(PropertyCache* cache, revSession session, const char* propertyName, revBool defaultVal);
+int propertyCacheGetInt(PropertyCache* cache, revSession session, const char* propertyName, int defaultVal);
+float propertyCacheGetFloat(PropertyCache* cache, revSession session, const char* propertyName, float defaultVal);
+unsigned int propertyCacheGetFloatArray(PropertyCache* cache, revSession session, const char* propertyName,
+	float values[], unsigned int valuesCapacity);
+// The returned string is a copy owned by the calling thread, it stays valid until the thread's next call
+const char* propertyCacheGetString(PropertyCache* cache, revSession session, const char* propertyName, const char* defaultVal);
+
+revBool propertyCacheSetBool(PropertyCache* cache, revSession session, const char* propertyName, revBool value);
+revBool propertyCacheSetInt(PropertyCache* cache, revSession session, const char* propertyName, int value);
+revBool propertyCacheSetFloat(PropertyCache* cache, revSession session, const char* propertyName, float value);
+revBool propertyCacheSetFloatArray(PropertyCache* cache, revSession session, const char* propertyName,
+	const float values[], unsigned int valuesSize);
+revBool propertyCacheSetString(PropertyCache* cache, revSession session, const char* propertyName, const char* value);
+
+// Sends the pending writes to the runtime
+void propertyCacheFlush(PropertyCache* cache, revSession session);
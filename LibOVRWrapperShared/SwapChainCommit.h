@@ -0,0 +1,75 @@
+#pragma once
+
+// Commit of an ovrSwapTextureSet into its rev swap chain, shared by the wrapper versions.
+// The buffer bookkeeping lives here, the graphics work goes through SwapChainDevice, which the
+// wrappers implement with D3D11 and the runtime and the tests with a fake device.
+
+class SwapChainDevice
+{
+public:
+	// Buffer of the rev chain that the next commit hands to the compositor
+	virtual int currentIndex() = 0;
+	// Copies texture textureIndex of the set into buffer bufferIndex of the rev chain
+	virtual void copy(int bufferIndex, int textureIndex) = 0;
+	// Commits the rev chain, which moves currentIndex on to the following buffer
+	virtual void commit() = 0;
+};
+
+typedef struct SwapChainCommit_
+{
+	int length; // buffers in the rev chain
+	bool aliased; // the set's textures are the rev buffers themselves, no copy on commit
+	int committedIndex; // CurrentIndex of the set after the last commit, -1 before the first one
+	unsigned int committedSubmit; // serial of the submit call of the last commit, 0 before the first one
+} SwapChainCommit;
+
+typedef enum SwapChainCommitResult_
+{
+	swapChainCommitSkipped, // the runtime already holds the set's content
+	swapChainCommitCopied,
+	swapChainCommitInPlace, // an aliased set was rendered into the buffer that was committed
+} SwapChainCommitResult;
+
+inline void swapChainCommitInit(SwapChainCommit* commit, int length, bool aliased) {
+	commit->length = length > 0 ? length : 1;
+	commit->aliased = aliased;
+	commit->committedIndex = -1;
+	commit->committedSubmit = 0;
+}
+
+// Applications advance CurrentIndex before rendering, so an aliased set is left one behind the buffer the chain expects next
+inline int swapChainAliasedIndex(const SwapChainCommit* commit, SwapChainDevice* device) {
+	return (device->currentIndex() + commit->length - 1) % commit->length;
+}
+
+// Commits the set whose CurrentIndex is *currentIndex for the submit call identified by submitSerial, which is never 0.
+// Several layers of one call can show the same set, only the first of them commits it. Across calls an unchanged
+// CurrentIndex only means unchanged content with skipUnchanged, not every application advances it for a new frame.
+// *currentIndex is moved along for aliased sets.
+inline SwapChainCommitResult swapChainCommit(SwapChainCommit* commit, SwapChainDevice* device, int* currentIndex,
+	unsigned int submitSerial, bool skipUnchanged) {
+	if (commit->committedSubmit == submitSerial ||
+		(skipUnchanged && commit->committedIndex == *currentIndex)) {
+		return swapChainCommitSkipped;
+	}
+
+	int bufferIndex = device->currentIndex();
+	SwapChainCommitResult result = swapChainCommitInPlace;
+
+	//an aliased set was rendered in place, unless the application picked another buffer than the one we handed out
+	if (!commit->aliased || *currentIndex != bufferIndex) {
+		device->copy(bufferIndex, *currentIndex);
+		result = swapChainCommitCopied;
+	}
+
+	device->commit();
+
+	if (commit->aliased) {
+		*currentIndex = swapChainAliasedIndex(commit, device);
+	}
+
+	commit->committedIndex = *currentIndex;
+	commit->committedSubmit = submitSerial;
+
+	return result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <assert.h>
+
+#include "../LibREV/Include/REV_CAPI.h"
+
+// Local copy of a rev swap chain's ring index, shared by the wrapper versions.
+// The wrapper owns its chains and is the only one committing them, so the index the runtime
+// hands out next is known without asking: a commit moves it to the following buffer.
+// Debug builds compare it with rev_GetTextureSwapChainCurrentIndex on every lookup.
+
+typedef struct SwapChainMirror_
+{
+	int length; // buffers in the chain
+	int currentIndex; // buffer rendered into before the next commit
+} SwapChainMirror;
+
+inline void swapChainMirrorReset(SwapChainMirror* mirror, int length, int currentIndex) {
+	mirror->length = length > 0 ? length : 1;
+	mirror->currentIndex = currentIndex >= 0 && currentIndex < mirror->length ? currentIndex : 0;
+}
+
+inline void swapChainMirrorAdvance(SwapChainMirror* mirror) {
+	mirror->currentIndex = mirror->currentIndex + 1 < mirror->length ? mirror->currentIndex + 1 : 0;
+}
+
+// Queries the chain once right after it was created
+inline revResult swapChainMirrorInit(SwapChainMirror* mirror, revSession session, revTextureSwapChain chain) {
+	int length = 0;
+	int currentIndex = 0;
+
+	revResult r = rev_GetTextureSwapChainLength(session, chain, &length);
+	if (REV_SUCCESS(r)) {
+		r = rev_GetTextureSwapChainCurrentIndex(session, chain, &currentIndex);
+	}
+
+	swapChainMirrorReset(mirror, length, currentIndex);
+
+	return r;
+}
+
+inline int swapChainMirrorCurrentIndex(SwapChainMirror* mirror, revSession session, revTextureSwapChain chain) {
+#ifdef _DEBUG
+	int runtimeIndex = 0;
+
+	if (REV_SUCCESS(rev_GetTextureSwapChainCurrentIndex(session, chain, &runtimeIndex))) {
+		assert(runtimeIndex == mirror->currentIndex);
+		mirror->currentIndex = runtimeIndex;
+	}
+#endif
+
+	return mirror->currentIndex;
+}
+
+inline revResult swapChainMirrorCommit(SwapChainMirror* mirror, revSession session, revTextureSwapChain chain) {
+	revResult r = rev_CommitTextureSwapChain(session, chain);
+
+	if (REV_SUCCESS(r)) {
+		swapChainMirrorAdvance(mirror);
+	}
+
+	return r;
+}
@@ -0,0 +1,1695 @@
+// REVMock.cpp : Deterministic stand-in for the runtime that LibREV loads behind the rev_* API.
+//
+// LibREV's loader (LibREV/Src/REV_CAPIShim.c) resolves the ovr_* exports listed in REV_LoadSharedLibrary
+// from LibOVRRevive_1.dll on Windows and libOVRRT64.so.1 (libOVRRT32.so.1) elsewhere. This library
+// exports that whole surface without a headset, a GPU or a compositor, so the shims can be driven headless:
+// a synthetic CV1 with Touch and XBox controllers following a pose script, a vsync clock, ovr_SubmitFrame
+// that blocks like a compositor would, in-memory swap chains and per-call timing of every export.
+//
+// Built by LibREVMock.vcxproj next to the Tests runner. As a standalone library, build with:
+//   Windows: cl /LD /EHsc /O2 /W4 /I..\LibREV\Include REVMock.cpp /Fe:LibOVRRevive_1.dll
+//   Linux:   g++ -std=c++11 -O2 -Wall -Wextra -shared -fPIC -pthread -I../LibREV/Include REVMock.cpp -o libOVRRT64.so.1
+// and place it next to the application (or in the working directory) instead of the real runtime.
+//
+// Configured through environment variables read by ovr_Initialize:
+//   REVMOCK_REFRESH=90            display refresh rate in Hz
+//   REVMOCK_CLOCK=real|virtual    virtual time only advances in ovr_SubmitFrame, one vsync per frame,
+//                                 so every run sees the same timestamps and poses
+//   REVMOCK_SUBMIT=vsync|none|N   ovr_SubmitFrame waits for the next vsync, returns at once, or takes N microseconds
+//   REVMOCK_POSE_SCRIPT=file      head keyframes, one "seconds x y z yawDeg pitchDeg rollDeg" per line,
+//                                 interpolated linearly and looped. The built in script sways the head.
+//   REVMOCK_CONTROLLERS=0x13      revControllerType mask of the connected controllers
+//   REVMOCK_SWAPCHAIN_LENGTH=3    textures per swap chain
+//   REVMOCK_QUIT_AFTER=0          frames until revSessionStatus.ShouldQuit is raised, 0 for never
+//   REVMOCK_STATS=file            where ovr_Shutdown writes the call statistics, stderr when unset
+
+#if defined(_WIN32)
+#define _CRT_SECURE_NO_WARNINGS
+#include <windows.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "REV_CAPI.h"
+#include "REV_CAPI_Keys.h"
+#include "REV_ErrorCode.h"
+
+#if defined(_WIN32)
+#define REVMOCK_EXPORT(rval) extern "C" __declspec(dllexport) rval REV_CDECL
+#else
+#define REVMOCK_EXPORT(rval) extern "C" __attribute__((visibility("default"))) rval REV_CDECL
+#endif
+
+// Every export, in the order REV_LoadSharedLibrary resolves them.
+#define REVMOCK_CALLS(X) \
+	X(ovr_InitializeRenderingShimVersion) \
+	X(ovr_Initialize) \
+	X(ovr_Shutdown) \
+	X(ovr_GetVersionString) \
+	X(ovr_GetLastErrorInfo) \
+	X(ovr_GetHmdDesc) \
+	X(ovr_GetTrackerCount) \
+	X(ovr_GetTrackerDesc) \
+	X(ovr_Create) \
+	X(ovr_Destroy) \
+	X(ovr_GetSessionStatus) \
+	X(ovr_SetTrackingOriginType) \
+	X(ovr_GetTrackingOriginType) \
+	X(ovr_RecenterTrackingOrigin) \
+	X(ovr_ClearShouldRecenterFlag) \
+	X(ovr_GetTrackingState) \
+	X(ovr_GetTrackerPose) \
+	X(ovr_GetInputState) \
+	X(ovr_GetConnectedControllerTypes) \
+	X(ovr_SetControllerVibration) \
+	X(ovr_GetFovTextureSize) \
+	X(ovr_SubmitFrame) \
+	X(ovr_GetRenderDesc) \
+	X(ovr_GetPredictedDisplayTime) \
+	X(ovr_GetTimeInSeconds) \
+	X(ovr_GetBool) \
+	X(ovr_SetBool) \
+	X(ovr_GetInt) \
+	X(ovr_SetInt) \
+	X(ovr_GetFloat) \
+	X(ovr_SetFloat) \
+	X(ovr_GetFloatArray) \
+	X(ovr_SetFloatArray) \
+	X(ovr_GetString) \
+	X(ovr_SetString) \
+	X(ovr_TraceMessage) \
+	X(ovr_CreateTextureSwapChainDX) \
+	X(ovr_CreateMirrorTextureDX) \
+	X(ovr_GetTextureSwapChainBufferDX) \
+	X(ovr_GetMirrorTextureBufferDX) \
+	X(ovr_GetAudioDeviceOutWaveId) \
+	X(ovr_GetAudioDeviceInWaveId) \
+	X(ovr_GetAudioDeviceOutGuidStr) \
+	X(ovr_GetAudioDeviceOutGuid) \
+	X(ovr_GetAudioDeviceInGuidStr) \
+	X(ovr_GetAudioDeviceInGuid) \
+	X(ovr_CreateTextureSwapChainGL) \
+	X(ovr_CreateMirrorTextureGL) \
+	X(ovr_GetTextureSwapChainBufferGL) \
+	X(ovr_GetMirrorTextureBufferGL) \
+	X(ovr_GetTextureSwapChainLength) \
+	X(ovr_GetTextureSwapChainCurrentIndex) \
+	X(ovr_GetTextureSwapChainDesc) \
+	X(ovr_CommitTextureSwapChain) \
+	X(ovr_DestroyTextureSwapChain) \
+	X(ovr_DestroyMirrorTexture) \
+	X(ovr_SetQueueAheadFraction) \
+	X(ovr_Lookup)
+
+enum mockCallId
+{
+#define X(name) mockCall_##name,
+	REVMOCK_CALLS(X)
+#undef X
+	mockCall_Count
+};
+
+const char* mockCallNames[] = {
+#define X(name) #name,
+	REVMOCK_CALLS(X)
+#undef X
+};
+
+typedef std::chrono::steady_clock mockClock;
+
+// Per export counters, updated without a lock so timing a call does not serialize the callers
+struct MockCallStats
+{
+	std::atomic<unsigned long long> count;
+	std::atomic<unsigned long long> totalNs;
+	std::atomic<unsigned long long> maxNs;
+};
+
+MockCallStats mockStats[mockCall_Count];
+
+struct MockCallTimer
+{
+	mockCallId id;
+	mockClock::time_point start;
+
+	MockCallTimer(mockCallId callId) : id(callId), start(mockClock::now()) {}
+
+	~MockCallTimer() {
+		unsigned long long ns = (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(mockClock::now() - start).count();
+		MockCallStats& stats = mockStats[id];
+
+		stats.count++;
+		stats.totalNs += ns;
+
+		unsigned long long max = stats.maxNs;
+		while (ns > max && !stats.maxNs.compare_exchange_weak(max, ns)) {
+		}
+	}
+};
+
+#define MOCK_CALL(name) MockCallTimer mockCallTimer(mockCall_##name)
+
+struct MockKeyframe
+{
+	double time;
+	revVector3f position;
+	float yaw, pitch, roll; // radians
+};
+
+enum mockSubmitMode
+{
+	mockSubmit_Vsync,
+	mockSubmit_None,
+	mockSubmit_Fixed
+};
+
+struct MockConfig
+{
+	double refreshRate;
+	bool virtualClock;
+	mockSubmitMode submitMode;
+	double submitSeconds;
+	unsigned int controllers;
+	int swapChainLength;
+	long long quitAfterFrames;
+	char statsFile[260];
+	std::vector<MockKeyframe> script;
+};
+
+enum mockPropertyType
+{
+	mockProperty_Bool,
+	mockProperty_Int,
+	mockProperty_Float,
+	mockProperty_FloatArray,
+	mockProperty_String
+};
+
+#define mockMaxFloats 16
+
+struct MockProperty
+{
+	char name[64];
+	mockPropertyType type;
+	int intValue;
+	float floats[mockMaxFloats];
+	unsigned int floatCount;
+	char string[256];
+};
+
+struct revTextureSwapChainData
+{
+	revTextureSwapChainDesc desc;
+	int length;
+	int currentIndex;
+	int commitsSinceSubmit;
+	bool committed;
+	unsigned int glTextures[8];
+};
+
+struct revMirrorTextureData
+{
+	revMirrorTextureDesc desc;
+	unsigned int glTexture;
+};
+
+struct revHmdStruct
+{
+	revTrackingOrigin origin;
+	revPosef recenter; // head pose at the last ovr_RecenterTrackingOrigin, only yaw and position are kept
+	bool shouldRecenter;
+	long long submittedFrames;
+	long long lastFrameIndex;
+	double lastDisplayTime;
+	float queueAheadFraction;
+	float vibrationFrequency[revHand_Count];
+	float vibrationAmplitude[revHand_Count];
+	std::vector<MockProperty> properties;
+	std::vector<revTextureSwapChainData*> swapChains;
+	std::vector<revMirrorTextureData*> mirrors;
+	unsigned long long layersSubmitted;
+};
+
+std::mutex mockMutex;
+bool mockInitialized = false;
+MockConfig mockConfig;
+mockClock::time_point mockStart;
+double mockVirtualTime = 0.0;
+unsigned int mockNextGLTexture = 1;
+std::vector<revHmdStruct*> mockSessions;
+
+#if defined(_MSC_VER)
+__declspec(thread) revErrorInfo mockLastError;
+#else
+__thread revErrorInfo mockLastError;
+#endif
+
+revResult mockError(revResult result, const char* message) {
+	mockLastError.Result = result;
+	strncpy(mockLastError.ErrorString, message, sizeof(mockLastError.ErrorString) - 1);
+	mockLastError.ErrorString[sizeof(mockLastError.ErrorString) - 1] = '\0';
+
+	return result;
+}
+
+bool mockValidSession(revSession session) {
+	for (size_t i = 0;i < mockSessions.size();i++) {
+		if (mockSessions[i] == session) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool mockValidSwapChain(revSession session, revTextureSwapChain chain) {
+	for (size_t i = 0;i < session->swapChains.size();i++) {
+		if (session->swapChains[i] == chain) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Configuration
+
+const char* mockEnv(const char* name) {
+	const char* value = getenv(name);
+
+	return value != NULL && value[0] != '\0' ? value : NULL;
+}
+
+double mockEnvDouble(const char* name, double defaultVal) {
+	const char* value = mockEnv(name);
+
+	return value != NULL ? atof(value) : defaultVal;
+}
+
+long long mockEnvInt(const char* name, long long defaultVal) {
+	const char* value = mockEnv(name);
+
+	return value != NULL ? strtoll(value, NULL, 0) : defaultVal;
+}
+
+const float mockDegrees = 3.14159265f / 180.0f;
+
+void mockAddKeyframe(std::vector<MockKeyframe>& script, double time, float x, float y, float z, float yaw, float pitch, float roll) {
+	MockKeyframe k;
+
+	k.time = time;
+	k.position.x = x;
+	k.position.y = y;
+	k.position.z = z;
+	k.yaw = yaw * mockDegrees;
+	k.pitch = pitch * mockDegrees;
+	k.roll = roll * mockDegrees;
+
+	script.push_back(k);
+}
+
+void mockLoadScript(std::vector<MockKeyframe>& script, const char* filename) {
+	script.clear();
+
+	if (filename != NULL) {
+		FILE* file = fopen(filename, "r");
+
+		if (file != NULL) {
+			char line[256];
+
+			while (fgets(line, sizeof(line), file) != NULL) {
+				double t;
+				float x, y, z, yaw, pitch, roll;
+
+				if (line[0] != '#' && sscanf(line, "%lf %f %f %f %f %f %f", &t, &x, &y, &z, &yaw, &pitch, &roll) == 7) {
+					if (script.empty() || t > script.back().time) {
+						mockAddKeyframe(script, t, x, y, z, yaw, pitch, roll);
+					}
+				}
+			}
+
+			fclose(file);
+		}
+		else {
+			fprintf(stderr, "REVMock: could not open pose script %s, using the built in one\n", filename);
+		}
+	}
+
+	if (script.size() < 2) {
+		//Slow look around with a little head bob, four seconds per loop
+		script.clear();
+		mockAddKeyframe(script, 0.0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+		mockAddKeyframe(script, 1.0, 0.05f, 0.01f, -0.02f, 25.0f, -5.0f, 2.0f);
+		mockAddKeyframe(script, 2.0, 0.0f, -0.01f, 0.0f, 0.0f, 10.0f, 0.0f);
+		mockAddKeyframe(script, 3.0, -0.05f, 0.01f, 0.02f, -25.0f, -5.0f, -2.0f);
+		mockAddKeyframe(script, 4.0, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+void mockLoadConfig(MockConfig& config) {
+	config.refreshRate = mockEnvDouble("REVMOCK_REFRESH", 90.0);
+	if (config.refreshRate <= 0.0) {
+		config.refreshRate = 90.0;
+	}
+
+	const char* clock = mockEnv("REVMOCK_CLOCK");
+	config.virtualClock = clock != NULL && strcmp(clock, "virtual") == 0;
+
+	const char* submit = mockEnv("REVMOCK_SUBMIT");
+	config.submitSeconds = 0.0;
+	if (submit == NULL || strcmp(submit, "vsync") == 0) {
+		config.submitMode = mockSubmit_Vsync;
+	}
+	else if (strcmp(submit, "none") == 0) {
+		config.submitMode = mockSubmit_None;
+	}
+	else {
+		config.submitMode = mockSubmit_Fixed;
+		config.submitSeconds = atof(submit) / 1000000.0;
+	}
+
+	config.controllers = (unsigned int)mockEnvInt("REVMOCK_CONTROLLERS", revControllerType_Touch | revControllerType_XBox);
+	config.swapChainLength = (int)mockEnvInt("REVMOCK_SWAPCHAIN_LENGTH", 3);
+	if (config.swapChainLength < 1 || config.swapChainLength > 8) {
+		config.swapChainLength = 3;
+	}
+	config.quitAfterFrames = mockEnvInt("REVMOCK_QUIT_AFTER", 0);
+
+	const char* stats = mockEnv("REVMOCK_STATS");
+	config.statsFile[0] = '\0';
+	if (stats != NULL) {
+		strncpy(config.statsFile, stats, sizeof(config.statsFile) - 1);
+		config.statsFile[sizeof(config.statsFile) - 1] = '\0';
+	}
+
+	mockLoadScript(config.script, mockEnv("REVMOCK_POSE_SCRIPT"));
+}
+
+// Clock, the vsync grid starts at ovr_Initialize
+
+double mockNow() {
+	if (mockConfig.virtualClock) {
+		return mockVirtualTime;
+	}
+
+	return std::chrono::duration<double>(mockClock::now() - mockStart).count();
+}
+
+double mockFrameInterval() {
+	return 1.0 / mockConfig.refreshRate;
+}
+
+double mockNextVsync(double time) {
+	return (floor(time * mockConfig.refreshRate) + 1.0) * mockFrameInterval();
+}
+
+void mockWaitUntil(double time) {
+	if (mockConfig.virtualClock) {
+		if (time > mockVirtualTime) {
+			mockVirtualTime = time;
+		}
+		return;
+	}
+
+	std::this_thread::sleep_until(mockStart + std::chrono::duration_cast<mockClock::duration>(std::chrono::duration<double>(time)));
+}
+
+// Poses
+
+revQuatf mockQuatMul(revQuatf a, revQuatf b) {
+	revQuatf r;
+
+	r.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+	r.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+	r.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+	r.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+
+	return r;
+}
+
+revQuatf mockQuatAxis(float x, float y, float z, float angle) {
+	revQuatf r;
+	float s = sinf(angle * 0.5f);
+
+	r.x = x * s;
+	r.y = y * s;
+	r.z = z * s;
+	r.w = cosf(angle * 0.5f);
+
+	return r;
+}
+
+revQuatf mockQuatEuler(float yaw, float pitch, float roll) {
+	return mockQuatMul(mockQuatMul(mockQuatAxis(0, 1, 0, yaw), mockQuatAxis(1, 0, 0, pitch)), mockQuatAxis(0, 0, 1, roll));
+}
+
+revVector3f mockRotate(revQuatf q, revVector3f v) {
+	revQuatf p = { v.x, v.y, v.z, 0.0f };
+	revQuatf c = { -q.x, -q.y, -q.z, q.w };
+	revQuatf r = mockQuatMul(mockQuatMul(q, p), c);
+	revVector3f out = { r.x, r.y, r.z };
+
+	return out;
+}
+
+struct MockEuler
+{
+	revVector3f position;
+	float yaw, pitch, roll;
+};
+
+MockEuler mockSampleScript(double time) {
+	const std::vector<MockKeyframe>& script = mockConfig.script;
+	double length = script.back().time - script.front().time;
+	double t = fmod(time, length);
+
+	if (t < 0.0) {
+		t += length;
+	}
+	t += script.front().time;
+
+	size_t i = 0;
+	while (i + 2 < script.size() && script[i + 1].time <= t) {
+		i++;
+	}
+
+	const MockKeyframe& a = script[i];
+	const MockKeyframe& b = script[i + 1];
+	float f = (float)((t - a.time) / (b.time - a.time));
+
+	MockEuler e;
+	e.position.x = a.position.x + (b.position.x - a.position.x) * f;
+	e.position.y = a.position.y + (b.position.y - a.position.y) * f;
+	e.position.z = a.position.z + (b.position.z - a.position.z) * f;
+	e.yaw = a.yaw + (b.yaw - a.yaw) * f;
+	e.pitch = a.pitch + (b.pitch - a.pitch) * f;
+	e.roll = a.roll + (b.roll - a.roll) * f;
+
+	return e;
+}
+
+// Hand offsets from the head in the head's yaw frame, the hands trail the head by a quarter second
+const revVector3f mockHandOffset[revHand_Count] = { { -0.2f, -0.4f, -0.35f }, { 0.2f, -0.4f, -0.35f } };
+
+revPosef mockPose(revSession session, int body, double time) {
+	MockEuler e = mockSampleScript(body < 0 ? time : time - 0.25);
+	revPosef pose;
+
+	if (body < 0) {
+		pose.Orientation = mockQuatEuler(e.yaw, e.pitch, e.roll);
+		pose.Position = e.position;
+	}
+	else {
+		revQuatf yaw = mockQuatEuler(e.yaw, 0.0f, 0.0f);
+		revVector3f offset = mockRotate(yaw, mockHandOffset[body]);
+
+		pose.Orientation = mockQuatEuler(e.yaw, e.pitch * 0.5f - 0.5f, 0.0f);
+		pose.Position.x = e.position.x + offset.x;
+		pose.Position.y = e.position.y + offset.y;
+		pose.Position.z = e.position.z + offset.z;
+	}
+
+	if (session->origin == revTrackingOrigin_FloorLevel) {
+		pose.Position.y += REV_DEFAULT_EYE_HEIGHT_;
+	}
+
+	//Express the pose relative to the recentered origin
+	revQuatf inverse = { -session->recenter.Orientation.x, -session->recenter.Orientation.y, -session->recenter.Orientation.z, session->recenter.Orientation.w };
+	revVector3f delta = { pose.Position.x - session->recenter.Position.x, pose.Position.y - session->recenter.Position.y, pose.Position.z - session->recenter.Position.z };
+
+	pose.Orientation = mockQuatMul(inverse, pose.Orientation);
+	pose.Position = mockRotate(inverse, delta);
+
+	return pose;
+}
+
+revPoseStatef mockPoseState(revSession session, int body, double time) {
+	const double dt = 0.001;
+	revPoseStatef state;
+
+	memset(&state, 0, sizeof(state));
+
+	state.ThePose = mockPose(session, body, time);
+	state.TimeInSeconds = time;
+
+	revPosef next = mockPose(session, body, time + dt);
+
+	state.LinearVelocity.x = (float)((next.Position.x - state.ThePose.Position.x) / dt);
+	state.LinearVelocity.y = (float)((next.Position.y - state.ThePose.Position.y) / dt);
+	state.LinearVelocity.z = (float)((next.Position.z - state.ThePose.Position.z) / dt);
+
+	//Angular velocity from the rotation between the two samples, small angle approximation
+	revQuatf inverse = { -state.ThePose.Orientation.x, -state.ThePose.Orientation.y, -state.ThePose.Orientation.z, state.ThePose.Orientation.w };
+	revQuatf delta = mockQuatMul(next.Orientation, inverse);
+	float sign = delta.w < 0.0f ? -2.0f : 2.0f;
+
+	state.AngularVelocity.x = (float)(delta.x * sign / dt);
+	state.AngularVelocity.y = (float)(delta.y * sign / dt);
+	state.AngularVelocity.z = (float)(delta.z * sign / dt);
+
+	return state;
+}
+
+// HMD description, matches a retail CV1
+
+const revFovPort mockDefaultFov[revEye_Count] = {
+	{ 1.32928634f, 1.32928634f, 1.05865765f, 1.09236801f },
+	{ 1.32928634f, 1.32928634f, 1.09236801f, 1.05865765f }
+};
+
+const float mockPixelsPerTanAngle = 549.618286f;
+const revSizei mockResolution = { 2160, 1200 };
+
+revHmdDesc mockHmdDesc() {
+	revHmdDesc desc;
+
+	memset(&desc, 0, sizeof(desc));
+
+	desc.Type = revHmd_CV1;
+	strcpy(desc.ProductName, "Oculus Rift");
+	strcpy(desc.Manufacturer, "Oculus VR");
+	desc.VendorId = 0x2833;
+	desc.ProductId = 0x0031;
+	strcpy(desc.SerialNumber, "REVMOCK000000");
+	desc.FirmwareMajor = 1;
+	desc.FirmwareMinor = 0;
+	desc.AvailableHmdCaps = 0;
+	desc.DefaultHmdCaps = 0;
+	desc.AvailableTrackingCaps = revTrackingCap_Orientation | revTrackingCap_MagYawCorrection | revTrackingCap_Position;
+	desc.DefaultTrackingCaps = desc.AvailableTrackingCaps;
+
+	for (int eye = 0;eye < revEye_Count;eye++) {
+		desc.DefaultEyeFov[eye] = mockDefaultFov[eye];
+		desc.MaxEyeFov[eye] = mockDefaultFov[eye];
+	}
+
+	desc.Resolution = mockResolution;
+	desc.DisplayRefreshRate = (float)mockConfig.refreshRate;
+
+	return desc;
+}
+
+// Properties, stored per session and seeded with the profile defaults
+
+MockProperty* mockFindProperty(revSession session, const char* name, mockPropertyType type, bool create) {
+	if (name == NULL) {
+		return NULL;
+	}
+
+	for (size_t i = 0;i < session->properties.size();i++) {
+		MockProperty& p = session->properties[i];
+
+		if (strcmp(p.name, name) == 0) {
+			if (p.type == type) {
+				return &p;
+			}
+			if (!create) {
+				return NULL;
+			}
+
+			memset(&p, 0, sizeof(p));
+			strncpy(p.name, name, sizeof(p.name) - 1);
+			p.type = type;
+			return &p;
+		}
+	}
+
+	if (!create || strlen(name) >= sizeof(((MockProperty*)0)->name)) {
+		return NULL;
+	}
+
+	MockProperty p;
+	memset(&p, 0, sizeof(p));
+	strcpy(p.name, name);
+	p.type = type;
+	session->properties.push_back(p);
+
+	return &session->properties.back();
+}
+
+void mockSeedProperties(revSession session) {
+	mockFindProperty(session, "IPD", mockProperty_Float, true)->floats[0] = 0.064f;
+	mockFindProperty(session, REV_KEY_PLAYER_HEIGHT_, mockProperty_Float, true)->floats[0] = REV_DEFAULT_PLAYER_HEIGHT_;
+	mockFindProperty(session, REV_KEY_EYE_HEIGHT_, mockProperty_Float, true)->floats[0] = REV_DEFAULT_EYE_HEIGHT_;
+	strcpy(mockFindProperty(session, REV_KEY_GENDER_, mockProperty_String, true)->string, REV_DEFAULT_GENDER_);
+
+	MockProperty* neck = mockFindProperty(session, REV_KEY_NECK_TO_EYE_DISTANCE_, mockProperty_FloatArray, true);
+	neck->floats[0] = REV_DEFAULT_NECK_TO_EYE_HORIZONTAL_;
+	neck->floats[1] = REV_DEFAULT_NECK_TO_EYE_VERTICAL_;
+	neck->floatCount = 2;
+}
+
+float mockIpd(revSession session) {
+	MockProperty* p = mockFindProperty(session, "IPD", mockProperty_Float, false);
+
+	return p != NULL ? p->floats[0] : 0.064f;
+}
+
+// Swap chains
+
+revResult mockCreateSwapChain(revSession session, const revTextureSwapChainDesc* desc, revTextureSwapChain* out_TextureSwapChain) {
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (desc == NULL || out_TextureSwapChain == NULL || desc->Width <= 0 || desc->Height <= 0) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain description");
+	}
+
+	revTextureSwapChainData* chain = new revTextureSwapChainData();
+
+	chain->desc = *desc;
+	chain->length = desc->StaticImage ? 1 : mockConfig.swapChainLength;
+	chain->currentIndex = 0;
+	chain->commitsSinceSubmit = 0;
+	chain->committed = false;
+
+	for (int i = 0;i < chain->length;i++) {
+		chain->glTextures[i] = mockNextGLTexture++;
+	}
+
+	session->swapChains.push_back(chain);
+	*out_TextureSwapChain = chain;
+
+	return revSuccess;
+}
+
+revResult mockCreateMirror(revSession session, const revMirrorTextureDesc* desc, revMirrorTexture* out_MirrorTexture) {
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (desc == NULL || out_MirrorTexture == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid mirror texture description");
+	}
+
+	revMirrorTextureData* mirror = new revMirrorTextureData();
+
+	mirror->desc = *desc;
+	mirror->glTexture = mockNextGLTexture++;
+
+	session->mirrors.push_back(mirror);
+	*out_MirrorTexture = mirror;
+
+	return revSuccess;
+}
+
+// Returns false if a layer references a chain that was destroyed or never committed
+bool mockCheckLayerChain(revSession session, revTextureSwapChain chain, revResult* result) {
+	if (chain == NULL) {
+		return true;
+	}
+
+	if (!mockValidSwapChain(session, chain) || !chain->committed) {
+		*result = mockError(revError_TextureSwapChainInvalid, "Layer references an invalid or uncommitted swap chain");
+		return false;
+	}
+
+	chain->commitsSinceSubmit = 0;
+
+	return true;
+}
+
+void mockWriteStats() {
+	FILE* out = stderr;
+
+	if (mockConfig.statsFile[0] != '\0') {
+		out = fopen(mockConfig.statsFile, "w");
+		if (out == NULL) {
+			fprintf(stderr, "REVMock: could not write %s\n", mockConfig.statsFile);
+			return;
+		}
+	}
+
+	fprintf(out, "%-36s %10s %10s %10s %10s\n", "call", "count", "mean_us", "max_us", "total_ms");
+
+	for (int i = 0;i < mockCall_Count;i++) {
+		unsigned long long count = mockStats[i].count;
+
+		if (count == 0) {
+			continue;
+		}
+
+		fprintf(out, "%-36s %10llu %10.3f %10.3f %10.3f\n", mockCallNames[i], count,
+			(double)mockStats[i].totalNs / (double)count / 1000.0, (double)mockStats[i].maxNs / 1000.0, (double)mockStats[i].totalNs / 1000000.0);
+	}
+
+	if (out != stderr) {
+		fclose(out);
+	}
+}
+
+void mockDestroySession(revSession session) {
+	for (size_t i = 0;i < session->swapChains.size();i++) {
+		delete session->swapChains[i];
+	}
+	for (size_t i = 0;i < session->mirrors.size();i++) {
+		delete session->mirrors[i];
+	}
+
+	delete session;
+}
+
+// Initialization
+
+REVMOCK_EXPORT(revBool) ovr_InitializeRenderingShimVersion(int /*requestedMinorVersion*/) {
+	MOCK_CALL(ovr_InitializeRenderingShimVersion);
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(revResult) ovr_Initialize(const revInitParams* /*params*/) {
+	MOCK_CALL(ovr_Initialize);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (mockInitialized) {
+		return revSuccess;
+	}
+
+	mockLoadConfig(mockConfig);
+
+	for (int i = 0;i < mockCall_Count;i++) {
+		mockStats[i].count = 0;
+		mockStats[i].totalNs = 0;
+		mockStats[i].maxNs = 0;
+	}
+
+	mockStart = mockClock::now();
+	mockVirtualTime = 0.0;
+	mockInitialized = true;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revBool) ovr_Shutdown() {
+	{
+		MOCK_CALL(ovr_Shutdown);
+		std::lock_guard<std::mutex> lock(mockMutex);
+
+		if (!mockInitialized) {
+			return revFalse;
+		}
+
+		for (size_t i = 0;i < mockSessions.size();i++) {
+			mockDestroySession(mockSessions[i]);
+		}
+		mockSessions.clear();
+
+		mockInitialized = false;
+	}
+
+	//Written after the timer went out of scope so ovr_Shutdown itself is counted
+	mockWriteStats();
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(const char*) ovr_GetVersionString() {
+	MOCK_CALL(ovr_GetVersionString);
+
+	return "1.3.0-REVMock";
+}
+
+REVMOCK_EXPORT(void) ovr_GetLastErrorInfo(revErrorInfo* errorInfo) {
+	MOCK_CALL(ovr_GetLastErrorInfo);
+
+	if (errorInfo != NULL) {
+		*errorInfo = mockLastError;
+	}
+}
+
+REVMOCK_EXPORT(int) ovr_TraceMessage(int /*level*/, const char* message) {
+	MOCK_CALL(ovr_TraceMessage);
+
+	return message != NULL ? (int)strlen(message) : -1;
+}
+
+REVMOCK_EXPORT(revResult) ovr_Lookup(const char* /*name*/, void** /*data*/) {
+	MOCK_CALL(ovr_Lookup);
+
+	return mockError(revError_Unsupported, "ovr_Lookup is not supported");
+}
+
+// Sessions
+
+REVMOCK_EXPORT(revHmdDesc) ovr_GetHmdDesc(revSession /*session*/) {
+	MOCK_CALL(ovr_GetHmdDesc);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockHmdDesc();
+}
+
+REVMOCK_EXPORT(unsigned int) ovr_GetTrackerCount(revSession /*session*/) {
+	MOCK_CALL(ovr_GetTrackerCount);
+
+	return 2;
+}
+
+REVMOCK_EXPORT(revTrackerDesc) ovr_GetTrackerDesc(revSession /*session*/, unsigned int trackerDescIndex) {
+	MOCK_CALL(ovr_GetTrackerDesc);
+	revTrackerDesc desc;
+
+	memset(&desc, 0, sizeof(desc));
+
+	if (trackerDescIndex < 2) {
+		desc.FrustumHFovInRadians = 100.0f * mockDegrees;
+		desc.FrustumVFovInRadians = 70.0f * mockDegrees;
+		desc.FrustumNearZInMeters = 0.4f;
+		desc.FrustumFarZInMeters = 2.5f;
+	}
+
+	return desc;
+}
+
+REVMOCK_EXPORT(revResult) ovr_Create(revSession* pSession, revGraphicsLuid* pLuid) {
+	MOCK_CALL(ovr_Create);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockInitialized) {
+		return mockError(revError_NotInitialized, "ovr_Initialize was not called");
+	}
+	if (pSession == NULL) {
+		return mockError(revError_InvalidParameter, "pSession is NULL");
+	}
+
+	revHmdStruct* session = new revHmdStruct();
+
+	session->origin = revTrackingOrigin_EyeLevel;
+	session->recenter.Orientation.x = session->recenter.Orientation.y = session->recenter.Orientation.z = 0.0f;
+	session->recenter.Orientation.w = 1.0f;
+	session->recenter.Position.x = session->recenter.Position.y = session->recenter.Position.z = 0.0f;
+	session->shouldRecenter = false;
+	session->submittedFrames = 0;
+	session->lastFrameIndex = -1;
+	session->lastDisplayTime = 0.0;
+	session->queueAheadFraction = 0.25f;
+	for (int hand = 0;hand < revHand_Count;hand++) {
+		session->vibrationFrequency[hand] = 0.0f;
+		session->vibrationAmplitude[hand] = 0.0f;
+	}
+	session->layersSubmitted = 0;
+	mockSeedProperties(session);
+
+	mockSessions.push_back(session);
+
+	*pSession = session;
+	if (pLuid != NULL) {
+		memset(pLuid, 0, sizeof(*pLuid));
+	}
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(void) ovr_Destroy(revSession session) {
+	MOCK_CALL(ovr_Destroy);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	for (size_t i = 0;i < mockSessions.size();i++) {
+		if (mockSessions[i] == session) {
+			mockSessions.erase(mockSessions.begin() + i);
+			mockDestroySession(session);
+			return;
+		}
+	}
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetSessionStatus(revSession session, revSessionStatus* sessionStatus) {
+	MOCK_CALL(ovr_GetSessionStatus);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (sessionStatus == NULL) {
+		return mockError(revError_InvalidParameter, "sessionStatus is NULL");
+	}
+
+	sessionStatus->IsVisible = revTrue;
+	sessionStatus->HmdPresent = revTrue;
+	sessionStatus->HmdMounted = revTrue;
+	sessionStatus->DisplayLost = revFalse;
+	sessionStatus->ShouldQuit = mockConfig.quitAfterFrames > 0 && session->submittedFrames >= mockConfig.quitAfterFrames;
+	sessionStatus->ShouldRecenter = session->shouldRecenter;
+
+	return revSuccess;
+}
+
+// Tracking
+
+REVMOCK_EXPORT(revResult) ovr_SetTrackingOriginType(revSession session, revTrackingOrigin origin) {
+	MOCK_CALL(ovr_SetTrackingOriginType);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (origin != revTrackingOrigin_EyeLevel && origin != revTrackingOrigin_FloorLevel) {
+		return mockError(revError_InvalidParameter, "Unknown tracking origin");
+	}
+
+	session->origin = origin;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revTrackingOrigin) ovr_GetTrackingOriginType(revSession session) {
+	MOCK_CALL(ovr_GetTrackingOriginType);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockValidSession(session) ? session->origin : revTrackingOrigin_EyeLevel;
+}
+
+REVMOCK_EXPORT(revResult) ovr_RecenterTrackingOrigin(revSession session) {
+	MOCK_CALL(ovr_RecenterTrackingOrigin);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+
+	//Recenter on the scripted head pose, keeping only its yaw like the real runtime
+	MockEuler e = mockSampleScript(mockNow());
+
+	session->recenter.Orientation = mockQuatEuler(e.yaw, 0.0f, 0.0f);
+	session->recenter.Position = e.position;
+	if (session->origin == revTrackingOrigin_FloorLevel) {
+		session->recenter.Position.y = 0.0f;
+	}
+	session->shouldRecenter = false;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(void) ovr_ClearShouldRecenterFlag(revSession session) {
+	MOCK_CALL(ovr_ClearShouldRecenterFlag);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (mockValidSession(session)) {
+		session->shouldRecenter = false;
+	}
+}
+
+REVMOCK_EXPORT(revTrackingState) ovr_GetTrackingState(revSession session, double absTime, revBool /*latencyMarker*/) {
+	MOCK_CALL(ovr_GetTrackingState);
+	std::lock_guard<std::mutex> lock(mockMutex);
+	revTrackingState state;
+
+	memset(&state, 0, sizeof(state));
+
+	if (!mockValidSession(session)) {
+		return state;
+	}
+
+	if (absTime <= 0.0) {
+		absTime = mockNow();
+	}
+
+	state.HeadPose = mockPoseState(session, -1, absTime);
+	state.StatusFlags = revStatus_OrientationTracked | revStatus_PositionTracked;
+
+	for (int hand = 0;hand < revHand_Count;hand++) {
+		if (mockConfig.controllers & (revControllerType_LTouch << hand)) {
+			state.HandPoses[hand] = mockPoseState(session, hand, absTime);
+			state.HandStatusFlags[hand] = revStatus_OrientationTracked | revStatus_PositionTracked;
+		}
+	}
+
+	state.CalibratedOrigin.Orientation.w = 1.0f;
+
+	return state;
+}
+
+REVMOCK_EXPORT(revTrackerPose) ovr_GetTrackerPose(revSession /*session*/, unsigned int trackerPoseIndex) {
+	MOCK_CALL(ovr_GetTrackerPose);
+	revTrackerPose pose;
+
+	memset(&pose, 0, sizeof(pose));
+
+	if (trackerPoseIndex >= 2) {
+		return pose;
+	}
+
+	//Two sensors on the desk facing the user, a metre apart
+	pose.TrackerFlags = revTracker_Connected | revTracker_PoseTracked;
+	pose.Pose.Orientation = mockQuatEuler(trackerPoseIndex == 0 ? 20.0f * mockDegrees : -20.0f * mockDegrees, -10.0f * mockDegrees, 0.0f);
+	pose.Pose.Position.x = trackerPoseIndex == 0 ? -0.5f : 0.5f;
+	pose.Pose.Position.y = -0.4f;
+	pose.Pose.Position.z = -1.5f;
+	pose.LeveledPose.Orientation = mockQuatEuler(trackerPoseIndex == 0 ? 20.0f * mockDegrees : -20.0f * mockDegrees, 0.0f, 0.0f);
+	pose.LeveledPose.Position = pose.Pose.Position;
+
+	return pose;
+}
+
+// Input
+
+REVMOCK_EXPORT(revResult) ovr_GetInputState(revSession session, revControllerType controllerType, revInputState* inputState) {
+	MOCK_CALL(ovr_GetInputState);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (inputState == NULL) {
+		return mockError(revError_InvalidParameter, "inputState is NULL");
+	}
+
+	memset(inputState, 0, sizeof(*inputState));
+
+	unsigned int connected = controllerType == revControllerType_Active ? mockConfig.controllers : mockConfig.controllers & (unsigned int)controllerType;
+
+	double time = mockNow();
+	inputState->TimeInSeconds = time;
+
+	if (connected == 0) {
+		return revSuccess;
+	}
+
+	//Scripted input: thumbsticks circle once every two seconds, triggers ramp up every second,
+	//A/X are held for the first half of every second and B/Y for the second half
+	float phase = (float)fmod(time, 1.0);
+	bool firstHalf = phase < 0.5f;
+
+	if (connected & revControllerType_Touch) {
+		inputState->ControllerType = (revControllerType)(connected & revControllerType_Touch);
+
+		if (connected & revControllerType_LTouch) {
+			inputState->Buttons |= firstHalf ? revButton_X : revButton_Y;
+			inputState->Touches |= (firstHalf ? revTouch_X : revTouch_Y) | revTouch_LIndexTrigger | revTouch_LThumb;
+			inputState->IndexTrigger[revHand_Left] = phase;
+			inputState->HandTrigger[revHand_Left] = 1.0f - phase;
+			inputState->Thumbstick[revHand_Left].x = (float)cos(time * 3.14159265);
+			inputState->Thumbstick[revHand_Left].y = (float)sin(time * 3.14159265);
+		}
+
+		if (connected & revControllerType_RTouch) {
+			inputState->Buttons |= firstHalf ? revButton_A : revButton_B;
+			inputState->Touches |= (firstHalf ? revTouch_A : revTouch_B) | revTouch_RIndexTrigger | revTouch_RThumb;
+			inputState->IndexTrigger[revHand_Right] = phase;
+			inputState->HandTrigger[revHand_Right] = 1.0f - phase;
+			inputState->Thumbstick[revHand_Right].x = (float)-cos(time * 3.14159265);
+			inputState->Thumbstick[revHand_Right].y = (float)sin(time * 3.14159265);
+		}
+	}
+	else if (connected & revControllerType_XBox) {
+		inputState->ControllerType = revControllerType_XBox;
+		inputState->Buttons = firstHalf ? revButton_A : revButton_B;
+		inputState->IndexTrigger[revHand_Left] = inputState->IndexTrigger[revHand_Right] = phase;
+		inputState->Thumbstick[revHand_Left].x = (float)cos(time * 3.14159265);
+		inputState->Thumbstick[revHand_Left].y = (float)sin(time * 3.14159265);
+	}
+	else if (connected & revControllerType_Remote) {
+		inputState->ControllerType = revControllerType_Remote;
+		inputState->Buttons = firstHalf ? revButton_Enter : 0;
+	}
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(unsigned int) ovr_GetConnectedControllerTypes(revSession /*session*/) {
+	MOCK_CALL(ovr_GetConnectedControllerTypes);
+
+	return mockConfig.controllers;
+}
+
+REVMOCK_EXPORT(revResult) ovr_SetControllerVibration(revSession session, revControllerType controllerType, float frequency, float amplitude) {
+	MOCK_CALL(ovr_SetControllerVibration);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+
+	for (int hand = 0;hand < revHand_Count;hand++) {
+		if (controllerType & (revControllerType_LTouch << hand)) {
+			session->vibrationFrequency[hand] = frequency;
+			session->vibrationAmplitude[hand] = amplitude;
+		}
+	}
+
+	return revSuccess;
+}
+
+// Rendering
+
+REVMOCK_EXPORT(revSizei) ovr_GetFovTextureSize(revSession /*session*/, revEyeType /*eye*/, revFovPort fov, float pixelsPerDisplayPixel) {
+	MOCK_CALL(ovr_GetFovTextureSize);
+	revSizei size;
+
+	size.w = (int)ceilf((fov.LeftTan + fov.RightTan) * mockPixelsPerTanAngle * pixelsPerDisplayPixel);
+	size.h = (int)ceilf((fov.UpTan + fov.DownTan) * mockPixelsPerTanAngle * pixelsPerDisplayPixel);
+
+	return size;
+}
+
+REVMOCK_EXPORT(revEyeRenderDesc) ovr_GetRenderDesc(revSession session, revEyeType eyeType, revFovPort fov) {
+	MOCK_CALL(ovr_GetRenderDesc);
+	std::lock_guard<std::mutex> lock(mockMutex);
+	revEyeRenderDesc desc;
+
+	memset(&desc, 0, sizeof(desc));
+
+	desc.Eye = eyeType;
+	desc.Fov = fov;
+	desc.DistortedViewport.Pos.x = eyeType == revEye_Left ? 0 : mockResolution.w / 2;
+	desc.DistortedViewport.Pos.y = 0;
+	desc.DistortedViewport.Size.w = mockResolution.w / 2;
+	desc.DistortedViewport.Size.h = mockResolution.h;
+	desc.PixelsPerTanAngleAtCenter.x = mockPixelsPerTanAngle;
+	desc.PixelsPerTanAngleAtCenter.y = mockPixelsPerTanAngle;
+
+	float ipd = mockValidSession(session) ? mockIpd(session) : 0.064f;
+	desc.HmdToEyeOffset.x = eyeType == revEye_Left ? -ipd * 0.5f : ipd * 0.5f;
+
+	return desc;
+}
+
+REVMOCK_EXPORT(revResult) ovr_SubmitFrame(revSession session, long long frameIndex, const revViewScaleDesc* /*viewScaleDesc*/,
+	revLayerHeader const * const * layerPtrList, unsigned int layerCount) {
+	MOCK_CALL(ovr_SubmitFrame);
+	double waitUntil;
+
+	{
+		std::lock_guard<std::mutex> lock(mockMutex);
+
+		if (!mockValidSession(session)) {
+			return mockError(revError_InvalidSession, "Invalid session");
+		}
+		if (layerCount > revMaxLayerCount || (layerCount > 0 && layerPtrList == NULL)) {
+			return mockError(revError_InvalidParameter, "Invalid layer list");
+		}
+
+		revResult result = revSuccess;
+
+		for (unsigned int i = 0;i < layerCount;i++) {
+			const revLayerHeader* layer = layerPtrList[i];
+
+			if (layer == NULL) {
+				continue;
+			}
+
+			switch (layer->Type) {
+			case revLayerType_EyeFov:
+			case revLayerType_EyeMatrix:
+				//revLayerEyeMatrix starts with the same header and color textures as revLayerEyeFov
+				if (!mockCheckLayerChain(session, ((const revLayerEyeFov*)layer)->ColorTexture[0], &result) ||
+					!mockCheckLayerChain(session, ((const revLayerEyeFov*)layer)->ColorTexture[1], &result)) {
+					return result;
+				}
+				break;
+			case revLayerType_Quad:
+				if (!mockCheckLayerChain(session, ((const revLayerQuad*)layer)->ColorTexture, &result)) {
+					return result;
+				}
+				break;
+			case revLayerType_Disabled:
+				continue;
+			default:
+				return mockError(revError_InvalidParameter, "Unknown layer type");
+			}
+
+			session->layersSubmitted++;
+		}
+
+		double now = mockNow();
+
+		switch (mockConfig.submitMode) {
+		case mockSubmit_Vsync:
+			waitUntil = mockNextVsync(now);
+			break;
+		case mockSubmit_Fixed:
+			waitUntil = now + mockConfig.submitSeconds;
+			break;
+		default:
+			waitUntil = now;
+			break;
+		}
+
+		session->submittedFrames++;
+		session->lastFrameIndex = frameIndex > 0 ? frameIndex : session->lastFrameIndex + 1;
+		session->lastDisplayTime = mockNextVsync(waitUntil);
+
+		//The virtual clock moves while holding the lock so concurrent callers see it advance once
+		if (mockConfig.virtualClock) {
+			mockWaitUntil(mockConfig.submitMode == mockSubmit_None ? mockNextVsync(now) : waitUntil);
+			return revSuccess;
+		}
+	}
+
+	if (mockConfig.submitMode != mockSubmit_None) {
+		mockWaitUntil(waitUntil);
+	}
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(double) ovr_GetPredictedDisplayTime(revSession session, long long frameIndex) {
+	MOCK_CALL(ovr_GetPredictedDisplayTime);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	double next = mockNextVsync(mockNow());
+
+	if (!mockValidSession(session)) {
+		return next;
+	}
+
+	if (frameIndex <= 0) {
+		frameIndex = session->lastFrameIndex + 1;
+	}
+
+	//Frames already submitted keep the vsync they were scheduled for, later ones queue behind the next vsync
+	if (frameIndex <= session->lastFrameIndex) {
+		return session->lastDisplayTime - (double)(session->lastFrameIndex - frameIndex) * mockFrameInterval();
+	}
+
+	return next + (double)(frameIndex - session->lastFrameIndex - 1) * mockFrameInterval();
+}
+
+REVMOCK_EXPORT(double) ovr_GetTimeInSeconds() {
+	MOCK_CALL(ovr_GetTimeInSeconds);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockNow();
+}
+
+REVMOCK_EXPORT(revResult) ovr_SetQueueAheadFraction(revSession session, float queueAheadFraction) {
+	MOCK_CALL(ovr_SetQueueAheadFraction);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return mockError(revError_InvalidSession, "Invalid session");
+	}
+	if (queueAheadFraction < 0.0f || queueAheadFraction > 1.0f) {
+		return mockError(revError_InvalidParameter, "queueAheadFraction out of range");
+	}
+
+	session->queueAheadFraction = queueAheadFraction;
+
+	return revSuccess;
+}
+
+// Properties
+
+REVMOCK_EXPORT(revBool) ovr_GetBool(revSession session, const char* propertyName, revBool defaultVal) {
+	MOCK_CALL(ovr_GetBool);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Bool, false) : NULL;
+
+	return p != NULL ? (revBool)p->intValue : defaultVal;
+}
+
+REVMOCK_EXPORT(revBool) ovr_SetBool(revSession session, const char* propertyName, revBool value) {
+	MOCK_CALL(ovr_SetBool);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Bool, true) : NULL;
+
+	if (p == NULL) {
+		return revFalse;
+	}
+
+	p->intValue = value;
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(int) ovr_GetInt(revSession session, const char* propertyName, int defaultVal) {
+	MOCK_CALL(ovr_GetInt);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Int, false) : NULL;
+
+	return p != NULL ? p->intValue : defaultVal;
+}
+
+REVMOCK_EXPORT(revBool) ovr_SetInt(revSession session, const char* propertyName, int value) {
+	MOCK_CALL(ovr_SetInt);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Int, true) : NULL;
+
+	if (p == NULL) {
+		return revFalse;
+	}
+
+	p->intValue = value;
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(float) ovr_GetFloat(revSession session, const char* propertyName, float defaultVal) {
+	MOCK_CALL(ovr_GetFloat);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Float, false) : NULL;
+
+	return p != NULL ? p->floats[0] : defaultVal;
+}
+
+REVMOCK_EXPORT(revBool) ovr_SetFloat(revSession session, const char* propertyName, float value) {
+	MOCK_CALL(ovr_SetFloat);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_Float, true) : NULL;
+
+	if (p == NULL) {
+		return revFalse;
+	}
+
+	p->floats[0] = value;
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(unsigned int) ovr_GetFloatArray(revSession session, const char* propertyName, float values[], unsigned int arraySize) {
+	MOCK_CALL(ovr_GetFloatArray);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_FloatArray, false) : NULL;
+
+	if (p == NULL || values == NULL) {
+		return 0;
+	}
+
+	unsigned int count = p->floatCount < arraySize ? p->floatCount : arraySize;
+	memcpy(values, p->floats, count * sizeof(float));
+
+	return count;
+}
+
+REVMOCK_EXPORT(revBool) ovr_SetFloatArray(revSession session, const char* propertyName, const float values[], unsigned int arraySize) {
+	MOCK_CALL(ovr_SetFloatArray);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (arraySize > mockMaxFloats || (arraySize > 0 && values == NULL)) {
+		return revFalse;
+	}
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_FloatArray, true) : NULL;
+
+	if (p == NULL) {
+		return revFalse;
+	}
+
+	memcpy(p->floats, values, arraySize * sizeof(float));
+	p->floatCount = arraySize;
+
+	return revTrue;
+}
+
+REVMOCK_EXPORT(const char*) ovr_GetString(revSession session, const char* propertyName, const char* defaultVal) {
+	MOCK_CALL(ovr_GetString);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_String, false) : NULL;
+
+	//Like the real runtime the string stays valid until the property is set again or the session is destroyed
+	return p != NULL ? p->string : defaultVal;
+}
+
+REVMOCK_EXPORT(revBool) ovr_SetString(revSession session, const char* propertyName, const char* value) {
+	MOCK_CALL(ovr_SetString);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (value == NULL || strlen(value) >= sizeof(((MockProperty*)0)->string)) {
+		return revFalse;
+	}
+
+	MockProperty* p = mockValidSession(session) ? mockFindProperty(session, propertyName, mockProperty_String, true) : NULL;
+
+	if (p == NULL) {
+		return revFalse;
+	}
+
+	strcpy(p->string, value);
+
+	return revTrue;
+}
+
+// Swap chains and mirror textures
+
+REVMOCK_EXPORT(revResult) ovr_GetTextureSwapChainLength(revSession session, revTextureSwapChain chain, int* out_Length) {
+	MOCK_CALL(ovr_GetTextureSwapChainLength);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || !mockValidSwapChain(session, chain) || out_Length == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain");
+	}
+
+	*out_Length = chain->length;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetTextureSwapChainCurrentIndex(revSession session, revTextureSwapChain chain, int* out_Index) {
+	MOCK_CALL(ovr_GetTextureSwapChainCurrentIndex);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || !mockValidSwapChain(session, chain) || out_Index == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain");
+	}
+
+	*out_Index = chain->currentIndex;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetTextureSwapChainDesc(revSession session, revTextureSwapChain chain, revTextureSwapChainDesc* out_Desc) {
+	MOCK_CALL(ovr_GetTextureSwapChainDesc);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || !mockValidSwapChain(session, chain) || out_Desc == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain");
+	}
+
+	*out_Desc = chain->desc;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_CommitTextureSwapChain(revSession session, revTextureSwapChain chain) {
+	MOCK_CALL(ovr_CommitTextureSwapChain);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || !mockValidSwapChain(session, chain)) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain");
+	}
+
+	//The compositor holds on to one texture, committing more than the rest without a submit would overwrite it
+	if (chain->length > 1 && chain->commitsSinceSubmit >= chain->length - 1) {
+		return mockError(revError_TextureSwapChainFull, "Swap chain committed too many times without a submit");
+	}
+	if (chain->desc.StaticImage && chain->committed) {
+		return mockError(revError_TextureSwapChainFull, "Static image already committed");
+	}
+
+	chain->committed = true;
+	chain->commitsSinceSubmit++;
+	chain->currentIndex = (chain->currentIndex + 1) % chain->length;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(void) ovr_DestroyTextureSwapChain(revSession session, revTextureSwapChain chain) {
+	MOCK_CALL(ovr_DestroyTextureSwapChain);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return;
+	}
+
+	for (size_t i = 0;i < session->swapChains.size();i++) {
+		if (session->swapChains[i] == chain) {
+			session->swapChains.erase(session->swapChains.begin() + i);
+			delete chain;
+			return;
+		}
+	}
+}
+
+REVMOCK_EXPORT(void) ovr_DestroyMirrorTexture(revSession session, revMirrorTexture mirror) {
+	MOCK_CALL(ovr_DestroyMirrorTexture);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session)) {
+		return;
+	}
+
+	for (size_t i = 0;i < session->mirrors.size();i++) {
+		if (session->mirrors[i] == mirror) {
+			session->mirrors.erase(session->mirrors.begin() + i);
+			delete mirror;
+			return;
+		}
+	}
+}
+
+// OpenGL, texture names are handed out but no GL objects exist behind them
+
+REVMOCK_EXPORT(revResult) ovr_CreateTextureSwapChainGL(revSession session, const revTextureSwapChainDesc* desc, revTextureSwapChain* out_TextureSwapChain) {
+	MOCK_CALL(ovr_CreateTextureSwapChainGL);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockCreateSwapChain(session, desc, out_TextureSwapChain);
+}
+
+REVMOCK_EXPORT(revResult) ovr_CreateMirrorTextureGL(revSession session, const revMirrorTextureDesc* desc, revMirrorTexture* out_MirrorTexture) {
+	MOCK_CALL(ovr_CreateMirrorTextureGL);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockCreateMirror(session, desc, out_MirrorTexture);
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetTextureSwapChainBufferGL(revSession session, revTextureSwapChain chain, int index, unsigned int* out_TexId) {
+	MOCK_CALL(ovr_GetTextureSwapChainBufferGL);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || !mockValidSwapChain(session, chain) || out_TexId == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid swap chain");
+	}
+	if (index < 0) {
+		index = chain->currentIndex;
+	}
+	if (index >= chain->length) {
+		return mockError(revError_InvalidParameter, "Swap chain index out of range");
+	}
+
+	*out_TexId = chain->glTextures[index];
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetMirrorTextureBufferGL(revSession session, revMirrorTexture mirror, unsigned int* out_TexId) {
+	MOCK_CALL(ovr_GetMirrorTextureBufferGL);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	if (!mockValidSession(session) || mirror == NULL || out_TexId == NULL) {
+		return mockError(revError_InvalidParameter, "Invalid mirror texture");
+	}
+
+	*out_TexId = mirror->glTexture;
+
+	return revSuccess;
+}
+
+#if defined(_WIN32)
+
+// Direct3D, the swap chains are tracked but have no device resources, so there are no buffers to hand out
+
+REVMOCK_EXPORT(revResult) ovr_CreateTextureSwapChainDX(revSession session, IUnknown* /*d3dPtr*/, const revTextureSwapChainDesc* desc, revTextureSwapChain* out_TextureSwapChain) {
+	MOCK_CALL(ovr_CreateTextureSwapChainDX);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockCreateSwapChain(session, desc, out_TextureSwapChain);
+}
+
+REVMOCK_EXPORT(revResult) ovr_CreateMirrorTextureDX(revSession session, IUnknown* /*d3dPtr*/, const revMirrorTextureDesc* desc, revMirrorTexture* out_MirrorTexture) {
+	MOCK_CALL(ovr_CreateMirrorTextureDX);
+	std::lock_guard<std::mutex> lock(mockMutex);
+
+	return mockCreateMirror(session, desc, out_MirrorTexture);
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetTextureSwapChainBufferDX(revSession /*session*/, revTextureSwapChain /*chain*/, int /*index*/, IID /*iid*/, void** out_Buffer) {
+	MOCK_CALL(ovr_GetTextureSwapChainBufferDX);
+
+	if (out_Buffer != NULL) {
+		*out_Buffer = NULL;
+	}
+
+	return mockError(revError_Unsupported, "REVMock swap chains have no Direct3D textures");
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetMirrorTextureBufferDX(revSession /*session*/, revMirrorTexture /*mirror*/, IID /*iid*/, void** out_Buffer) {
+	MOCK_CALL(ovr_GetMirrorTextureBufferDX);
+
+	if (out_Buffer != NULL) {
+		*out_Buffer = NULL;
+	}
+
+	return mockError(revError_Unsupported, "REVMock mirror textures have no Direct3D textures");
+}
+
+// Audio, reports the default devices
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceOutWaveId(UINT* deviceOutId) {
+	MOCK_CALL(ovr_GetAudioDeviceOutWaveId);
+
+	if (deviceOutId == NULL) {
+		return mockError(revError_InvalidParameter, "deviceOutId is NULL");
+	}
+
+	*deviceOutId = WAVE_MAPPER;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceInWaveId(UINT* deviceInId) {
+	MOCK_CALL(ovr_GetAudioDeviceInWaveId);
+
+	if (deviceInId == NULL) {
+		return mockError(revError_InvalidParameter, "deviceInId is NULL");
+	}
+
+	*deviceInId = WAVE_MAPPER;
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceOutGuidStr(WCHAR* deviceOutStrBuffer) {
+	MOCK_CALL(ovr_GetAudioDeviceOutGuidStr);
+
+	if (deviceOutStrBuffer == NULL) {
+		return mockError(revError_InvalidParameter, "deviceOutStrBuffer is NULL");
+	}
+
+	deviceOutStrBuffer[0] = L'\0';
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceOutGuid(GUID* deviceOutGuid) {
+	MOCK_CALL(ovr_GetAudioDeviceOutGuid);
+
+	if (deviceOutGuid == NULL) {
+		return mockError(revError_InvalidParameter, "deviceOutGuid is NULL");
+	}
+
+	memset(deviceOutGuid, 0, sizeof(GUID));
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceInGuidStr(WCHAR* deviceInStrBuffer) {
+	MOCK_CALL(ovr_GetAudioDeviceInGuidStr);
+
+	if (deviceInStrBuffer == NULL) {
+		return mockError(revError_InvalidParameter, "deviceInStrBuffer is NULL");
+	}
+
+	deviceInStrBuffer[0] = L'\0';
+
+	return revSuccess;
+}
+
+REVMOCK_EXPORT(revResult) ovr_GetAudioDeviceInGuid(GUID* deviceInGuid) {
+	MOCK_CALL(ovr_GetAudioDeviceInGuid);
+
+	if (deviceInGuid == NULL) {
+		return mockError(revError_InvalidParameter, "deviceInGuid is NULL");
+	}
+
+	memset(deviceInGuid, 0, sizeof(GUID));
+
+	return revSuccess;
+}
+
+#endif
@@ -1,11 +1,12 @@
 #include "CompositorBase.h"
+#include "HmdProperties.h"
+#include "Session.h"
 #include "OVR_CAPI.h"
 #include "REV_Math.h"
 #include "microprofile.h"
 
 #include <openvr.h>
 #include <vector>
-#include <algorithm>
 
 #define REV_LAYER_BIAS 0.0001f
 
@@ -16,22 +17,55 @@ MICROPROFILE_DEFINE(SubmitSceneLayer, "Compositor", "SubmitSceneLayer", 0x00ff00
 CompositorBase::CompositorBase()
 	: m_MirrorTexture(nullptr)
 	, m_ChainCount(0)
+	, m_OverlayCount(0)
+	, m_Generation(0)
 {
 	m_SceneLayer = nullptr;
+
+	for (OverlaySlot& slot : m_Overlays)
+	{
+		slot.Chain = nullptr;
+		slot.Handle = vr::k_ulOverlayHandleInvalid;
+		slot.Generation = 0;
+		slot.Visible = false;
+		slot.Cached = false;
+	}
+
+	m_OverlayStats.Issued = 0;
+	m_OverlayStats.Suppressed = 0;
 }
 
 CompositorBase::~CompositorBase()
 {
+	for (OverlaySlot& slot : m_Overlays)
+	{
+		if (slot.Handle != vr::k_ulOverlayHandleInvalid)
+			vr::VROverlay()->DestroyOverlay(slot.Handle);
+	}
+
 	if (m_MirrorTexture)
 		delete m_MirrorTexture;
 }
 
-vr::EVRCompositorError CompositorBase::SubmitFrame(ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
+vr::EVRCompositorError CompositorBase::SubmitFrame(ovrSession session, const ovrViewScaleDesc* viewScaleDesc, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount)
 {
 	MICROPROFILE_SCOPE(SubmitFrame);
 
+	// Start a new overlay generation, every overlay not stamped with it by the end of the frame is hidden.
+	if (++m_Generation == 0)
+		m_Generation = 1;
+
+	m_OverlayStats.Issued = 0;
+	m_OverlayStats.Suppressed = 0;
+
+	// The view scale is shared by all quad layers of the frame.
+	ViewScale viewScale = GetViewScale(session, viewScaleDesc);
+
+	// The tracking space is only queried once per frame and only if there are world-locked overlays.
+	vr::ETrackingUniverseOrigin space = vr::TrackingUniverseStanding;
+	bool hasSpace = false;
+
 	// Other layers are interpreted as overlays.
-	std::vector<vr::VROverlayHandle_t> activeOverlays;
 	for (uint32_t i = 0; i < layerCount; i++)
 	{
 		if (layerPtrList[i] == nullptr)
@@ -44,36 +78,74 @@ vr::EVRCompositorError CompositorBase::SubmitFrame(ovrLayerHeader const * const
 			// Every overlay is associated with a swapchain.
 			// This is necessary because the position of the layer may change in the array,
 			// which would otherwise cause flickering between overlays.
-			// TODO: Support multiple overlays using the same texture.
-			vr::VROverlayHandle_t overlay = layer->ColorTexture->Overlay;
-			if (overlay == vr::k_ulOverlayHandleInvalid)
-			{
-				overlay = CreateOverlay();
-				layer->ColorTexture->Overlay = overlay;
-			}
-			activeOverlays.push_back(overlay);
+			OverlaySlot* slot = AcquireOverlay(layer->ColorTexture);
+			if (!slot)
+				continue;
+			vr::VROverlayHandle_t overlay = slot->Handle;
+
+			// Every call below is a round-trip to the compositor, so only the parameters that
+			// changed since the last frame are sent to the overlay.
 
 			// Set the layer rendering order.
-			vr::VROverlay()->SetOverlaySortOrder(overlay, i);
+			if (CountOverlayCall(!slot->Cached || slot->SortOrder != i))
+			{
+				vr::VROverlay()->SetOverlaySortOrder(overlay, i);
+				slot->SortOrder = i;
+			}
 
 			// Transform the overlay.
-			vr::HmdMatrix34_t transform = REV::Matrix4f(layer->QuadPoseCenter);
-			vr::VROverlay()->SetOverlayWidthInMeters(overlay, layer->QuadSize.x);
-			if (layer->Header.Flags & ovrLayerFlag_HeadLocked)
-				vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(overlay, vr::k_unTrackedDeviceIndex_Hmd, &transform);
-			else
-				vr::VROverlay()->SetOverlayTransformAbsolute(overlay, vr::VRCompositor()->GetTrackingSpace(), &transform);
+			bool headLocked = (layer->Header.Flags & ovrLayerFlag_HeadLocked) != 0;
+			float width = layer->QuadSize.x * viewScale.WorldToMeters;
+			if (headLocked)
+				width *= viewScale.EyeScale;
+			if (CountOverlayCall(!slot->Cached || slot->Width != width))
+			{
+				vr::VROverlay()->SetOverlayWidthInMeters(overlay, width);
+				slot->Width = width;
+			}
+
+			vr::HmdMatrix34_t transform = REV::Matrix4f(ScaleQuadPose(viewScale, layer->QuadPoseCenter, headLocked));
+			if (!headLocked && !hasSpace)
+			{
+				space = vr::VRCompositor()->GetTrackingSpace();
+				hasSpace = CountOverlayCall(true);
+			}
+
+			bool transformChanged = !slot->Cached || slot->HeadLocked != headLocked ||
+				(!headLocked && slot->Space != space) || memcmp(&slot->Transform, &transform, sizeof(transform)) != 0;
+			if (CountOverlayCall(transformChanged))
+			{
+				if (headLocked)
+					vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(overlay, vr::k_unTrackedDeviceIndex_Hmd, &transform);
+				else
+					vr::VROverlay()->SetOverlayTransformAbsolute(overlay, space, &transform);
+				slot->HeadLocked = headLocked;
+				slot->Space = space;
+				slot->Transform = transform;
+			}
 
 			// Set the texture and show the overlay.
 			vr::VRTextureBounds_t bounds = ViewportToTextureBounds(layer->Viewport, layer->ColorTexture, layer->Header.Flags);
-			vr::VROverlay()->SetOverlayTextureBounds(overlay, &bounds);
+			if (CountOverlayCall(!slot->Cached || memcmp(&slot->Bounds, &bounds, sizeof(bounds)) != 0))
+			{
+				vr::VROverlay()->SetOverlayTextureBounds(overlay, &bounds);
+				slot->Bounds = bounds;
+			}
+
+			// The texture is always sent, it tells the compositor a new image is ready.
 			vr::VROverlay()->SetOverlayTexture(overlay, &layer->ColorTexture->Submitted->ToVRTexture());
+			CountOverlayCall(true);
+			slot->Cached = true;
 
 			// Show the overlay, unfortunately we have no control over the order in which
 			// overlays are drawn.
 			// TODO: Support ovrLayerFlag_HighQuality for overlays with anisotropic sampling.
 			// TODO: Handle overlay errors.
-			vr::VROverlay()->ShowOverlay(overlay);
+			if (CountOverlayCall(!slot->Visible))
+			{
+				vr::VROverlay()->ShowOverlay(overlay);
+				slot->Visible = true;
+			}
 		}
 		else if (layerPtrList[i]->Type == ovrLayerType_EyeFov)
 		{
@@ -101,20 +173,25 @@ vr::EVRCompositorError CompositorBase::SubmitFrame(ovrLayerHeader const * const
 	}
 
 	// Hide previous overlays that are not part of the current layers.
-	for (vr::VROverlayHandle_t overlay : m_ActiveOverlays)
+	for (OverlaySlot& slot : m_Overlays)
 	{
-		// Find the overlay in the current active overlays, if it was not found then hide it.
 		// TODO: Handle overlay errors.
-		if (std::find(activeOverlays.begin(), activeOverlays.end(), overlay) == activeOverlays.end())
-			vr::VROverlay()->HideOverlay(overlay);
+		if (slot.Visible && slot.Generation != m_Generation)
+		{
+			vr::VROverlay()->HideOverlay(slot.Handle);
+			slot.Visible = false;
+			CountOverlayCall(true);
+		}
 	}
-	m_ActiveOverlays = activeOverlays;
+
+	MICROPROFILE_META_CPU("Overlay Calls Issued", m_OverlayStats.Issued);
+	MICROPROFILE_META_CPU("Overlay Calls Suppressed", m_OverlayStats.Suppressed);
 
 	vr::EVRCompositorError error = vr::VRCompositorError_None;
 	if (m_SceneLayer && m_SceneLayer->Type == ovrLayerType_EyeFov)
 	{
 		ovrLayerEyeFov* sceneLayer = (ovrLayerEyeFov*)m_SceneLayer;
-		error = SubmitSceneLayer(sceneLayer->Viewport, sceneLayer->Fov, sceneLayer->ColorTexture, sceneLayer->Header.Flags);
+		error = SubmitSceneLayer(session, sceneLayer->Viewport, sceneLayer->Fov, sceneLayer->ColorTexture, sceneLayer->Header.Flags);
 
 		if (m_MirrorTexture && error == vr::VRCompositorError_None)
 			RenderMirrorTexture(m_MirrorTexture, sceneLayer->ColorTexture);
@@ -128,7 +205,7 @@ vr::EVRCompositorError CompositorBase::SubmitFrame(ovrLayerHeader const * const
 			MatrixToFovPort(sceneLayer->Matrix[ovrEye_Right])
 		};
 
-		error = SubmitSceneLayer(sceneLayer->Viewport, fov, sceneLayer->ColorTexture, sceneLayer->Header.Flags);
+		error = SubmitSceneLayer(session, sceneLayer->Viewport, fov, sceneLayer->ColorTexture, sceneLayer->Header.Flags);
 
 		if (m_MirrorTexture && error == vr::VRCompositorError_None)
 			RenderMirrorTexture(m_MirrorTexture, sceneLayer->ColorTexture);
@@ -139,6 +216,135 @@ vr::EVRCompositorError CompositorBase::SubmitFrame(ovrLayerHeader const * const
 	return error;
 }
 
+CompositorBase::ViewScale CompositorBase::GetViewScale(ovrSession session, const ovrViewScaleDesc* viewScaleDesc)
+{
+	ViewScale scale;
+	scale.WorldToMeters = 1.0f;
+	scale.EyeScale = 1.0f;
+	scale.AppEyeCenter = OVR::Vector3f();
+	scale.EyeCenter = OVR::Vector3f();
+
+	if (!viewScaleDesc)
+		return scale;
+
+	if (viewScaleDesc->HmdSpaceToWorldScaleInMeters > 0.0f)
+		scale.WorldToMeters = viewScaleDesc->HmdSpaceToWorldScaleInMeters;
+
+	// The application may render with other eye offsets than the HMD's, for example to change the stereo
+	// separation. A head-locked quad seen from the application's eyes looks the same as the quad scaled
+	// around the eye center by the ratio of the eye separations, seen from the HMD's eyes.
+	OVR::Vector3f appLeft = viewScaleDesc->HmdToEyeOffset[ovrEye_Left];
+	OVR::Vector3f appRight = viewScaleDesc->HmdToEyeOffset[ovrEye_Right];
+	OVR::Vector3f left = REV::Vector3f(session->Properties->GetEyeToHeadOffset(vr::Eye_Left));
+	OVR::Vector3f right = REV::Vector3f(session->Properties->GetEyeToHeadOffset(vr::Eye_Right));
+
+	float appSeparation = appLeft.Distance(appRight);
+	if (appSeparation > 0.0f)
+	{
+		scale.EyeScale = left.Distance(right) / appSeparation;
+		scale.AppEyeCenter = (appLeft + appRight) * 0.5f;
+		scale.EyeCenter = (left + right) * 0.5f;
+	}
+
+	return scale;
+}
+
+ovrPosef CompositorBase::ScaleQuadPose(const ViewScale& scale, const ovrPosef& pose, bool headLocked)
+{
+	// Quad positions are given in application units, OpenVR expects them in meters.
+	// The world scale applies to world-locked and head-locked quads alike.
+	OVR::Vector3f position = OVR::Vector3f(pose.Position) * scale.WorldToMeters;
+
+	// The eye offsets only apply to head-locked quads. For a world-locked quad the correction would have to be
+	// centered on the current head pose, so it would move with the head and the quad would no longer stay in place.
+	if (headLocked)
+		position = OVR::Vector3f(scale.EyeCenter) + (position - OVR::Vector3f(scale.AppEyeCenter)) * scale.EyeScale;
+
+	ovrPosef result = pose;
+	result.Position = position;
+	return result;
+}
+
+CompositorBase::OverlaySlot* CompositorBase::AcquireOverlay(ovrTextureSwapChain swapChain)
+{
+	if (!swapChain)
+		return nullptr;
+
+	OverlaySlot* unused = nullptr;
+	OverlaySlot* oldest = nullptr;
+
+	for (OverlaySlot& slot : m_Overlays)
+	{
+		// Skip overlays that are already claimed by a layer in this frame.
+		if (slot.Generation == m_Generation)
+			continue;
+
+		// The n-th layer using a swapchain in a frame gets the n-th overlay of that swapchain,
+		// so the same swapchain can be used by multiple layers without them trading places.
+		if (slot.Chain == swapChain)
+		{
+			slot.Generation = m_Generation;
+			return &slot;
+		}
+
+		// Remember a slot to take over if the swapchain has no more overlays, preferring slots
+		// that are not assigned to any swapchain over those that have been hidden the longest.
+		// A slot that was visible in the previous frame is only taken if there is nothing else,
+		// its swapchain is likely to claim it further down the layer list.
+		// Ages are counted back from the current generation, so they stay ordered when it wraps.
+		if (!slot.Chain)
+		{
+			if (!unused || (unused->Handle == vr::k_ulOverlayHandleInvalid && slot.Handle != vr::k_ulOverlayHandleInvalid))
+				unused = &slot;
+		}
+		else if (!oldest || (oldest->Visible && !slot.Visible) ||
+			(oldest->Visible == slot.Visible && m_Generation - slot.Generation > m_Generation - oldest->Generation))
+		{
+			oldest = &slot;
+		}
+	}
+
+	OverlaySlot* slot = unused ? unused : oldest;
+	if (!slot)
+		return nullptr;
+
+	// Reuse the overlay handle of the slot if it already has one, it was hidden in a previous frame.
+	// The cached parameters belong to the handle, so they stay valid when it is reused.
+	if (slot->Handle == vr::k_ulOverlayHandleInvalid)
+	{
+		slot->Handle = CreateOverlay();
+		slot->Cached = false;
+	}
+	slot->Chain = swapChain;
+	slot->Generation = m_Generation;
+	return slot;
+}
+
+void CompositorBase::ReleaseOverlays(ovrTextureSwapChain swapChain)
+{
+	// Detach the overlays from the swapchain, their handles are kept for other swapchains.
+	for (OverlaySlot& slot : m_Overlays)
+	{
+		if (slot.Chain != swapChain)
+			continue;
+
+		if (slot.Visible)
+			vr::VROverlay()->HideOverlay(slot.Handle);
+		slot.Chain = nullptr;
+		slot.Generation = 0;
+		slot.Visible = false;
+	}
+}
+
+bool CompositorBase::CountOverlayCall(bool changed)
+{
+	if (changed)
+		m_OverlayStats.Issued++;
+	else
+		m_OverlayStats.Suppressed++;
+	return changed;
+}
+
 vr::VROverlayHandle_t CompositorBase::CreateOverlay()
 {
 	// Each overlay needs a unique key, so just count how many overlays we've created until now.
@@ -234,7 +440,7 @@ void CompositorBase::SubmitFovLayer(ovrRecti viewport[ovrEye_Count], ovrFovPort
 	}
 }
 
-vr::VRCompositorError CompositorBase::SubmitSceneLayer(ovrRecti viewport[ovrEye_Count], ovrFovPort fov[ovrEye_Count], ovrTextureSwapChain swapChain[ovrEye_Count], unsigned int flags)
+vr::VRCompositorError CompositorBase::SubmitSceneLayer(ovrSession session, ovrRecti viewport[ovrEye_Count], ovrFovPort fov[ovrEye_Count], ovrTextureSwapChain swapChain[ovrEye_Count], unsigned int flags)
 {
 	MICROPROFILE_SCOPE(SubmitSceneLayer);
 	MICROPROFILE_META_CPU("SwapChain Right", swapChain[ovrEye_Right]->Identifier);
@@ -247,7 +453,7 @@ vr::VRCompositorError CompositorBase::SubmitSceneLayer(ovrRecti viewport[ovrEye_
 		vr::VRTextureBounds_t bounds = ViewportToTextureBounds(viewport[i], swapChain[i], flags);
 
 		// Shrink the bounds to account for the overlapping fov
-		vr::VRTextureBounds_t fovBounds = FovPortToTextureBounds((ovrEyeType)i, fov[i]);
+		vr::VRTextureBounds_t fovBounds = FovPortToTextureBounds(session, (ovrEyeType)i, fov[i]);
 
 		// Combine the fov bounds with the viewport bounds
 		bounds.uMin += fovBounds.uMin * bounds.uMax;
@@ -268,13 +474,16 @@ void CompositorBase::SetMirrorTexture(ovrMirrorTexture mirrorTexture)
 	m_MirrorTexture = mirrorTexture;
 }
 
-vr::VRTextureBounds_t CompositorBase::FovPortToTextureBounds(ovrEyeType eye, ovrFovPort fov)
+vr::VRTextureBounds_t CompositorBase::FovPortToTextureBounds(ovrSession session, ovrEyeType eye, ovrFovPort fov)
 {
 	vr::VRTextureBounds_t result;
 
 	// Get the headset field-of-view
 	float left, right, top, bottom;
-	vr::VRSystem()->GetProjectionRaw((vr::EVREye)eye, &left, &right, &top, &bottom);
+	if (session)
+		session->Properties->GetProjectionRaw((vr::EVREye)eye, &left, &right, &top, &bottom);
+	else
+		vr::VRSystem()->GetProjectionRaw((vr::EVREye)eye, &left, &right, &top, &bottom);
 
 	// Adjust the bounds based on the field-of-view in the game
 	result.uMin = 0.5f + 0.5f * left / fov.LeftTan;
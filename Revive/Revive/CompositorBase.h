@@ -6,6 +6,9 @@
 
 #include <vector>
 
+// Overlays are kept in a fixed table, twice the layer limit so recently hidden overlays can be reused.
+#define REV_OVERLAY_COUNT (ovrMaxLayerCount * 2)
+
 class CompositorBase
 {
 public:
@@ -24,8 +27,17 @@ public:
 	virtual void RenderMirrorTexture(ovrMirrorTexture mirrorTexture, ovrTextureSwapChain swapChain[ovrEye_Count]) = 0;
 
 	void SetMirrorTexture(ovrMirrorTexture mirrorTexture);
-	vr::EVRCompositorError SubmitFrame(ovrLayerHeader const * const * layerPtrList, unsigned int layerCount);
-	static vr::VRTextureBounds_t FovPortToTextureBounds(ovrEyeType eye, ovrFovPort fov);
+	void ReleaseOverlays(ovrTextureSwapChain swapChain);
+
+	// Number of OpenVR overlay calls made and skipped because the parameters didn't change, for the last frame.
+	struct OverlayStats
+	{
+		unsigned int Issued;
+		unsigned int Suppressed;
+	};
+	OverlayStats GetOverlayStats() { return m_OverlayStats; }
+	vr::EVRCompositorError SubmitFrame(ovrSession session, const ovrViewScaleDesc* viewScaleDesc, ovrLayerHeader const * const * layerPtrList, unsigned int layerCount);
+	static vr::VRTextureBounds_t FovPortToTextureBounds(ovrSession session, ovrEyeType eye, ovrFovPort fov);
 
 protected:
 	unsigned int m_ChainCount;
@@ -37,10 +49,44 @@ protected:
 	ovrFovPort MatrixToFovPort(ovrMatrix4f matrix);
 
 	void SubmitFovLayer(ovrRecti viewport[ovrEye_Count], ovrFovPort fov[ovrEye_Count], ovrTextureSwapChain swapChain[ovrEye_Count], unsigned int flags);
-	vr::VRCompositorError SubmitSceneLayer(ovrRecti viewport[ovrEye_Count], ovrFovPort fov[ovrEye_Count], ovrTextureSwapChain swapChain[ovrEye_Count], unsigned int flags);
+	vr::VRCompositorError SubmitSceneLayer(ovrSession session, ovrRecti viewport[ovrEye_Count], ovrFovPort fov[ovrEye_Count], ovrTextureSwapChain swapChain[ovrEye_Count], unsigned int flags);
 
 private:
+	// World scale and eye offsets of the frame, computed once per frame and applied to every quad layer.
+	struct ViewScale
+	{
+		float WorldToMeters;
+		float EyeScale;
+		ovrVector3f AppEyeCenter;
+		ovrVector3f EyeCenter;
+	};
+
+	static ViewScale GetViewScale(ovrSession session, const ovrViewScaleDesc* viewScaleDesc);
+	static ovrPosef ScaleQuadPose(const ViewScale& scale, const ovrPosef& pose, bool headLocked);
+
 	// Overlays
+	struct OverlaySlot
+	{
+		ovrTextureSwapChain Chain;
+		vr::VROverlayHandle_t Handle;
+		unsigned int Generation;
+		bool Visible;
+
+		// Parameters last sent to the overlay, only valid if Cached is set.
+		bool Cached;
+		uint32_t SortOrder;
+		float Width;
+		bool HeadLocked;
+		vr::ETrackingUniverseOrigin Space;
+		vr::HmdMatrix34_t Transform;
+		vr::VRTextureBounds_t Bounds;
+	};
+
 	unsigned int m_OverlayCount;
-	std::vector<vr::VROverlayHandle_t> m_ActiveOverlays;
+	unsigned int m_Generation;
+	OverlaySlot m_Overlays[REV_OVERLAY_COUNT];
+	OverlayStats m_OverlayStats;
+
+	OverlaySlot* AcquireOverlay(ovrTextureSwapChain swapChain);
+	bool CountOverlayCall(bool changed);
 };
@@ -0,0 +1,56 @@
+#include "EventPump.h"
+#include "microprofile.h"
+
+#include <algorithm>
+
+MICROPROFILE_DEFINE(PumpEvents, "Session", "PumpEvents", 0xff0000);
+
+#define REV_MAX_EVENTS_PER_FRAME 64
+
+EventPump::EventPump()
+	: m_Subscribers()
+	, m_ShouldQuit(false)
+{
+}
+
+EventPump::~EventPump()
+{
+}
+
+void EventPump::Subscribe(Subscriber* subscriber)
+{
+	m_Subscribers.push_back(subscriber);
+}
+
+void EventPump::Unsubscribe(Subscriber* subscriber)
+{
+	m_Subscribers.erase(std::remove(m_Subscribers.begin(), m_Subscribers.end(), subscriber), m_Subscribers.end());
+}
+
+void EventPump::Pump()
+{
+	MICROPROFILE_SCOPE(PumpEvents);
+
+	// Any events left in the queue will be handled on the next frame.
+	vr::VREvent_t ev;
+	for (int i = 0; i < REV_MAX_EVENTS_PER_FRAME; i++)
+	{
+		if (!vr::VRSystem()->PollNextEvent(&ev, sizeof(vr::VREvent_t)))
+			break;
+
+		Dispatch(ev);
+	}
+}
+
+void EventPump::Dispatch(const vr::VREvent_t& ev)
+{
+	// The quit request is answered here, because it's the session status that reports it to the application.
+	if (ev.eventType == vr::VREvent_Quit && !m_ShouldQuit)
+	{
+		m_ShouldQuit = true;
+		vr::VRSystem()->AcknowledgeQuit_Exiting();
+	}
+
+	for (Subscriber* subscriber : m_Subscribers)
+		subscriber->HandleEvent(ev);
+}
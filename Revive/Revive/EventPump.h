@@ -0,0 +1,36 @@
+#pragma once
+
+#include <openvr.h>
+#include <vector>
+
+// Polls the OpenVR event queue once per frame and hands every event to the subscribers,
+// so they can keep their cached state up to date instead of querying OpenVR on every call.
+class EventPump
+{
+public:
+	class Subscriber
+	{
+	public:
+		virtual ~Subscriber() { }
+
+		virtual void HandleEvent(const vr::VREvent_t& ev) = 0;
+	};
+
+	EventPump();
+	~EventPump();
+
+	void Subscribe(Subscriber* subscriber);
+	void Unsubscribe(Subscriber* subscriber);
+
+	// Drains the event queue, but no more than a frame's worth of events so a flood can't stall the frame.
+	void Pump();
+
+	// Passes a single event to the subscribers, Pump() uses this for every event it receives.
+	void Dispatch(const vr::VREvent_t& ev);
+
+	bool ShouldQuit() { return m_ShouldQuit; }
+
+private:
+	std::vector<Subscriber*> m_Subscribers;
+	bool m_ShouldQuit;
+};
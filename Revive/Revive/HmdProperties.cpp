@@ -0,0 +1,136 @@
+#include "HmdProperties.h"
+#include "microprofile.h"
+
+MICROPROFILE_DEFINE(RefreshHmdProperties, "Session", "RefreshHmdProperties", 0xff0000);
+
+std::mutex HmdProperties::s_Mutex;
+unsigned int HmdProperties::s_Instances = 0;
+float HmdProperties::s_DisplayFrequency = 0.0f;
+
+HmdProperties::HmdProperties()
+	: m_Valid(false)
+	, m_Connected(vr::VRSystem()->IsTrackedDeviceConnected(vr::k_unTrackedDeviceIndex_Hmd))
+	, m_Mutex()
+	, m_Values()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_Mutex);
+		s_Instances++;
+	}
+
+	m_Valid = true;
+	Refresh();
+}
+
+HmdProperties::~HmdProperties()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	if (--s_Instances == 0)
+		s_DisplayFrequency = 0.0f;
+}
+
+float HmdProperties::GetLastDisplayFrequency()
+{
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	return s_DisplayFrequency;
+}
+
+void HmdProperties::Refresh()
+{
+	MICROPROFILE_SCOPE(RefreshHmdProperties);
+
+	// Query outside of the lock, so readers keep getting the previous values during the round-trips.
+	Values values;
+	for (int i = 0; i < 2; i++)
+	{
+		float* projection = values.Projection[i];
+		vr::VRSystem()->GetProjectionRaw((vr::EVREye)i, &projection[0], &projection[1], &projection[2], &projection[3]);
+
+		vr::HmdMatrix34_t eyeToHead = vr::VRSystem()->GetEyeToHeadTransform((vr::EVREye)i);
+		for (int j = 0; j < 3; j++)
+			values.EyeToHeadOffset[i].v[j] = eyeToHead.m[j][3];
+	}
+
+	values.DisplayFrequency = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+	values.VsyncToPhotons = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_SecondsFromVsyncToPhotons_Float);
+	values.UserIpd = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_UserIpdMeters_Float);
+	values.HeadToEyeDepth = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_UserHeadToEyeDepthMeters_Float);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Values = values;
+	}
+
+	std::lock_guard<std::mutex> lock(s_Mutex);
+	s_DisplayFrequency = values.DisplayFrequency;
+}
+
+void HmdProperties::HandleEvent(const vr::VREvent_t& ev)
+{
+	switch (ev.eventType)
+	{
+	case vr::VREvent_TrackedDeviceActivated:
+	case vr::VREvent_TrackedDeviceDeactivated:
+		if (ev.trackedDeviceIndex == vr::k_unTrackedDeviceIndex_Hmd)
+		{
+			m_Connected = ev.eventType == vr::VREvent_TrackedDeviceActivated;
+			m_Valid = false;
+		}
+		break;
+	case vr::VREvent_TrackedDeviceUpdated:
+	case vr::VREvent_PropertyChanged:
+		// Only the HMD properties are cached, refresh them the next time they are used.
+		if (ev.trackedDeviceIndex == vr::k_unTrackedDeviceIndex_Hmd)
+			m_Valid = false;
+		break;
+	case vr::VREvent_IpdChanged:
+		m_Valid = false;
+		break;
+	}
+}
+
+HmdProperties::Values HmdProperties::Get()
+{
+	// Only the thread that claims the invalidated cache refreshes it, an event that arrives
+	// during the refresh invalidates it again so the change is picked up on the next call.
+	if (!m_Valid.exchange(true))
+		Refresh();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Values;
+}
+
+void HmdProperties::GetProjectionRaw(vr::EVREye eye, float* pfLeft, float* pfRight, float* pfTop, float* pfBottom)
+{
+	Values values = Get();
+
+	*pfLeft = values.Projection[eye][0];
+	*pfRight = values.Projection[eye][1];
+	*pfTop = values.Projection[eye][2];
+	*pfBottom = values.Projection[eye][3];
+}
+
+float HmdProperties::GetDisplayFrequency()
+{
+	return Get().DisplayFrequency;
+}
+
+float HmdProperties::GetVsyncToPhotons()
+{
+	return Get().VsyncToPhotons;
+}
+
+float HmdProperties::GetUserIpd()
+{
+	return Get().UserIpd;
+}
+
+float HmdProperties::GetHeadToEyeDepth()
+{
+	return Get().HeadToEyeDepth;
+}
+
+vr::HmdVector3_t HmdProperties::GetEyeToHeadOffset(vr::EVREye eye)
+{
+	return Get().EyeToHeadOffset[eye];
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "EventPump.h"
+
+#include <openvr.h>
+#include <atomic>
+#include <mutex>
+
+// Caches the HMD properties that are read every frame, each OpenVR property query is a round-trip to vrserver.
+// The cache is filled when the session is created and refreshed after the event pump reports that the HMD changed.
+// The getters may be called from any thread, they always read a complete set of properties.
+class HmdProperties : public EventPump::Subscriber
+{
+public:
+	HmdProperties();
+	virtual ~HmdProperties();
+
+	void Refresh();
+	virtual void HandleEvent(const vr::VREvent_t& ev);
+
+	void GetProjectionRaw(vr::EVREye eye, float* pfLeft, float* pfRight, float* pfTop, float* pfBottom);
+	float GetDisplayFrequency();
+	float GetVsyncToPhotons();
+	float GetUserIpd();
+	float GetHeadToEyeDepth();
+	vr::HmdVector3_t GetEyeToHeadOffset(vr::EVREye eye);
+	bool IsConnected() { return m_Connected; }
+
+	// The display frequency of the most recently refreshed cache, for callers that don't have a session.
+	// Returns zero if there is no session.
+	static float GetLastDisplayFrequency();
+
+private:
+	struct Values
+	{
+		float Projection[2][4];
+		float DisplayFrequency;
+		float VsyncToPhotons;
+		float UserIpd;
+		float HeadToEyeDepth;
+		vr::HmdVector3_t EyeToHeadOffset[2];
+	};
+
+	std::atomic<bool> m_Valid;
+	std::atomic<bool> m_Connected;
+	std::mutex m_Mutex;
+	Values m_Values;
+
+	// Shared by all sessions, the last one to be destroyed clears the display frequency.
+	static std::mutex s_Mutex;
+	static unsigned int s_Instances;
+	static float s_DisplayFrequency;
+
+	Values Get();
+};
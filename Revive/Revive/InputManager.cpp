@@ -13,6 +13,7 @@
 InputManager::InputManager()
 	: m_InputDevices()
 	, m_LastPoses()
+	, m_HandIndices()
 {
 	for (ovrPoseStatef& pose : m_LastPoses)
 		pose.ThePose = OVR::Posef::Identity();
@@ -21,6 +22,8 @@ InputManager::InputManager()
 	m_InputDevices.push_back(new OculusTouch(vr::TrackedControllerRole_LeftHand));
 	m_InputDevices.push_back(new OculusTouch(vr::TrackedControllerRole_RightHand));
 	m_InputDevices.push_back(new OculusRemote());
+
+	UpdateIndices();
 }
 
 InputManager::~InputManager()
@@ -29,6 +32,28 @@ InputManager::~InputManager()
 		delete device;
 }
 
+void InputManager::HandleEvent(const vr::VREvent_t& ev)
+{
+	switch (ev.eventType)
+	{
+	case vr::VREvent_TrackedDeviceActivated:
+	case vr::VREvent_TrackedDeviceDeactivated:
+	case vr::VREvent_TrackedDeviceRoleChanged:
+		// The role event doesn't tell us which hand changed, so look up both of them.
+		UpdateIndices();
+		break;
+	}
+}
+
+void InputManager::UpdateIndices()
+{
+	m_HandIndices[ovrHand_Left] = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand);
+	m_HandIndices[ovrHand_Right] = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
+
+	for (InputDevice* device : m_InputDevices)
+		device->UpdateIndex();
+}
+
 unsigned int InputManager::GetConnectedControllerTypes()
 {
 	uint32_t types = 0;
@@ -176,11 +201,9 @@ void InputManager::GetTrackingState(ovrSession session, ovrTrackingState* outSta
 	outState->StatusFlags = TrackedDevicePoseToOVRStatusFlags(poses[vr::k_unTrackedDeviceIndex_Hmd]);
 
 	// Convert the hand poses
-	vr::TrackedDeviceIndex_t hands[] = { vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand),
-		vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand) };
 	for (int i = 0; i < ovrHand_Count; i++)
 	{
-		vr::TrackedDeviceIndex_t deviceIndex = hands[i];
+		vr::TrackedDeviceIndex_t deviceIndex = m_HandIndices[i];
 		if (deviceIndex == vr::k_unTrackedDeviceIndexInvalid)
 		{
 			outState->HandPoses[i].ThePose = OVR::Posef::Identity();
@@ -235,10 +258,10 @@ ovrResult InputManager::GetDevicePoses(ovrTrackedDeviceType* deviceTypes, int de
 			index = vr::k_unTrackedDeviceIndex_Hmd;
 			break;
 		case ovrTrackedDevice_LTouch:
-			index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand);
+			index = m_HandIndices[ovrHand_Left];
 			break;
 		case ovrTrackedDevice_RTouch:
-			index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
+			index = m_HandIndices[ovrHand_Right];
 			break;
 		case ovrTrackedDevice_Object0:
 			index = trackers[0];
@@ -272,7 +295,7 @@ void InputManager::OculusTouch::HapticsThread(OculusTouch* device)
 
 	while (device->m_bHapticsRunning)
 	{
-		vr::TrackedDeviceIndex_t touch = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(device->GetRole());
+		vr::TrackedDeviceIndex_t touch = device->m_Index;
 
 		uint16_t duration = (uint16_t)((float)freq.count() * device->m_Haptics.GetSample());
 		if (duration > 0)
@@ -324,6 +347,7 @@ bool InputManager::OculusTouch::IsReleased(vr::VRControllerState_t newState, vr:
 
 InputManager::OculusTouch::OculusTouch(vr::ETrackedControllerRole role)
 	: m_Role(role)
+	, m_Index(vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(role))
 	, m_StickTouched(false)
 	, m_Gripped(false)
 	, m_GrippedTime(0.0)
@@ -341,6 +365,11 @@ InputManager::OculusTouch::~OculusTouch()
 	m_HapticsThread.join();
 }
 
+void InputManager::OculusTouch::UpdateIndex()
+{
+	m_Index = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(m_Role);
+}
+
 ovrControllerType InputManager::OculusTouch::GetType()
 {
 	return m_Role == vr::TrackedControllerRole_LeftHand ? ovrControllerType_LTouch : ovrControllerType_RTouch;
@@ -349,14 +378,13 @@ ovrControllerType InputManager::OculusTouch::GetType()
 bool InputManager::OculusTouch::IsConnected()
 {
 	// Check if the Vive controller is assigned
-	vr::TrackedDeviceIndex_t touch = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(m_Role);
-	return touch != vr::k_unTrackedDeviceIndexInvalid;
+	return m_Index != vr::k_unTrackedDeviceIndexInvalid;
 }
 
 bool InputManager::OculusTouch::GetInputState(ovrSession session, ovrInputState* inputState)
 {
 	// Get controller index
-	vr::TrackedDeviceIndex_t touch = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(m_Role);
+	vr::TrackedDeviceIndex_t touch = m_Index;
 	ovrHandType hand = (m_Role == vr::TrackedControllerRole_LeftHand) ? ovrHand_Left : ovrHand_Right;
 
 	if (touch == vr::k_unTrackedDeviceIndexInvalid)
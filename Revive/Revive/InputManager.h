@@ -1,15 +1,17 @@
 #pragma once
 
+#include "EventPump.h"
 #include "HapticsBuffer.h"
 #include "OVR_CAPI.h"
 
 #include <openvr.h>
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <Windows.h>
 #include <Xinput.h>
 
-class InputManager
+class InputManager : public EventPump::Subscriber
 {
 public:
 	class InputDevice
@@ -19,6 +21,7 @@ public:
 
 		// Input
 		virtual vr::ETrackedControllerRole GetRole() { return vr::TrackedControllerRole_Invalid; }
+		virtual void UpdateIndex() { }
 		virtual ovrControllerType GetType() = 0;
 		virtual bool IsConnected() = 0;
 		virtual bool GetInputState(ovrSession session, ovrInputState* inputState) = 0;
@@ -38,6 +41,7 @@ public:
 		HapticsBuffer m_Haptics;
 
 		virtual vr::ETrackedControllerRole GetRole() { return m_Role; }
+		virtual void UpdateIndex();
 		virtual ovrControllerType GetType();
 		virtual bool IsConnected();
 		virtual bool GetInputState(ovrSession session, ovrInputState* inputState);
@@ -48,6 +52,7 @@ public:
 	private:
 		bool m_bHapticsRunning;
 		vr::ETrackedControllerRole m_Role;
+		std::atomic<vr::TrackedDeviceIndex_t> m_Index;
 		vr::VRControllerState_t m_LastState;
 
 		bool m_StickTouched;
@@ -87,7 +92,10 @@ public:
 	};
 
 	InputManager();
-	~InputManager();
+	virtual ~InputManager();
+
+	virtual void HandleEvent(const vr::VREvent_t& ev);
+	vr::TrackedDeviceIndex_t GetHandIndex(ovrHandType hand) { return m_HandIndices[hand]; }
 
 	unsigned int GetConnectedControllerTypes();
 	ovrTouchHapticsDesc GetTouchHapticsDesc(ovrControllerType controllerType);
@@ -105,6 +113,8 @@ protected:
 
 private:
 	ovrPoseStatef m_LastPoses[vr::k_unMaxTrackedDeviceCount];
+	vr::TrackedDeviceIndex_t m_HandIndices[ovrHand_Count];
+	void UpdateIndices();
 	unsigned int TrackedDevicePoseToOVRStatusFlags(vr::TrackedDevicePose_t pose);
 	ovrPoseStatef TrackedDevicePoseToOVRPose(vr::TrackedDevicePose_t pose, ovrPoseStatef& lastPose, double time);
 };
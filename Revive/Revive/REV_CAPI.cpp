@@ -6,6 +6,8 @@
 #include "Session.h"
 #include "Error.h"
 #include "CompositorBase.h"
+#include "EventPump.h"
+#include "HmdProperties.h"
 #include "SessionDetails.h"
 #include "InputManager.h"
 #include "Settings.h"
@@ -239,21 +241,6 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessi
 	if (!sessionStatus)
 		return ovrError_InvalidParameter;
 
-	// Check for quit event
-	// TODO: The SteamVR beta has a tendency to hang here for some unknown reason
-	// re-enable this code when the bug is fixed.
-#if 0
-	vr::VREvent_t ev;
-	while (vr::VRSystem()->PollNextEvent(&ev, sizeof(vr::VREvent_t)))
-	{
-		if (ev.eventType == vr::VREvent_Quit)
-		{
-			session->ShouldQuit = true;
-			vr::VRSystem()->AcknowledgeQuit_Exiting();
-		}
-	}
-#endif
-
 	// Don't use the activity level while debugging, so I don't have to put on the HMD
 	vr::EDeviceActivityLevel activityLevel = vr::k_EDeviceActivityLevel_Unknown;
 	if (!session->IgnoreActivity)
@@ -266,10 +253,10 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetSessionStatus(ovrSession session, ovrSessi
 	session->IsVisible = true;
 
 	// TODO: Detect if the display is lost, can this ever happen with OpenVR?
-	sessionStatus->HmdPresent = vr::VRSystem()->IsTrackedDeviceConnected(vr::k_unTrackedDeviceIndex_Hmd);
+	sessionStatus->HmdPresent = session->Properties->IsConnected();
 	sessionStatus->HmdMounted = (activityLevel == vr::k_EDeviceActivityLevel_UserInteraction || activityLevel == vr::k_EDeviceActivityLevel_Unknown);
 	sessionStatus->DisplayLost = false;
-	sessionStatus->ShouldQuit = session->ShouldQuit;
+	sessionStatus->ShouldQuit = session->Events->ShouldQuit();
 	sessionStatus->ShouldRecenter = false;
 
 	return ovrSuccess;
@@ -525,17 +512,15 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_TestBoundary(ovrSession session, ovrTrackedDe
 	}
 
 
-	vr::TrackedDeviceIndex_t hands[] = { vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_LeftHand),
-		vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand) };
-
 	for (int i = 0; i < ovrHand_Count; i++)
 	{
 		if (deviceBitmask & (ovrTrackedDevice_LTouch << i))
 		{
 			ovrBoundaryTestResult result = { 0 };
-			if (hands[i] != vr::k_unTrackedDeviceIndexInvalid)
+			vr::TrackedDeviceIndex_t hand = session->Input->GetHandIndex((ovrHandType)i);
+			if (hand != vr::k_unTrackedDeviceIndexInvalid)
 			{
-				REV::Matrix4f matrix = (REV::Matrix4f)poses[hands[i]].mDeviceToAbsoluteTracking;
+				REV::Matrix4f matrix = (REV::Matrix4f)poses[hand].mDeviceToAbsoluteTracking;
 				ovrVector3f point = matrix.GetTranslation();
 
 				ovrResult err = ovr_TestBoundaryPoint(session, &point, boundaryType, &result);
@@ -713,7 +698,8 @@ OVR_PUBLIC_FUNCTION(void) ovr_DestroyTextureSwapChain(ovrSession session, ovrTex
 		return;
 
 	MICROPROFILE_META_CPU("Identifier", chain->Identifier);
-	vr::VROverlay()->DestroyOverlay(chain->Overlay);
+	if (session && session->Compositor)
+		session->Compositor->ReleaseOverlays(chain);
 	delete chain;
 }
 
@@ -740,7 +726,7 @@ OVR_PUBLIC_FUNCTION(ovrSizei) ovr_GetFovTextureSize(ovrSession session, ovrEyeTy
 		pixelsPerDisplayPixel = session->PixelsPerDisplayPixel;
 
 	// Grow the recommended size to account for the overlapping fov
-	vr::VRTextureBounds_t bounds = CompositorBase::FovPortToTextureBounds(eye, fov);
+	vr::VRTextureBounds_t bounds = CompositorBase::FovPortToTextureBounds(session, eye, fov);
 	size.w = int((size.w * pixelsPerDisplayPixel) / (bounds.uMax - bounds.uMin));
 	size.h = int((size.h * pixelsPerDisplayPixel) / (bounds.vMax - bounds.vMin));
 
@@ -775,8 +761,6 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 
 	MICROPROFILE_META_CPU("Submit Frame", (int)frameIndex);
 
-	// TODO: Implement scaling through ApplyTransform().
-
 	if (!session || !session->Compositor)
 		return ovrError_InvalidSession;
 
@@ -784,7 +768,7 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 		return ovrError_InvalidParameter;
 
 	// Use our own intermediate compositor to convert the frame to OpenVR.
-	vr::EVRCompositorError err = session->Compositor->SubmitFrame(layerPtrList, layerCount);
+	vr::EVRCompositorError err = session->Compositor->SubmitFrame(session, viewScaleDesc, layerPtrList, layerCount);
 
 	// Flip the profiler.
 	MicroProfileFlip();
@@ -792,6 +776,9 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_SubmitFrame(ovrSession session, long long fra
 	// The frame has been submitted, so we can now safely refresh some settings from the settings interface.
 	session->LoadSettings();
 
+	// Handle the events that arrived during this frame, this keeps the cached device state up to date.
+	session->Events->Pump();
+
 	// Call WaitGetPoses to block until the running start, also known as queue-ahead in the Oculus SDK.
 	if (!session->Details->UseHack(SessionDetails::HACK_WAIT_IN_TRACKING_STATE))
 		vr::VRCompositor()->WaitGetPoses(nullptr, 0, nullptr, 0);
@@ -845,8 +832,8 @@ OVR_PUBLIC_FUNCTION(ovrResult) ovr_GetPerfStats(ovrSession session, ovrPerfStats
 	int FrameStatsCount = AnyFrameStatsDropped ? ovrMaxProvidedFrameStats : int(session->FrameIndex - session->StatsIndex);
 	session->StatsIndex = session->FrameIndex;
 
-	float fVsyncToPhotons = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_SecondsFromVsyncToPhotons_Float);
-	float fDisplayFrequency = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+	float fVsyncToPhotons = session->Properties->GetVsyncToPhotons();
+	float fDisplayFrequency = session->Properties->GetDisplayFrequency();
 	float fFrameDuration = 1.0f / fDisplayFrequency;
 	for (int i = 0; i < FrameStatsCount; i++)
 	{
@@ -927,8 +914,8 @@ OVR_PUBLIC_FUNCTION(double) ovr_GetPredictedDisplayTime(ovrSession session, long
 	if (!session)
 		return ovrError_InvalidSession;
 
-	float fDisplayFrequency = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
-	float fVsyncToPhotons = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_SecondsFromVsyncToPhotons_Float);
+	float fDisplayFrequency = session->Properties->GetDisplayFrequency();
+	float fVsyncToPhotons = session->Properties->GetVsyncToPhotons();
 
 	// Get the frame count and advance it based on which frame we're predicting
 	float fSecondsSinceLastVsync;
@@ -952,7 +939,10 @@ OVR_PUBLIC_FUNCTION(double) ovr_GetTimeInSeconds()
 {
 	REV_TRACE(ovr_GetTimeInSeconds);
 
-	float fDisplayFrequency = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
+	// This is called from the input polling, so use the cached display frequency of the session if there is one
+	float fDisplayFrequency = HmdProperties::GetLastDisplayFrequency();
+	if (fDisplayFrequency <= 0.0f)
+		fDisplayFrequency = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_DisplayFrequency_Float);
 
 	// Get the frame count and the time since the last VSync
 	float fSecondsSinceLastVsync;
@@ -1009,7 +999,11 @@ OVR_PUBLIC_FUNCTION(float) ovr_GetFloat(ovrSession session, const char* property
 	REV_TRACE(ovr_GetFloat);
 
 	if (strcmp(propertyName, "IPD") == 0)
+	{
+		if (session)
+			return session->Properties->GetUserIpd();
 		return vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_UserIpdMeters_Float);
+	}
 
 	// Override defaults, we should always return a valid value for these
 	if (strcmp(propertyName, OVR_KEY_PLAYER_HEIGHT) == 0)
@@ -1042,7 +1036,10 @@ OVR_PUBLIC_FUNCTION(unsigned int) ovr_GetFloatArray(ovrSession session, const ch
 			return 0;
 
 		// We only know the horizontal depth
-		values[0] = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_UserHeadToEyeDepthMeters_Float);
+		if (session)
+			values[0] = session->Properties->GetHeadToEyeDepth();
+		else
+			values[0] = vr::VRSystem()->GetFloatTrackedDeviceProperty(vr::k_unTrackedDeviceIndex_Hmd, vr::Prop_UserHeadToEyeDepthMeters_Float);
 		values[1] = OVR_DEFAULT_NECK_TO_EYE_VERTICAL;
 		return 2;
 	}
@@ -1,25 +1,32 @@
 #include "Session.h"
 #include "REV_Math.h"
 #include "CompositorBase.h"
+#include "EventPump.h"
+#include "HmdProperties.h"
 #include "SessionDetails.h"
 #include "InputManager.h"
 #include "Settings.h"
 
 ovrHmdStruct::ovrHmdStruct()
-	: ShouldQuit(false)
-	, IsVisible(false)
+	: IsVisible(false)
 	, FrameIndex(0)
 	, StatsIndex(0)
 	, NextLoadTime(0.0)
 	, Compositor(nullptr)
 	, Input(new InputManager())
 	, Details(new SessionDetails())
+	, Properties(new HmdProperties())
+	, Events(new EventPump())
 {
 	memset(StringBuffer, 0, sizeof(StringBuffer));
 	memset(&ResetStats, 0, sizeof(ResetStats));
 	memset(Stats, 0, sizeof(Stats));
 	memset(TouchOffset, 0, sizeof(TouchOffset));
 
+	// Keep the cached device state up to date
+	Events->Subscribe(Properties.get());
+	Events->Subscribe(Input.get());
+
 	// Get the render target multiplier
 	PixelsPerDisplayPixel = ovr_GetFloat(this, REV_KEY_PIXELS_PER_DISPLAY, REV_DEFAULT_PIXELS_PER_DISPLAY);
 
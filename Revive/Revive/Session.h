@@ -7,13 +7,14 @@
 // Forward declarations
 enum revGripType;
 class CompositorBase;
+class EventPump;
+class HmdProperties;
 class InputManager;
 class SessionDetails;
 
 struct ovrHmdStruct
 {
 	// Session status
-	bool ShouldQuit;
 	bool IsVisible;
 	char StringBuffer[vr::k_unMaxPropertyStringSize];
 
@@ -27,6 +28,8 @@ struct ovrHmdStruct
 	std::unique_ptr<CompositorBase> Compositor;
 	std::unique_ptr<InputManager> Input;
 	std::unique_ptr<SessionDetails> Details;
+	std::unique_ptr<HmdProperties> Properties;
+	std::unique_ptr<EventPump> Events;
 
 	// Revive settings
 	double NextLoadTime;
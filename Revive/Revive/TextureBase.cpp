@@ -6,7 +6,6 @@ ovrTextureSwapChainData::ovrTextureSwapChainData(vr::ETextureType api, ovrTextur
 	, Identifier(0)
 	, CurrentIndex(0)
 	, Desc(desc)
-	, Overlay(vr::k_ulOverlayHandleInvalid)
 {
 	memset(Textures, 0, sizeof(Textures));
 }
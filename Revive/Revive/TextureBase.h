@@ -22,7 +22,6 @@ struct ovrTextureSwapChainData
 {
 	ovrTextureSwapChainDesc Desc;
 	vr::ETextureType ApiType;
-	vr::VROverlayHandle_t Overlay;
 
 	unsigned int Identifier;
 	int Length, CurrentIndex;
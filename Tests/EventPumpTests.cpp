@@ -0,0 +1,105 @@
+#include "Test.h"
+#include "MockOpenVR.h"
+#include "EventPump.h"
+
+#include <vector>
+
+// Synthetic event streams are queued on the mock IVRSystem and pumped to subscribers.
+
+class RecordingSubscriber : public EventPump::Subscriber
+{
+public:
+	std::vector<uint32_t> Events;
+
+	virtual void HandleEvent(const vr::VREvent_t& ev) { Events.push_back(ev.eventType); }
+};
+
+static void QueueEvent(uint32_t eventType, uint32_t trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd)
+{
+	vr::VREvent_t ev = {};
+	ev.eventType = eventType;
+	ev.trackedDeviceIndex = trackedDeviceIndex;
+	g_MockVRSystem.Events.push_back(ev);
+}
+
+TEST(EventPumpDispatchesInOrder)
+{
+	g_MockVRSystem.Reset();
+	EventPump pump;
+	RecordingSubscriber first, second;
+	pump.Subscribe(&first);
+	pump.Subscribe(&second);
+
+	QueueEvent(vr::VREvent_TrackedDeviceActivated);
+	QueueEvent(vr::VREvent_IpdChanged);
+	QueueEvent(vr::VREvent_PropertyChanged);
+	pump.Pump();
+
+	uint32_t expected[] = { vr::VREvent_TrackedDeviceActivated, vr::VREvent_IpdChanged, vr::VREvent_PropertyChanged };
+	REQUIRE(first.Events.size() == 3);
+	REQUIRE(second.Events.size() == 3);
+	for (int i = 0; i < 3; i++)
+	{
+		CHECK(first.Events[i] == expected[i]);
+		CHECK(second.Events[i] == expected[i]);
+	}
+
+	// The queue was drained, the last poll found it empty.
+	CHECK(g_MockVRSystem.Polls == 4);
+	CHECK(!pump.ShouldQuit());
+}
+
+TEST(EventPumpCapsEventsPerFrame)
+{
+	g_MockVRSystem.Reset();
+	EventPump pump;
+	RecordingSubscriber subscriber;
+	pump.Subscribe(&subscriber);
+
+	for (int i = 0; i < 100; i++)
+		QueueEvent(vr::VREvent_PropertyChanged);
+
+	// A flood is spread over frames, the rest stays queued for the next one.
+	pump.Pump();
+	CHECK(subscriber.Events.size() == 64);
+	CHECK(g_MockVRSystem.Events.size() == 36);
+	CHECK(g_MockVRSystem.Polls == 64);
+
+	pump.Pump();
+	CHECK(subscriber.Events.size() == 100);
+	CHECK(g_MockVRSystem.Events.empty());
+}
+
+TEST(EventPumpAcknowledgesQuitOnce)
+{
+	g_MockVRSystem.Reset();
+	EventPump pump;
+	RecordingSubscriber subscriber;
+	pump.Subscribe(&subscriber);
+
+	QueueEvent(vr::VREvent_Quit);
+	QueueEvent(vr::VREvent_Quit);
+	pump.Pump();
+
+	CHECK(pump.ShouldQuit());
+	CHECK(g_MockVRSystem.QuitAcknowledged == 1);
+
+	// Subscribers still see every quit event.
+	CHECK(subscriber.Events.size() == 2);
+}
+
+TEST(EventPumpUnsubscribedGetsNothing)
+{
+	g_MockVRSystem.Reset();
+	EventPump pump;
+	RecordingSubscriber kept, removed;
+	pump.Subscribe(&kept);
+	pump.Subscribe(&removed);
+	pump.Unsubscribe(&removed);
+
+	QueueEvent(vr::VREvent_IpdChanged);
+	pump.Pump();
+
+	CHECK(kept.Events.size() == 1);
+	CHECK(removed.Events.empty());
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+#include "../LibOVRWrapper0.5/FrameTiming.h"
+
+#include <string.h>
+
+// The estimator only works on the times it is handed, so a simulated 90Hz display is driven here:
+// vsyncs (scanout midpoints) at start + n * interval, and a frame loop that begins, renders and submits.
+
+static const double Refresh = 90.0;
+static const double Interval = 1.0 / Refresh;
+static const double Start = 100.0;
+
+static double Vsync(int n)
+{
+	return Start + n * Interval;
+}
+
+// Runs frames that start right after a vsync and take renderSeconds until the submit.
+static void RunFrames(FrameTimingEstimator* e, int first, int count, double renderSeconds)
+{
+	for (int n = first; n < first + count; n++)
+	{
+		double begin = Vsync(n) + 0.001;
+		frameTimingBeginFrame(e, begin);
+		frameTimingObserveDisplay(e, Vsync(n + 1));
+
+		FrameTimingEstimate estimate;
+		frameTimingEstimate(e, begin, Vsync(n + 1), &estimate);
+		frameTimingExpectScanout(e, estimate.nextFrameSeconds);
+
+		frameTimingObserveSubmit(e, begin + renderSeconds);
+	}
+}
+
+static void CheckOrdering(const FrameTimingEstimate& estimate)
+{
+	CHECK(estimate.thisFrameSeconds < estimate.timewarpPointSeconds);
+	CHECK(estimate.timewarpPointSeconds < estimate.nextFrameSeconds);
+	CHECK(estimate.nextFrameSeconds < estimate.eyeScanoutSeconds[0]);
+	CHECK(estimate.eyeScanoutSeconds[0] <= estimate.scanoutMidpointSeconds);
+	CHECK(estimate.scanoutMidpointSeconds <= estimate.eyeScanoutSeconds[1]);
+}
+
+TEST(FrameTimingWithoutFrames)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+
+	FrameTimingEstimate estimate;
+	frameTimingEstimate(&e, Start, 0.0, &estimate);
+
+	CHECK(estimate.thisFrameSeconds == Start);
+	CHECK_NEAR(estimate.deltaSeconds, Interval, 1e-9);
+	CheckOrdering(estimate);
+}
+
+TEST(FrameTimingLocksOntoVsync)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+	RunFrames(&e, 0, 100, 0.004);
+
+	double begin = Vsync(100) + 0.001;
+	frameTimingBeginFrame(&e, begin);
+	frameTimingObserveDisplay(&e, Vsync(101));
+
+	FrameTimingEstimate estimate;
+	frameTimingEstimate(&e, begin, Vsync(101), &estimate);
+
+	CHECK_NEAR(e.interval, Interval, 1e-6);
+	CHECK_NEAR(estimate.scanoutMidpointSeconds, Vsync(101), 1e-6);
+	CHECK_NEAR(estimate.nextFrameSeconds, Vsync(101) - Interval * 0.5, 1e-6);
+	CHECK_NEAR(estimate.deltaSeconds, Interval, 1e-6);
+	CHECK(e.missedFrames == 0);
+	CheckOrdering(estimate);
+}
+
+TEST(FrameTimingEstimateIsPure)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+	RunFrames(&e, 0, 10, 0.004);
+
+	FrameTimingEstimator before = e;
+	FrameTimingEstimate estimate;
+	frameTimingEstimate(&e, Vsync(10) + 0.002, Vsync(12) + 0.0005, &estimate);
+
+	CHECK(memcmp(&before, &e, sizeof(e)) == 0);
+}
+
+TEST(FrameTimingClampsFirstRenderSample)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+
+	// The very first frame stalls for two seconds, a loading screen or a breakpoint.
+	frameTimingBeginFrame(&e, Vsync(0));
+	frameTimingObserveDisplay(&e, Vsync(1));
+	frameTimingObserveSubmit(&e, Vsync(0) + 2.0);
+
+	CHECK(e.renderSeconds <= Interval * 3 + 1e-9);
+
+	// The next frame is still timed for one of the next few vsyncs.
+	double begin = Vsync(200) + 0.001;
+	frameTimingBeginFrame(&e, begin);
+	frameTimingObserveDisplay(&e, Vsync(201));
+
+	FrameTimingEstimate estimate;
+	frameTimingEstimate(&e, begin, Vsync(201), &estimate);
+
+	CHECK(estimate.nextFrameSeconds - begin <= Interval * 4 + 1e-9);
+	CheckOrdering(estimate);
+}
+
+TEST(FrameTimingClampsRenderStall)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+	RunFrames(&e, 0, 50, 0.004);
+
+	double before = e.renderSeconds;
+	RunFrames(&e, 50, 1, 5.0);
+
+	// One stalled frame moves the average by at most the gain times the clamped sample.
+	CHECK(e.renderSeconds <= before + 0.1 * (Interval * 3 - before) + 1e-9);
+	CHECK(e.missedFrames == 1);
+}
+
+TEST(FrameTimingScanoutSearchIsBounded)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+	RunFrames(&e, 0, 10, 0.004);
+
+	// Far more vsyncs than a loop could step through, the search has to be a division.
+	e.renderSeconds = 1.0e7;
+
+	double begin = Vsync(10) + 0.001;
+	frameTimingBeginFrame(&e, begin);
+
+	FrameTimingEstimate estimate;
+	frameTimingEstimate(&e, begin, Vsync(11), &estimate);
+
+	double earliest = begin + e.renderSeconds;
+	CHECK(estimate.nextFrameSeconds > earliest);
+	CHECK(estimate.nextFrameSeconds - earliest <= Interval * 1.0001);
+}
+
+TEST(FrameTimingCountsMissedFrames)
+{
+	FrameTimingEstimator e;
+	frameTimingReset(&e, Refresh);
+	RunFrames(&e, 0, 10, 0.004);
+	CHECK(e.missedFrames == 0);
+
+	// Rendering takes longer than the vsync the frame was timed for.
+	RunFrames(&e, 10, 1, Interval * 1.5);
+	CHECK(e.missedFrames == 1);
+
+	frameTimingReset(&e, Refresh);
+	CHECK(e.missedFrames == 0);
+}
@@ -0,0 +1,88 @@
+#include "Test.h"
+#include "../LibOVRWrapper0.5/LatencyEstimator.h"
+
+// Frames of a simulated 90Hz display: the app samples tracking, renders and submits,
+// the frame is shown at the predicted display time or one of the vsyncs after it.
+
+static const double Interval = 1.0 / 90.0;
+static const double Start = 50.0;
+
+TEST(LatencyWithoutFrames)
+{
+	LatencyEstimator e;
+	latencyReset(&e);
+
+	LatencyStats stats;
+	CHECK(!latencyGetStats(&e, &stats));
+}
+
+TEST(LatencyOnTimeFrames)
+{
+	LatencyEstimator e;
+	latencyReset(&e);
+
+	// Tracking sampled 5ms before the frame starts, shown two vsyncs later.
+	for (int n = 0; n < 20; n++)
+	{
+		double vsync = Start + n * Interval;
+		latencyObserveFrame(&e, vsync - 0.005, vsync + 0.008, vsync + 2 * Interval, Interval);
+	}
+
+	LatencyStats stats;
+	REQUIRE(latencyGetStats(&e, &stats));
+	CHECK(stats.frames == 20);
+	CHECK_NEAR(stats.minSeconds, 2 * Interval + 0.005, 1e-9);
+	CHECK_NEAR(stats.meanSeconds, 2 * Interval + 0.005, 1e-9);
+	CHECK_NEAR(stats.p99Seconds, 2 * Interval + 0.005, 1e-9);
+}
+
+TEST(LatencyLateSubmitMovesToNextVsync)
+{
+	LatencyEstimator e;
+	latencyReset(&e);
+
+	// The submit finishes 1.5 intervals after the predicted display time, the frame is shown two vsyncs later.
+	double display = Start + Interval;
+	latencyObserveFrame(&e, Start, display + 1.5 * Interval, display, Interval);
+
+	LatencyStats stats;
+	REQUIRE(latencyGetStats(&e, &stats));
+	CHECK_NEAR(stats.minSeconds, 3 * Interval, 1e-9);
+}
+
+TEST(LatencyIgnoresFramesWithoutTracking)
+{
+	LatencyEstimator e;
+	latencyReset(&e);
+
+	latencyObserveFrame(&e, 0.0, Start, Start + Interval, Interval);
+	latencyObserveFrame(&e, Start + Interval, Start, Start, Interval);
+
+	LatencyStats stats;
+	CHECK(!latencyGetStats(&e, &stats));
+}
+
+TEST(LatencyWindowKeepsLastFrames)
+{
+	LatencyEstimator e;
+	latencyReset(&e);
+
+	// A slow start that falls out of the window, followed by a full window of fast frames.
+	// Two of them are outliers, so the p99 (the 127th of 128 samples) is one of them.
+	for (int n = 0; n < latencyWindowSize; n++)
+		latencyObserveFrame(&e, Start + n * Interval, Start + n * Interval, Start + n * Interval + 0.1, 0.0);
+
+	for (int n = 0; n < latencyWindowSize; n++)
+	{
+		double sample = Start + (latencyWindowSize + n) * Interval;
+		double latency = n == 7 || n == 70 ? 0.05 : 0.02;
+		latencyObserveFrame(&e, sample, sample, sample + latency, 0.0);
+	}
+
+	LatencyStats stats;
+	REQUIRE(latencyGetStats(&e, &stats));
+	CHECK(stats.frames == latencyWindowSize);
+	CHECK_NEAR(stats.minSeconds, 0.02, 1e-9);
+	CHECK_NEAR(stats.meanSeconds, 0.02 + 0.06 / latencyWindowSize, 1e-9);
+	CHECK_NEAR(stats.p99Seconds, 0.05, 1e-9);
+}
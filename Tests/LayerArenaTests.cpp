@@ -0,0 +1,107 @@
+#include "Test.h"
+#include "MockRuntime.h"
+#include "../LibOVR0.8/Include/OVR_CAPI_0_8_0.h"
+
+#include <windows.h>
+#include <crtdbg.h>
+#include <string.h>
+
+// The 0.8 wrapper translates submitted layers into a per-session arena, so ovr_SubmitFrame must not
+// allocate once the session exists. The wrapper is loaded from the configuration's output directory,
+// two levels up from the runner, and talks to the mock runtime next to the runner.
+// Allocations are counted with the debug CRT's allocation hook, which only exists in Debug builds;
+// the wrapper and the runner share the CRT DLL while the mock links its own, so only the wrapper's are seen.
+
+#ifdef _DEBUG
+
+#ifdef _WIN64
+#define WRAPPER_0_8_DLL "LibOVRRT64_0_8.dll"
+#else
+#define WRAPPER_0_8_DLL "LibOVRRT32_0_8.dll"
+#endif
+
+// More layers than the 16 rev_SubmitFrame takes, the wrapper drops the rest.
+static const unsigned int LayerCount = 18;
+
+static DWORD g_AllocThread = 0;
+static unsigned int g_Allocations = 0;
+
+// Counts allocations of the test thread, the wrapper and the runtime may have threads of their own.
+static int __cdecl CountAllocations(int allocType, void*, size_t, int, long, const unsigned char*, int)
+{
+	if ((allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC) && GetCurrentThreadId() == g_AllocThread)
+		g_Allocations++;
+
+	return TRUE;
+}
+
+static HMODULE LoadWrapper()
+{
+	char path[MAX_PATH];
+	DWORD length = GetModuleFileNameA(NULL, path, MAX_PATH);
+	if (length == 0 || length >= MAX_PATH)
+		return NULL;
+
+	char* name = strrchr(path, '\\');
+	if (name == NULL)
+		return NULL;
+	*(name + 1) = '\0';
+
+	if (strcat_s(path, "..\\..\\" WRAPPER_0_8_DLL) != 0)
+		return NULL;
+
+	return LoadLibraryA(path);
+}
+
+TEST(LayerArenaSubmitDoesNotAllocate)
+{
+	HMODULE wrapper = LoadWrapper();
+	REQUIRE(wrapper);
+
+	auto initialize = (decltype(&ovr_Initialize))GetProcAddress(wrapper, "ovr_Initialize");
+	auto shutdown = (decltype(&ovr_Shutdown))GetProcAddress(wrapper, "ovr_Shutdown");
+	auto create = (decltype(&ovr_Create))GetProcAddress(wrapper, "ovr_Create");
+	auto destroy = (decltype(&ovr_Destroy))GetProcAddress(wrapper, "ovr_Destroy");
+	auto submitFrame = (decltype(&ovr_SubmitFrame))GetProcAddress(wrapper, "ovr_SubmitFrame");
+	REQUIRE(initialize && shutdown && create && destroy && submitFrame);
+
+	SetMockEnvironment(3);
+
+	ovrSession session = nullptr;
+	ovrGraphicsLuid luid;
+	CHECK(OVR_SUCCESS(initialize(nullptr)));
+	CHECK(OVR_SUCCESS(create(&session, &luid)));
+
+	if (session)
+	{
+		// A full list of layers, with a gap the wrapper has to skip.
+		ovrLayerHeader disabled[LayerCount];
+		const ovrLayerHeader* layers[LayerCount];
+		for (unsigned int i = 0; i < LayerCount; i++)
+		{
+			disabled[i].Type = ovrLayerType_Disabled;
+			disabled[i].Flags = 0;
+			layers[i] = i == 5 ? nullptr : &disabled[i];
+		}
+
+		// The first frame may set up whatever the session needs lazily.
+		CHECK(OVR_SUCCESS(submitFrame(session, 0, nullptr, layers, LayerCount)));
+
+		g_AllocThread = GetCurrentThreadId();
+		g_Allocations = 0;
+		_CRT_ALLOC_HOOK previous = _CrtSetAllocHook(CountAllocations);
+
+		for (long long frame = 1; frame <= 100; frame++)
+			CHECK(OVR_SUCCESS(submitFrame(session, frame, nullptr, layers, LayerCount)));
+
+		_CrtSetAllocHook(previous);
+		CHECK(g_Allocations == 0);
+
+		destroy(session);
+	}
+
+	shutdown();
+	FreeLibrary(wrapper);
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include "MockOpenVR.h"
+
+#include <string.h>
+
+MockVRSystem g_MockVRSystem;
+MockVROverlay g_MockVROverlay;
+MockVRCompositor g_MockVRCompositor;
+
+// The entry points openvr.h expects from openvr_api, the interface getters in the header call them.
+
+VR_INTERFACE void* VR_CALLTYPE VR_GetGenericInterface(const char* pchInterfaceVersion, vr::EVRInitError* peError)
+{
+	void* result = nullptr;
+	if (strcmp(pchInterfaceVersion, vr::IVRSystem_Version) == 0)
+		result = static_cast<vr::IVRSystem*>(&g_MockVRSystem);
+	else if (strcmp(pchInterfaceVersion, vr::IVROverlay_Version) == 0)
+		result = static_cast<vr::IVROverlay*>(&g_MockVROverlay);
+	else if (strcmp(pchInterfaceVersion, vr::IVRCompositor_Version) == 0)
+		result = static_cast<vr::IVRCompositor*>(&g_MockVRCompositor);
+
+	if (peError)
+		*peError = result ? vr::VRInitError_None : vr::VRInitError_Init_InterfaceNotFound;
+	return result;
+}
+
+VR_INTERFACE bool VR_CALLTYPE VR_IsInterfaceVersionValid(const char* pchInterfaceVersion)
+{
+	return VR_GetGenericInterface(pchInterfaceVersion, nullptr) != nullptr;
+}
+
+// The interfaces never change, so neither does the token the getters cache them under.
+VR_INTERFACE uint32_t VR_CALLTYPE VR_GetInitToken()
+{
+	return 1;
+}
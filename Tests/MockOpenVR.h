@@ -0,0 +1,248 @@
+#pragma once
+
+#include <openvr.h>
+
+#include <deque>
+#include <set>
+
+// Stand-ins for the OpenVR interfaces Revive calls. VR_GetGenericInterface in MockOpenVR.cpp hands them out,
+// so vr::VRSystem(), vr::VROverlay() and vr::VRCompositor() work without SteamVR.
+// Every call is counted in Calls; the calls the tests look at keep some state, all others return zeroes.
+
+class MockVRSystem : public vr::IVRSystem
+{
+public:
+	unsigned int Calls;
+	std::deque<vr::VREvent_t> Events; // handed out by PollNextEvent, front first
+	unsigned int Polls;
+	unsigned int QuitAcknowledged;
+
+	MockVRSystem() { Reset(); }
+
+	void Reset()
+	{
+		Calls = 0;
+		Events.clear();
+		Polls = 0;
+		QuitAcknowledged = 0;
+	}
+
+	virtual bool PollNextEvent(vr::VREvent_t *pEvent, uint32_t uncbVREvent)
+	{
+		Calls++;
+		Polls++;
+		if (Events.empty() || uncbVREvent != sizeof(vr::VREvent_t))
+			return false;
+
+		*pEvent = Events.front();
+		Events.pop_front();
+		return true;
+	}
+
+	virtual void AcknowledgeQuit_Exiting() { Calls++; QuitAcknowledged++; }
+	virtual bool IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t unDeviceIndex) { Calls++; return unDeviceIndex == vr::k_unTrackedDeviceIndex_Hmd; }
+
+	virtual void GetRecommendedRenderTargetSize(uint32_t *pnWidth, uint32_t *pnHeight) { Calls++; }
+	virtual vr::HmdMatrix44_t GetProjectionMatrix(vr::EVREye eEye, float fNearZ, float fFarZ) { Calls++; return {}; }
+	virtual void GetProjectionRaw(vr::EVREye eEye, float *pfLeft, float *pfRight, float *pfTop, float *pfBottom) { Calls++; }
+	virtual bool ComputeDistortion(vr::EVREye eEye, float fU, float fV, vr::DistortionCoordinates_t *pDistortionCoordinates) { Calls++; return {}; }
+	virtual vr::HmdMatrix34_t GetEyeToHeadTransform(vr::EVREye eEye) { Calls++; return {}; }
+	virtual bool GetTimeSinceLastVsync(float *pfSecondsSinceLastVsync, uint64_t *pulFrameCounter) { Calls++; return {}; }
+	virtual int32_t GetD3D9AdapterIndex() { Calls++; return {}; }
+	virtual void GetDXGIOutputInfo(int32_t *pnAdapterIndex) { Calls++; }
+	virtual bool IsDisplayOnDesktop() { Calls++; return {}; }
+	virtual bool SetDisplayVisibility(bool bIsVisibleOnDesktop) { Calls++; return {}; }
+	virtual void GetDeviceToAbsoluteTrackingPose(vr::ETrackingUniverseOrigin eOrigin, float fPredictedSecondsToPhotonsFromNow, vr::TrackedDevicePose_t *pTrackedDevicePoseArray, uint32_t unTrackedDevicePoseArrayCount) { Calls++; }
+	virtual void ResetSeatedZeroPose() { Calls++; }
+	virtual vr::HmdMatrix34_t GetSeatedZeroPoseToStandingAbsoluteTrackingPose() { Calls++; return {}; }
+	virtual vr::HmdMatrix34_t GetRawZeroPoseToStandingAbsoluteTrackingPose() { Calls++; return {}; }
+	virtual uint32_t GetSortedTrackedDeviceIndicesOfClass(vr::ETrackedDeviceClass eTrackedDeviceClass, vr::TrackedDeviceIndex_t *punTrackedDeviceIndexArray, uint32_t unTrackedDeviceIndexArrayCount, vr::TrackedDeviceIndex_t unRelativeToTrackedDeviceIndex) { Calls++; return {}; }
+	virtual vr::EDeviceActivityLevel GetTrackedDeviceActivityLevel(vr::TrackedDeviceIndex_t unDeviceId) { Calls++; return {}; }
+	virtual void ApplyTransform(vr::TrackedDevicePose_t *pOutputPose, const vr::TrackedDevicePose_t *pTrackedDevicePose, const vr::HmdMatrix34_t *pTransform) { Calls++; }
+	virtual vr::TrackedDeviceIndex_t GetTrackedDeviceIndexForControllerRole(vr::ETrackedControllerRole unDeviceType) { Calls++; return {}; }
+	virtual vr::ETrackedControllerRole GetControllerRoleForTrackedDeviceIndex(vr::TrackedDeviceIndex_t unDeviceIndex) { Calls++; return {}; }
+	virtual vr::ETrackedDeviceClass GetTrackedDeviceClass(vr::TrackedDeviceIndex_t unDeviceIndex) { Calls++; return {}; }
+	virtual bool GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual float GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual int32_t GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual uint64_t GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual vr::HmdMatrix34_t GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual uint32_t GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, vr::ETrackedDeviceProperty prop, char *pchValue, uint32_t unBufferSize, vr::ETrackedPropertyError *pError) { Calls++; return {}; }
+	virtual const char * GetPropErrorNameFromEnum(vr::ETrackedPropertyError error) { Calls++; return {}; }
+	virtual bool PollNextEventWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::VREvent_t *pEvent, uint32_t uncbVREvent, vr::TrackedDevicePose_t *pTrackedDevicePose) { Calls++; return {}; }
+	virtual const char * GetEventTypeNameFromEnum(vr::EVREventType eType) { Calls++; return {}; }
+	virtual vr::HiddenAreaMesh_t GetHiddenAreaMesh(vr::EVREye eEye, vr::EHiddenAreaMeshType type) { Calls++; return {}; }
+	virtual bool GetControllerState(vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t *pControllerState, uint32_t unControllerStateSize) { Calls++; return {}; }
+	virtual bool GetControllerStateWithPose(vr::ETrackingUniverseOrigin eOrigin, vr::TrackedDeviceIndex_t unControllerDeviceIndex, vr::VRControllerState_t *pControllerState, uint32_t unControllerStateSize, vr::TrackedDevicePose_t *pTrackedDevicePose) { Calls++; return {}; }
+	virtual void TriggerHapticPulse(vr::TrackedDeviceIndex_t unControllerDeviceIndex, uint32_t unAxisId, unsigned short usDurationMicroSec) { Calls++; }
+	virtual const char * GetButtonIdNameFromEnum(vr::EVRButtonId eButtonId) { Calls++; return {}; }
+	virtual const char * GetControllerAxisTypeNameFromEnum(vr::EVRControllerAxisType eAxisType) { Calls++; return {}; }
+	virtual bool CaptureInputFocus() { Calls++; return {}; }
+	virtual void ReleaseInputFocus() { Calls++; }
+	virtual bool IsInputFocusCapturedByAnotherProcess() { Calls++; return {}; }
+	virtual uint32_t DriverDebugRequest(vr::TrackedDeviceIndex_t unDeviceIndex, const char *pchRequest, char *pchResponseBuffer, uint32_t unResponseBufferSize) { Calls++; return {}; }
+	virtual vr::EVRFirmwareError PerformFirmwareUpdate(vr::TrackedDeviceIndex_t unDeviceIndex) { Calls++; return {}; }
+	virtual void AcknowledgeQuit_UserPrompt() { Calls++; }
+};
+
+class MockVROverlay : public vr::IVROverlay
+{
+public:
+	unsigned int Calls;
+	unsigned int Created;
+	std::set<vr::VROverlayHandle_t> Visible;
+
+	MockVROverlay() { Reset(); }
+
+	void Reset()
+	{
+		Calls = 0;
+		Created = 0;
+		Visible.clear();
+	}
+
+	virtual vr::EVROverlayError CreateOverlay(const char *pchOverlayKey, const char *pchOverlayFriendlyName, vr::VROverlayHandle_t *pOverlayHandle)
+	{
+		Calls++;
+		*pOverlayHandle = ++Created;
+		return vr::VROverlayError_None;
+	}
+
+	virtual vr::EVROverlayError ShowOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; Visible.insert(ulOverlayHandle); return vr::VROverlayError_None; }
+	virtual vr::EVROverlayError HideOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; Visible.erase(ulOverlayHandle); return vr::VROverlayError_None; }
+
+	virtual vr::EVROverlayError FindOverlay(const char *pchOverlayKey, vr::VROverlayHandle_t *pOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError DestroyOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetHighQualityOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::VROverlayHandle_t GetHighQualityOverlay() { Calls++; return {}; }
+	virtual uint32_t GetOverlayKey(vr::VROverlayHandle_t ulOverlayHandle, char *pchValue, uint32_t unBufferSize, vr::EVROverlayError *pError) { Calls++; return {}; }
+	virtual uint32_t GetOverlayName(vr::VROverlayHandle_t ulOverlayHandle, char *pchValue, uint32_t unBufferSize, vr::EVROverlayError *pError) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayImageData(vr::VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unBufferSize, uint32_t *punWidth, uint32_t *punHeight) { Calls++; return {}; }
+	virtual const char * GetOverlayErrorNameFromEnum(vr::EVROverlayError error) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unPID) { Calls++; return {}; }
+	virtual uint32_t GetOverlayRenderingPid(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool bEnabled) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayFlags eOverlayFlag, bool *pbEnabled) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float fRed, float fGreen, float fBlue) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayColor(vr::VROverlayHandle_t ulOverlayHandle, float *pfRed, float *pfGreen, float *pfBlue) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float fAlpha) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayAlpha(vr::VROverlayHandle_t ulOverlayHandle, float *pfAlpha) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float fTexelAspect) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTexelAspect(vr::VROverlayHandle_t ulOverlayHandle, float *pfTexelAspect) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unSortOrder) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlaySortOrder(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *punSortOrder) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float fWidthInMeters) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayWidthInMeters(vr::VROverlayHandle_t ulOverlayHandle, float *pfWidthInMeters) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayAutoCurveDistanceRangeInMeters(vr::VROverlayHandle_t ulOverlayHandle, float fMinDistanceInMeters, float fMaxDistanceInMeters) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayAutoCurveDistanceRangeInMeters(vr::VROverlayHandle_t ulOverlayHandle, float *pfMinDistanceInMeters, float *pfMaxDistanceInMeters) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace eTextureColorSpace) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTextureColorSpace(vr::VROverlayHandle_t ulOverlayHandle, vr::EColorSpace *peTextureColorSpace) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, const vr::VRTextureBounds_t *pOverlayTextureBounds) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTextureBounds(vr::VROverlayHandle_t ulOverlayHandle, vr::VRTextureBounds_t *pOverlayTextureBounds) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTransformType(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayTransformType *peTransformType) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t *pmatTrackingOriginToOverlayTransform) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTransformAbsolute(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin *peTrackingOrigin, vr::HmdMatrix34_t *pmatTrackingOriginToOverlayTransform) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unTrackedDevice, const vr::HmdMatrix34_t *pmatTrackedDeviceToOverlayTransform) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t *punTrackedDevice, vr::HmdMatrix34_t *pmatTrackedDeviceToOverlayTransform) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unDeviceIndex, const char *pchComponentName) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTransformTrackedDeviceComponent(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t *punDeviceIndex, char *pchComponentName, uint32_t unComponentNameSize) { Calls++; return {}; }
+	virtual bool IsOverlayVisible(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetTransformForOverlayCoordinates(vr::VROverlayHandle_t ulOverlayHandle, vr::ETrackingUniverseOrigin eTrackingOrigin, vr::HmdVector2_t coordinatesInOverlay, vr::HmdMatrix34_t *pmatTransform) { Calls++; return {}; }
+	virtual bool PollNextOverlayEvent(vr::VROverlayHandle_t ulOverlayHandle, vr::VREvent_t *pEvent, uint32_t uncbVREvent) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod *peInputMethod) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayInputMethod(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayInputMethod eInputMethod) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdVector2_t *pvecMouseScale) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayMouseScale(vr::VROverlayHandle_t ulOverlayHandle, const vr::HmdVector2_t *pvecMouseScale) { Calls++; return {}; }
+	virtual bool ComputeOverlayIntersection(vr::VROverlayHandle_t ulOverlayHandle, const vr::VROverlayIntersectionParams_t *pParams, vr::VROverlayIntersectionResults_t *pResults) { Calls++; return {}; }
+	virtual bool HandleControllerOverlayInteractionAsMouse(vr::VROverlayHandle_t ulOverlayHandle, vr::TrackedDeviceIndex_t unControllerDeviceIndex) { Calls++; return {}; }
+	virtual bool IsHoverTargetOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::VROverlayHandle_t GetGamepadFocusOverlay() { Calls++; return {}; }
+	virtual vr::EVROverlayError SetGamepadFocusOverlay(vr::VROverlayHandle_t ulNewFocusOverlay) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayNeighbor(vr::EOverlayDirection eDirection, vr::VROverlayHandle_t ulFrom, vr::VROverlayHandle_t ulTo) { Calls++; return {}; }
+	virtual vr::EVROverlayError MoveGamepadFocusToNeighbor(vr::EOverlayDirection eDirection, vr::VROverlayHandle_t ulFrom) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, const vr::Texture_t *pTexture) { Calls++; return {}; }
+	virtual vr::EVROverlayError ClearOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayRaw(vr::VROverlayHandle_t ulOverlayHandle, void *pvBuffer, uint32_t unWidth, uint32_t unHeight, uint32_t unDepth) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetOverlayFromFile(vr::VROverlayHandle_t ulOverlayHandle, const char *pchFilePath) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTexture(vr::VROverlayHandle_t ulOverlayHandle, void **pNativeTextureHandle, void *pNativeTextureRef, uint32_t *pWidth, uint32_t *pHeight, uint32_t *pNativeFormat, vr::ETextureType *pAPIType, vr::EColorSpace *pColorSpace, vr::VRTextureBounds_t *pTextureBounds) { Calls++; return {}; }
+	virtual vr::EVROverlayError ReleaseNativeOverlayHandle(vr::VROverlayHandle_t ulOverlayHandle, void *pNativeTextureHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayTextureSize(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *pWidth, uint32_t *pHeight) { Calls++; return {}; }
+	virtual vr::EVROverlayError CreateDashboardOverlay(const char *pchOverlayKey, const char *pchOverlayFriendlyName, vr::VROverlayHandle_t *pMainHandle, vr::VROverlayHandle_t *pThumbnailHandle) { Calls++; return {}; }
+	virtual bool IsDashboardVisible() { Calls++; return {}; }
+	virtual bool IsActiveDashboardOverlay(vr::VROverlayHandle_t ulOverlayHandle) { Calls++; return {}; }
+	virtual vr::EVROverlayError SetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t unProcessId) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetDashboardOverlaySceneProcess(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *punProcessId) { Calls++; return {}; }
+	virtual void ShowDashboard(const char *pchOverlayToShow) { Calls++; }
+	virtual vr::TrackedDeviceIndex_t GetPrimaryDashboardDevice() { Calls++; return {}; }
+	virtual vr::EVROverlayError ShowKeyboard(vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, const char *pchDescription, uint32_t unCharMax, const char *pchExistingText, bool bUseMinimalMode, uint64_t uUserValue) { Calls++; return {}; }
+	virtual vr::EVROverlayError ShowKeyboardForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::EGamepadTextInputMode eInputMode, vr::EGamepadTextInputLineMode eLineInputMode, const char *pchDescription, uint32_t unCharMax, const char *pchExistingText, bool bUseMinimalMode, uint64_t uUserValue) { Calls++; return {}; }
+	virtual uint32_t GetKeyboardText(char *pchText, uint32_t cchText) { Calls++; return {}; }
+	virtual void HideKeyboard() { Calls++; }
+	virtual void SetKeyboardTransformAbsolute(vr::ETrackingUniverseOrigin eTrackingOrigin, const vr::HmdMatrix34_t *pmatTrackingOriginToKeyboardTransform) { Calls++; }
+	virtual void SetKeyboardPositionForOverlay(vr::VROverlayHandle_t ulOverlayHandle, vr::HmdRect2_t avoidRect) { Calls++; }
+	virtual vr::EVROverlayError SetOverlayIntersectionMask(vr::VROverlayHandle_t ulOverlayHandle, vr::VROverlayIntersectionMaskPrimitive_t *pMaskPrimitives, uint32_t unNumMaskPrimitives, uint32_t unPrimitiveSize) { Calls++; return {}; }
+	virtual vr::EVROverlayError GetOverlayFlags(vr::VROverlayHandle_t ulOverlayHandle, uint32_t *pFlags) { Calls++; return {}; }
+	virtual vr::VRMessageOverlayResponse ShowMessageOverlay(const char *pchText, const char *pchCaption, const char *pchButton0Text, const char *pchButton1Text, const char *pchButton2Text, const char *pchButton3Text) { Calls++; return {}; }
+};
+
+class MockVRCompositor : public vr::IVRCompositor
+{
+public:
+	unsigned int Calls;
+	vr::ETrackingUniverseOrigin TrackingSpace;
+
+	MockVRCompositor() { Reset(); }
+
+	void Reset()
+	{
+		Calls = 0;
+		TrackingSpace = vr::TrackingUniverseStanding;
+	}
+
+	virtual vr::ETrackingUniverseOrigin GetTrackingSpace() { Calls++; return TrackingSpace; }
+
+	virtual void SetTrackingSpace(vr::ETrackingUniverseOrigin eOrigin) { Calls++; }
+	virtual vr::EVRCompositorError WaitGetPoses(vr::TrackedDevicePose_t *pRenderPoseArray, uint32_t unRenderPoseArrayCount, vr::TrackedDevicePose_t *pGamePoseArray, uint32_t unGamePoseArrayCount) { Calls++; return {}; }
+	virtual vr::EVRCompositorError GetLastPoses(vr::TrackedDevicePose_t *pRenderPoseArray, uint32_t unRenderPoseArrayCount, vr::TrackedDevicePose_t *pGamePoseArray, uint32_t unGamePoseArrayCount) { Calls++; return {}; }
+	virtual vr::EVRCompositorError GetLastPoseForTrackedDeviceIndex(vr::TrackedDeviceIndex_t unDeviceIndex, vr::TrackedDevicePose_t *pOutputPose, vr::TrackedDevicePose_t *pOutputGamePose) { Calls++; return {}; }
+	virtual vr::EVRCompositorError Submit(vr::EVREye eEye, const vr::Texture_t *pTexture, const vr::VRTextureBounds_t *pBounds, vr::EVRSubmitFlags nSubmitFlags) { Calls++; return {}; }
+	virtual void ClearLastSubmittedFrame() { Calls++; }
+	virtual void PostPresentHandoff() { Calls++; }
+	virtual bool GetFrameTiming(vr::Compositor_FrameTiming *pTiming, uint32_t unFramesAgo) { Calls++; return {}; }
+	virtual uint32_t GetFrameTimings(vr::Compositor_FrameTiming *pTiming, uint32_t nFrames) { Calls++; return {}; }
+	virtual float GetFrameTimeRemaining() { Calls++; return {}; }
+	virtual void GetCumulativeStats(vr::Compositor_CumulativeStats *pStats, uint32_t nStatsSizeInBytes) { Calls++; }
+	virtual void FadeToColor(float fSeconds, float fRed, float fGreen, float fBlue, float fAlpha, bool bBackground) { Calls++; }
+	virtual vr::HmdColor_t GetCurrentFadeColor(bool bBackground) { Calls++; return {}; }
+	virtual void FadeGrid(float fSeconds, bool bFadeIn) { Calls++; }
+	virtual float GetCurrentGridAlpha() { Calls++; return {}; }
+	virtual vr::EVRCompositorError SetSkyboxOverride(const vr::Texture_t *pTextures, uint32_t unTextureCount) { Calls++; return {}; }
+	virtual void ClearSkyboxOverride() { Calls++; }
+	virtual void CompositorBringToFront() { Calls++; }
+	virtual void CompositorGoToBack() { Calls++; }
+	virtual void CompositorQuit() { Calls++; }
+	virtual bool IsFullscreen() { Calls++; return {}; }
+	virtual uint32_t GetCurrentSceneFocusProcess() { Calls++; return {}; }
+	virtual uint32_t GetLastFrameRenderer() { Calls++; return {}; }
+	virtual bool CanRenderScene() { Calls++; return {}; }
+	virtual void ShowMirrorWindow() { Calls++; }
+	virtual void HideMirrorWindow() { Calls++; }
+	virtual bool IsMirrorWindowVisible() { Calls++; return {}; }
+	virtual void CompositorDumpImages() { Calls++; }
+	virtual bool ShouldAppRenderWithLowResources() { Calls++; return {}; }
+	virtual void ForceInterleavedReprojectionOn(bool bOverride) { Calls++; }
+	virtual void ForceReconnectProcess() { Calls++; }
+	virtual void SuspendRendering(bool bSuspend) { Calls++; }
+	virtual vr::EVRCompositorError GetMirrorTextureD3D11(vr::EVREye eEye, void *pD3D11DeviceOrResource, void **ppD3D11ShaderResourceView) { Calls++; return {}; }
+	virtual void ReleaseMirrorTextureD3D11(void *pD3D11ShaderResourceView) { Calls++; }
+	virtual vr::EVRCompositorError GetMirrorTextureGL(vr::EVREye eEye, vr::glUInt_t *pglTextureId, vr::glSharedTextureHandle_t *pglSharedTextureHandle) { Calls++; return {}; }
+	virtual bool ReleaseSharedGLTexture(vr::glUInt_t glTextureId, vr::glSharedTextureHandle_t glSharedTextureHandle) { Calls++; return {}; }
+	virtual void LockGLSharedTextureForAccess(vr::glSharedTextureHandle_t glSharedTextureHandle) { Calls++; }
+	virtual void UnlockGLSharedTextureForAccess(vr::glSharedTextureHandle_t glSharedTextureHandle) { Calls++; }
+	virtual uint32_t GetVulkanInstanceExtensionsRequired(char *pchValue, uint32_t unBufferSize) { Calls++; return {}; }
+	virtual uint32_t GetVulkanDeviceExtensionsRequired(VkPhysicalDevice_T *pPhysicalDevice, char *pchValue, uint32_t unBufferSize) { Calls++; return {}; }
+};
+
+extern MockVRSystem g_MockVRSystem;
+extern MockVROverlay g_MockVROverlay;
+extern MockVRCompositor g_MockVRCompositor;
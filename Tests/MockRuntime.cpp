@@ -0,0 +1,34 @@
+#include "MockRuntime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void SetMockEnvironment(int swapChainLength)
+{
+	char length[16];
+	snprintf(length, sizeof(length), "%d", swapChainLength);
+	_putenv_s("REVMOCK_SWAPCHAIN_LENGTH", length);
+	_putenv_s("REVMOCK_CLOCK", "virtual");
+	_putenv_s("REVMOCK_SUBMIT", "none");
+	_putenv_s("REVMOCK_STATS", "NUL");
+}
+
+MockRuntime::MockRuntime(int swapChainLength)
+	: Session(nullptr)
+{
+	SetMockEnvironment(swapChainLength);
+
+	if (REV_SUCCESS(rev_Initialize(nullptr)))
+	{
+		revGraphicsLuid luid;
+		if (!REV_SUCCESS(rev_Create(&Session, &luid)))
+			Session = nullptr;
+	}
+}
+
+MockRuntime::~MockRuntime()
+{
+	if (Session)
+		rev_Destroy(Session);
+	rev_Shutdown();
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "REV_CAPI.h"
+
+// Settings the mock reads in ovr_Initialize: a virtual clock, a submit that returns at once and chains of the given length.
+void SetMockEnvironment(int swapChainLength);
+
+// LibREV started on the mock runtime (LibREVMock, built next to the runner) for the length of a test.
+// With the settings above tests are deterministic and fast.
+struct MockRuntime
+{
+	revSession Session;
+
+	explicit MockRuntime(int swapChainLength = 3);
+	~MockRuntime();
+};
@@ -0,0 +1,224 @@
+#include "Test.h"
+#include "MockOpenVR.h"
+#include "CompositorBase.h"
+
+// Quad layers are submitted through CompositorBase on top of the mock IVROverlay, which counts the calls that
+// reach it. Every call the compositor reports as issued must have reached the overlay interface (or the tracking
+// space query of the compositor), and a frame that repeats the last one only sends the new texture.
+
+// A compositor without a graphics API, scene layers are never submitted here.
+class TestCompositor : public CompositorBase
+{
+public:
+	virtual vr::ETextureType GetAPI() { return vr::TextureType_DirectX; }
+	virtual void Flush() { }
+
+	virtual ovrResult CreateTextureSwapChain(const ovrTextureSwapChainDesc*, ovrTextureSwapChain*) { return ovrError_Unsupported; }
+	virtual void RenderTextureSwapChain(vr::EVREye, ovrTextureSwapChain, ovrTextureSwapChain, ovrRecti, vr::VRTextureBounds_t, vr::HmdVector4_t) { }
+
+	virtual ovrResult CreateMirrorTexture(const ovrMirrorTextureDesc*, ovrMirrorTexture*) { return ovrError_Unsupported; }
+	virtual void RenderMirrorTexture(ovrMirrorTexture, ovrTextureSwapChain[ovrEye_Count]) { }
+};
+
+class TestTexture : public TextureBase
+{
+public:
+	virtual vr::Texture_t ToVRTexture()
+	{
+		vr::Texture_t texture = { this, vr::TextureType_DirectX, vr::ColorSpace_Auto };
+		return texture;
+	}
+
+	virtual bool Create(int, int, int, int, ovrTextureFormat, unsigned int, unsigned int) { return true; }
+};
+
+// A swapchain with a single submitted texture, all the overlay code looks at.
+struct TestChain
+{
+	TestTexture Texture;
+	ovrTextureSwapChainData Data;
+
+	TestChain()
+		: Texture()
+		, Data(vr::TextureType_DirectX, Desc())
+	{
+		Data.Submitted = &Texture;
+	}
+
+	static ovrTextureSwapChainDesc Desc()
+	{
+		ovrTextureSwapChainDesc desc = {};
+		desc.Type = ovrTexture_2D;
+		desc.Format = OVR_FORMAT_R8G8B8A8_UNORM_SRGB;
+		desc.ArraySize = 1;
+		desc.Width = 256;
+		desc.Height = 128;
+		desc.MipLevels = 1;
+		desc.SampleCount = 1;
+		return desc;
+	}
+};
+
+static ovrLayerQuad MakeQuad(TestChain& chain, bool headLocked, float z)
+{
+	ovrLayerQuad layer = {};
+	layer.Header.Type = ovrLayerType_Quad;
+	layer.Header.Flags = headLocked ? ovrLayerFlag_HeadLocked : 0;
+	layer.ColorTexture = &chain.Data;
+	layer.Viewport.Size.w = 256;
+	layer.Viewport.Size.h = 128;
+	layer.QuadPoseCenter.Orientation.w = 1.0f;
+	layer.QuadPoseCenter.Position.z = z;
+	layer.QuadSize.x = 1.0f;
+	layer.QuadSize.y = 0.5f;
+	return layer;
+}
+
+// Submits a frame and checks the issued calls against the calls the mock received.
+static CompositorBase::OverlayStats SubmitFrame(CompositorBase& compositor, const ovrLayerHeader* const* layers, unsigned int layerCount)
+{
+	unsigned int overlayCalls = g_MockVROverlay.Calls;
+	unsigned int created = g_MockVROverlay.Created;
+	unsigned int compositorCalls = g_MockVRCompositor.Calls;
+
+	compositor.SubmitFrame(nullptr, nullptr, layers, layerCount);
+
+	// Creating an overlay is not a parameter update, so it is not counted by the compositor.
+	unsigned int received = (g_MockVROverlay.Calls - overlayCalls) - (g_MockVROverlay.Created - created) +
+		(g_MockVRCompositor.Calls - compositorCalls);
+
+	CompositorBase::OverlayStats stats = compositor.GetOverlayStats();
+	CHECK(stats.Issued == received);
+	return stats;
+}
+
+static void ResetMocks()
+{
+	g_MockVROverlay.Reset();
+	g_MockVRCompositor.Reset();
+}
+
+TEST(OverlayRepeatedFrameOnlySendsTexture)
+{
+	ResetMocks();
+	TestCompositor compositor;
+	TestChain chain;
+	ovrLayerQuad quad = MakeQuad(chain, true, -1.0f);
+	const ovrLayerHeader* layers[] = { &quad.Header };
+
+	// Sort order, width, transform, bounds, texture and show.
+	CompositorBase::OverlayStats stats = SubmitFrame(compositor, layers, 1);
+	CHECK(stats.Issued == 6);
+	CHECK(stats.Suppressed == 0);
+	CHECK(g_MockVROverlay.Created == 1);
+	CHECK(g_MockVROverlay.Visible.size() == 1);
+
+	for (int frame = 0; frame < 3; frame++)
+	{
+		stats = SubmitFrame(compositor, layers, 1);
+		CHECK(stats.Issued == 1);
+		CHECK(stats.Suppressed == 5);
+	}
+	CHECK(g_MockVROverlay.Created == 1);
+}
+
+TEST(OverlayChangedParametersAreSent)
+{
+	ResetMocks();
+	TestCompositor compositor;
+	TestChain chain;
+	ovrLayerQuad quad = MakeQuad(chain, true, -1.0f);
+	const ovrLayerHeader* layers[] = { &quad.Header };
+	SubmitFrame(compositor, layers, 1);
+
+	// Only the transform and the texture.
+	quad.QuadPoseCenter.Position.z = -2.0f;
+	CompositorBase::OverlayStats stats = SubmitFrame(compositor, layers, 1);
+	CHECK(stats.Issued == 2);
+	CHECK(stats.Suppressed == 4);
+
+	// The width, and the bounds with the viewport.
+	quad.QuadSize.x = 2.0f;
+	quad.Viewport.Size.w = 128;
+	stats = SubmitFrame(compositor, layers, 1);
+	CHECK(stats.Issued == 3);
+	CHECK(stats.Suppressed == 3);
+}
+
+TEST(OverlayTrackingSpaceQueriedOncePerFrame)
+{
+	ResetMocks();
+	TestCompositor compositor;
+	TestChain chains[2];
+	ovrLayerQuad quads[2] = { MakeQuad(chains[0], false, -1.0f), MakeQuad(chains[1], false, -2.0f) };
+	const ovrLayerHeader* layers[] = { &quads[0].Header, &quads[1].Header };
+
+	// Six calls per overlay and one tracking space query for both.
+	CompositorBase::OverlayStats stats = SubmitFrame(compositor, layers, 2);
+	CHECK(stats.Issued == 13);
+	CHECK(g_MockVRCompositor.Calls == 1);
+	CHECK(g_MockVROverlay.Created == 2);
+
+	stats = SubmitFrame(compositor, layers, 2);
+	CHECK(stats.Issued == 3);
+	CHECK(stats.Suppressed == 10);
+
+	// World-locked transforms are resent when the tracking space changes.
+	g_MockVRCompositor.TrackingSpace = vr::TrackingUniverseSeated;
+	stats = SubmitFrame(compositor, layers, 2);
+	CHECK(stats.Issued == 5);
+	CHECK(stats.Suppressed == 8);
+}
+
+TEST(OverlayRemovedLayerIsHiddenAndReused)
+{
+	ResetMocks();
+	TestCompositor compositor;
+	TestChain chain;
+	ovrLayerQuad quad = MakeQuad(chain, true, -1.0f);
+	const ovrLayerHeader* layers[] = { &quad.Header };
+	SubmitFrame(compositor, layers, 1);
+
+	CompositorBase::OverlayStats stats = SubmitFrame(compositor, nullptr, 0);
+	CHECK(stats.Issued == 1);
+	CHECK(g_MockVROverlay.Visible.empty());
+
+	// Back on the same overlay, with the parameters it still has.
+	stats = SubmitFrame(compositor, layers, 1);
+	CHECK(stats.Issued == 2);
+	CHECK(stats.Suppressed == 4);
+	CHECK(g_MockVROverlay.Created == 1);
+	CHECK(g_MockVROverlay.Visible.size() == 1);
+}
+
+TEST(OverlayNewChainTakesHiddenSlot)
+{
+	ResetMocks();
+	TestCompositor compositor;
+
+	// Two frames of different swapchains fill the whole table, the first half is hidden by the second frame.
+	static TestChain chains[REV_OVERLAY_COUNT + 1];
+	ovrLayerQuad quads[REV_OVERLAY_COUNT + 1];
+	for (int i = 0; i <= REV_OVERLAY_COUNT; i++)
+		quads[i] = MakeQuad(chains[i], true, -1.0f);
+
+	const ovrLayerHeader* layers[ovrMaxLayerCount];
+	for (int frame = 0; frame < 2; frame++)
+	{
+		for (int i = 0; i < ovrMaxLayerCount; i++)
+			layers[i] = &quads[frame * ovrMaxLayerCount + i].Header;
+		SubmitFrame(compositor, layers, ovrMaxLayerCount);
+	}
+	CHECK(g_MockVROverlay.Created == REV_OVERLAY_COUNT);
+
+	// A new swapchain in front of the visible ones takes the overlay hidden the longest, it had the same
+	// parameters and sort order, so only the texture and show are sent. The visible swapchains keep their
+	// overlays and only move one place down, the one that was left out is hidden.
+	layers[0] = &quads[REV_OVERLAY_COUNT].Header;
+	for (int i = 1; i < ovrMaxLayerCount; i++)
+		layers[i] = &quads[ovrMaxLayerCount + i - 1].Header;
+	CompositorBase::OverlayStats stats = SubmitFrame(compositor, layers, ovrMaxLayerCount);
+	CHECK(stats.Issued == 2 + (ovrMaxLayerCount - 1) * 2 + 1);
+	CHECK(g_MockVROverlay.Created == REV_OVERLAY_COUNT);
+	CHECK(g_MockVROverlay.Visible.size() == ovrMaxLayerCount);
+}
@@ -0,0 +1,106 @@
+#include "Test.h"
+#include "../LibOVRWrapperShared/SwapChainCommit.h"
+
+// A ring of buffers without any graphics behind it, counting what the commit asked for.
+struct FakeSwapChainDevice : SwapChainDevice
+{
+	int Length;
+	int Index;
+	int Copies;
+	int Commits;
+	int LastCopyBuffer;
+	int LastCopyTexture;
+
+	explicit FakeSwapChainDevice(int length)
+		: Length(length), Index(0), Copies(0), Commits(0), LastCopyBuffer(-1), LastCopyTexture(-1) {}
+
+	virtual int currentIndex() { return Index; }
+
+	virtual void copy(int bufferIndex, int textureIndex)
+	{
+		Copies++;
+		LastCopyBuffer = bufferIndex;
+		LastCopyTexture = textureIndex;
+	}
+
+	virtual void commit()
+	{
+		Commits++;
+		Index = (Index + 1) % Length;
+	}
+};
+
+TEST(SwapChainCommitCopiesEverySubmit)
+{
+	FakeSwapChainDevice device(3);
+	SwapChainCommit commit;
+	swapChainCommitInit(&commit, 3, false);
+
+	// A copied set has two private textures, the application keeps rendering into one of them.
+	int currentIndex = 0;
+	for (unsigned int submit = 1; submit <= 4; submit++)
+	{
+		CHECK(swapChainCommit(&commit, &device, &currentIndex, submit, false) == swapChainCommitCopied);
+		CHECK(device.LastCopyTexture == 0);
+	}
+
+	CHECK(device.Copies == 4);
+	CHECK(device.Commits == 4);
+	CHECK(currentIndex == 0);
+}
+
+TEST(SwapChainCommitOncePerSubmit)
+{
+	// Two layers show the same aliased set in every call and the frame index is always 0,
+	// the set is still committed once per call.
+	FakeSwapChainDevice device(3);
+	SwapChainCommit commit;
+	swapChainCommitInit(&commit, 3, true);
+
+	int currentIndex = swapChainAliasedIndex(&commit, &device);
+	CHECK(currentIndex == 2);
+
+	for (unsigned int submit = 1; submit <= 6; submit++)
+	{
+		currentIndex = (currentIndex + 1) % 3;
+		CHECK(currentIndex == device.Index);
+
+		CHECK(swapChainCommit(&commit, &device, &currentIndex, submit, false) == swapChainCommitInPlace);
+		CHECK(swapChainCommit(&commit, &device, &currentIndex, submit, false) == swapChainCommitSkipped);
+		CHECK(device.Commits == (int)submit);
+	}
+
+	CHECK(device.Copies == 0);
+}
+
+TEST(SwapChainCommitAliasedCopiesOtherBuffer)
+{
+	FakeSwapChainDevice device(3);
+	SwapChainCommit commit;
+	swapChainCommitInit(&commit, 3, true);
+
+	// The application rendered into a buffer other than the one the chain commits next.
+	int currentIndex = 2;
+	CHECK(swapChainCommit(&commit, &device, &currentIndex, 1, false) == swapChainCommitCopied);
+	CHECK(device.LastCopyBuffer == 0);
+	CHECK(device.LastCopyTexture == 2);
+	CHECK(currentIndex == 0);
+}
+
+TEST(SwapChainCommitSkipsUnchangedSets)
+{
+	FakeSwapChainDevice device(3);
+	SwapChainCommit commit;
+	swapChainCommitInit(&commit, 3, false);
+
+	int currentIndex = 1;
+	CHECK(swapChainCommit(&commit, &device, &currentIndex, 1, true) == swapChainCommitCopied);
+
+	// The next call shows the same buffer, only trusted when unchanged sets may be skipped.
+	CHECK(swapChainCommit(&commit, &device, &currentIndex, 2, true) == swapChainCommitSkipped);
+	CHECK(swapChainCommit(&commit, &device, &currentIndex, 3, false) == swapChainCommitCopied);
+
+	currentIndex = 0;
+	CHECK(swapChainCommit(&commit, &device, &currentIndex, 4, true) == swapChainCommitCopied);
+	CHECK(device.Commits == 3);
+}
@@ -0,0 +1,74 @@
+#include "Test.h"
+#include "MockRuntime.h"
+#include "../LibOVRWrapperShared/SwapChainMirror.h"
+
+#include "REV_CAPI_GL.h"
+
+// Commits a chain of the given length several times around its ring and compares the mirrored
+// index with the one the runtime reports after every step.
+static void CheckWraparound(int length)
+{
+	MockRuntime mock(length);
+	REQUIRE(mock.Session);
+
+	revTextureSwapChainDesc desc = {};
+	desc.Type = revTexture_2D;
+	desc.Format = REV_FORMAT_R8G8B8A8_UNORM_SRGB;
+	desc.ArraySize = 1;
+	desc.Width = 64;
+	desc.Height = 64;
+	desc.MipLevels = 1;
+	desc.SampleCount = 1;
+
+	revTextureSwapChain chain = nullptr;
+	REQUIRE(REV_SUCCESS(rev_CreateTextureSwapChainGL(mock.Session, &desc, &chain)));
+
+	SwapChainMirror mirror;
+	REQUIRE(REV_SUCCESS(swapChainMirrorInit(&mirror, mock.Session, chain)));
+	CHECK(mirror.length == length);
+
+	// The submit hands the committed buffer to the compositor, so the chain can be committed again.
+	revLayerQuad layer = {};
+	layer.Header.Type = revLayerType_Quad;
+	layer.Header.Flags = revLayerFlag_HeadLocked;
+	layer.ColorTexture = chain;
+	layer.Viewport.Size.w = desc.Width;
+	layer.Viewport.Size.h = desc.Height;
+	layer.QuadPoseCenter.Orientation.w = 1.0f;
+	layer.QuadPoseCenter.Position.z = -1.0f;
+	layer.QuadSize.x = 1.0f;
+	layer.QuadSize.y = 1.0f;
+	const revLayerHeader* layers = &layer.Header;
+
+	for (int frame = 0; frame < length * 4; frame++)
+	{
+		int runtimeIndex = -1;
+		REQUIRE(REV_SUCCESS(rev_GetTextureSwapChainCurrentIndex(mock.Session, chain, &runtimeIndex)));
+		CHECK(swapChainMirrorCurrentIndex(&mirror, mock.Session, chain) == runtimeIndex);
+		CHECK(runtimeIndex == frame % length);
+
+		REQUIRE(REV_SUCCESS(swapChainMirrorCommit(&mirror, mock.Session, chain)));
+		REQUIRE(REV_SUCCESS(rev_SubmitFrame(mock.Session, frame, nullptr, &layers, 1)));
+	}
+
+	// Without a submit the runtime refuses a commit once all but one buffer are queued, the mirror must not advance either.
+	for (int i = 0; i < length - 1; i++)
+		REQUIRE(REV_SUCCESS(swapChainMirrorCommit(&mirror, mock.Session, chain)));
+	CHECK(swapChainMirrorCommit(&mirror, mock.Session, chain) == revError_TextureSwapChainFull);
+
+	int runtimeIndex = -1;
+	REQUIRE(REV_SUCCESS(rev_GetTextureSwapChainCurrentIndex(mock.Session, chain, &runtimeIndex)));
+	CHECK(mirror.currentIndex == runtimeIndex);
+
+	rev_DestroyTextureSwapChain(mock.Session, chain);
+}
+
+TEST(SwapChainMirrorWrapsTwoBuffers)
+{
+	CheckWraparound(2);
+}
+
+TEST(SwapChainMirrorWrapsThreeBuffers)
+{
+	CheckWraparound(3);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+
+// Minimal test registry. TEST(Name) defines a test that main() runs, a failed CHECK is reported
+// and marks the test as failed, but the test keeps running so every broken expectation shows up.
+
+typedef void(*TestFunction)();
+
+struct TestCase
+{
+	const char* Name;
+	TestFunction Function;
+	TestCase* Next;
+
+	TestCase(const char* name, TestFunction function);
+};
+
+// Head of the list of registered tests, in reverse order of registration.
+extern TestCase* g_Tests;
+
+// Failed checks of the test that is running.
+extern unsigned int g_TestFailures;
+
+#define TEST(name) \
+	static void Test_##name(); \
+	static TestCase TestCase_##name(#name, Test_##name); \
+	static void Test_##name()
+
+#define CHECK(expr) \
+	do { \
+		if (!(expr)) \
+		{ \
+			printf("  %s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			g_TestFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	do { \
+		double checkA = (double)(a), checkB = (double)(b); \
+		if (!(fabs(checkA - checkB) <= (tolerance))) \
+		{ \
+			printf("  %s(%d): CHECK_NEAR(%s, %s) failed, %g != %g\n", __FILE__, __LINE__, #a, #b, checkA, checkB); \
+			g_TestFailures++; \
+		} \
+	} while (0)
+
+// Stops the test, for preconditions the remaining checks depend on.
+#define REQUIRE(expr) \
+	do { \
+		if (!(expr)) \
+		{ \
+			printf("  %s(%d): REQUIRE(%s) failed\n", __FILE__, __LINE__, #expr); \
+			g_TestFailures++; \
+			return; \
+		} \
+	} while (0)
@@ -0,0 +1,83 @@
+#include "Test.h"
+#include "../LibOVRWrapper0.5/Timewarp.h"
+#include "../LibOVR0.5/Include/Extras/OVR_Math.h"
+
+// The matrices are compared with the SDK's own math. Tracking space is X right, Y up, Z back,
+// the distortion mesh works in X right, Y up, Z forward, so the expected rotation is flipped in Z.
+static OVR::Matrix4f ExpectedTimewarp(const OVR::Quatf& render, const OVR::Quatf& predicted)
+{
+	OVR::Matrix4f flipZ = OVR::Matrix4f::Scaling(1.0f, 1.0f, -1.0f);
+	return flipZ * OVR::Matrix4f(render.Inverted() * predicted) * flipZ;
+}
+
+static void CheckMatrix(const ovrMatrix4f& m, const OVR::Matrix4f& expected)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		for (int j = 0; j < 4; j++)
+			CHECK_NEAR(m.M[i][j], expected.M[i][j], 1e-5);
+	}
+}
+
+TEST(TimewarpMatrixMatchesSdk)
+{
+	// A head that pitched and rolled since rendering.
+	OVR::Quatf render(OVR::Vector3f(0.0f, 1.0f, 0.0f), 0.3f);
+	OVR::Quatf predicted = render * OVR::Quatf(OVR::Vector3f(1.0f, 0.0f, 0.0f), 0.1f) * OVR::Quatf(OVR::Vector3f(0.0f, 0.0f, 1.0f), -0.05f);
+
+	ovrQuatf renderOrientation = render;
+	ovrQuatf predictedOrientation = predicted;
+	ovrMatrix4f m;
+	calcTimewarpMatrix(&renderOrientation, &predictedOrientation, &m);
+
+	CheckMatrix(m, ExpectedTimewarp(render, predicted));
+}
+
+TEST(TimewarpMatrixWithoutMotionIsIdentity)
+{
+	ovrQuatf orientation = OVR::Quatf(OVR::Vector3f(0.3f, 0.8f, 0.1f).Normalized(), 1.2f);
+	ovrMatrix4f m;
+	calcTimewarpMatrix(&orientation, &orientation, &m);
+
+	CheckMatrix(m, OVR::Matrix4f::Identity());
+}
+
+TEST(TimewarpMatricesBothEyes)
+{
+	// Each eye spans its own half of the scanout: the left eye from predicted[0] to predicted[1],
+	// the right eye from predicted[1] to predicted[2].
+	OVR::Quatf render[2] = {
+		OVR::Quatf(OVR::Vector3f(0.0f, 1.0f, 0.0f), 0.2f),
+		OVR::Quatf(OVR::Vector3f(0.0f, 1.0f, 0.0f), 0.21f)
+	};
+	OVR::Quatf predicted[3];
+	for (int i = 0; i < 3; i++)
+		predicted[i] = render[0] * OVR::Quatf(OVR::Vector3f(0.0f, 1.0f, 0.0f), 0.01f * (i + 1));
+
+	ovrQuatf renderOrientation[2] = { render[0], render[1] };
+	ovrQuatf predictedOrientation[3] = { predicted[0], predicted[1], predicted[2] };
+	ovrMatrix4f twm[2][2];
+	calcTimewarpMatricesBothEyes(renderOrientation, predictedOrientation, twm);
+
+	for (int eye = 0; eye < 2; eye++)
+	{
+		CheckMatrix(twm[eye][0], ExpectedTimewarp(render[eye], predicted[eye]));
+		CheckMatrix(twm[eye][1], ExpectedTimewarp(render[eye], predicted[eye + 1]));
+	}
+}
+
+TEST(QuatRotateMatchesSdk)
+{
+	// The eye offset of ovrHmd_EndFrameTiming, moved by a turned and tilted head.
+	OVR::Quatf head = OVR::Quatf(OVR::Vector3f(0.0f, 1.0f, 0.0f), 0.7f) * OVR::Quatf(OVR::Vector3f(1.0f, 0.0f, 0.0f), -0.2f);
+	OVR::Vector3f offset(-0.032f, 0.0f, 0.01f);
+
+	ovrQuatf orientation = head;
+	ovrVector3f v = offset;
+	ovrVector3f r = quatRotate(&orientation, &v);
+
+	OVR::Vector3f expected = head.Rotate(offset);
+	CHECK_NEAR(r.x, expected.x, 1e-6);
+	CHECK_NEAR(r.y, expected.y, 1e-6);
+	CHECK_NEAR(r.z, expected.z, 1e-6);
+}
@@ -0,0 +1,50 @@
+#include "Test.h"
+
+#include <string.h>
+
+TestCase* g_Tests = nullptr;
+unsigned int g_TestFailures = 0;
+
+TestCase::TestCase(const char* name, TestFunction function)
+	: Name(name)
+	, Function(function)
+	, Next(g_Tests)
+{
+	g_Tests = this;
+}
+
+// Runs every test, or only those whose name contains the first argument.
+// Returns the number of failed tests, so a build step or CI can check the exit code.
+int main(int argc, char* argv[])
+{
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	// The list is in reverse order of registration, run the tests in the order they were defined.
+	TestCase* reversed = nullptr;
+	while (g_Tests)
+	{
+		TestCase* test = g_Tests;
+		g_Tests = test->Next;
+		test->Next = reversed;
+		reversed = test;
+	}
+
+	int run = 0;
+	int failed = 0;
+	for (TestCase* test = reversed; test; test = test->Next)
+	{
+		if (filter && !strstr(test->Name, filter))
+			continue;
+
+		g_TestFailures = 0;
+		test->Function();
+		run++;
+
+		if (g_TestFailures > 0)
+			failed++;
+		printf("[%s] %s\n", g_TestFailures > 0 ? "FAIL" : " OK ", test->Name);
+	}
+
+	printf("%d of %d tests passed\n", run - failed, run);
+	return failed;
+}